@@ -0,0 +1,91 @@
+#include "allocations.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<std::uint64_t> allocations(0);
+
+void count_allocation()
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace
+
+#ifdef __GLIBC__
+
+// glibc exports its allocator under these names too, so the ones below can
+// wrap it. operator new and Rust's global allocator both end up here.
+extern "C" {
+	void* __libc_malloc(std::size_t size);
+	void* __libc_calloc(std::size_t count, std::size_t size);
+	void* __libc_realloc(void* ptr, std::size_t size);
+
+	void* malloc(std::size_t size)
+	{
+		count_allocation();
+		return __libc_malloc(size);
+	}
+
+	void* calloc(std::size_t count, std::size_t size)
+	{
+		count_allocation();
+		return __libc_calloc(count, size);
+	}
+
+	void* realloc(void* ptr, std::size_t size)
+	{
+		count_allocation();
+		return __libc_realloc(ptr, size);
+	}
+}
+
+#else
+
+void* operator new(std::size_t size)
+{
+	count_allocation();
+	if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+#endif
+
+namespace Bench {
+
+std::uint64_t allocation_count()
+{
+	return allocations.load(std::memory_order_relaxed);
+}
+
+AllocationCounter::AllocationCounter()
+	: start(allocation_count())
+{
+}
+
+std::uint64_t AllocationCounter::count() const
+{
+	return allocation_count() - start;
+}
+
+} // namespace Bench
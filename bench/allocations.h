@@ -0,0 +1,29 @@
+#ifndef NEWSBOAT_BENCH_ALLOCATIONS_H_
+#define NEWSBOAT_BENCH_ALLOCATIONS_H_
+
+#include <cstdint>
+
+namespace Bench {
+
+/// \brief Returns how many heap allocations the process has made so far.
+///
+/// With glibc, this counts calls to malloc(), calloc() and realloc(), so it
+/// includes allocations made by the Rust code. Elsewhere, only C++
+/// allocations (operator new) are counted.
+std::uint64_t allocation_count();
+
+/// \brief Counts the heap allocations made during its lifetime.
+class AllocationCounter {
+public:
+	AllocationCounter();
+
+	/// \brief Returns how many allocations were made since construction.
+	std::uint64_t count() const;
+
+private:
+	const std::uint64_t start;
+};
+
+} // namespace Bench
+
+#endif /* NEWSBOAT_BENCH_ALLOCATIONS_H_ */
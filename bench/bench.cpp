@@ -0,0 +1,24 @@
+#define CATCH_CONFIG_RUNNER
+#include "3rd-party/catch.hpp"
+
+#include <clocale>
+
+#include "rss/parser.h"
+#include "utils.h"
+
+int main(int argc, char* argv[])
+{
+	newsboat::utils::initialize_ssl_implementation();
+
+	setlocale(LC_CTYPE, "");
+
+	// Some benchmarks download feeds from several threads at once, which
+	// needs libcurl to be initialized beforehand.
+	rsspp::Parser::global_init();
+
+	const int result = Catch::Session().run(argc, argv);
+
+	rsspp::Parser::global_cleanup();
+
+	return result;
+}
@@ -0,0 +1,40 @@
+#include "cache.h"
+
+#include "3rd-party/catch.hpp"
+#include "configcontainer.h"
+#include "corpus.h"
+#include "rssfeed.h"
+
+using namespace newsboat;
+
+TEST_CASE("Cache::externalize_rssfeed() and Cache::internalize_rssfeed()",
+	"[Cache]")
+{
+	const auto corpus = Bench::generate_corpus(1, 500);
+	const auto& data = corpus.front();
+
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	const auto feed = data.to_rssfeed(&rsscache);
+
+	BENCHMARK_ADVANCED("externalize_rssfeed(), 500 new items")(
+		Catch::Benchmark::Chronometer meter) {
+		std::vector<std::unique_ptr<Cache>> caches;
+		for (int i = 0; i < meter.runs(); ++i) {
+			caches.emplace_back(new Cache(":memory:", &cfg));
+		}
+		meter.measure([&](int i) {
+			caches[i]->externalize_rssfeed(feed, false);
+		});
+	};
+
+	rsscache.externalize_rssfeed(feed, false);
+
+	BENCHMARK("externalize_rssfeed(), 500 items already in the cache") {
+		rsscache.externalize_rssfeed(feed, false);
+	};
+
+	BENCHMARK("internalize_rssfeed(), 500 items") {
+		return rsscache.internalize_rssfeed(data.url, nullptr);
+	};
+}
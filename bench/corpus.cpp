@@ -0,0 +1,366 @@
+#include "corpus.h"
+
+#include "rssfeed.h"
+#include "rssitem.h"
+
+namespace Bench {
+
+namespace {
+
+const std::vector<std::string> WORDS = {
+	"the", "of", "and", "to", "in", "is", "for", "on", "with", "that",
+	"release", "kernel", "update", "security", "performance", "new",
+	"open", "source", "project", "developers", "community", "version",
+	"support", "feature", "bug", "fix", "patch", "review", "design",
+	"network", "storage", "memory", "latency", "throughput", "cache",
+	"database", "compiler", "language", "library", "framework", "tool",
+	"terminal", "feed", "reader", "article", "news", "weekly", "report",
+	"interview", "analysis", "benchmark", "results", "announces",
+	"introduces", "improves", "removes", "deprecates", "explains",
+	"Linux", "FreeBSD", "Rust", "C++", "Python", "SQLite", "HTTP/2",
+	"café", "naïve", "Überblick", "größer", "résumé", "日本語", "Ελληνικά",
+	"2020", "3.14", "42", "v1.0", "#1", "A&B", "<tag>"
+};
+
+const std::vector<std::string> AUTHORS = {
+	"Alice Example", "Bob Example", "Carol", "Dmitri Ivanov",
+	"Eve <eve@example.com>", "Zoë Zeta", "editors", ""
+};
+
+std::string words(Random& rng, unsigned int count)
+{
+	std::string result;
+	for (unsigned int i = 0; i < count; ++i) {
+		if (i > 0) {
+			result.push_back(' ');
+		}
+		result.append(WORDS[rng.between(0, WORDS.size() - 1)]);
+	}
+	return result;
+}
+
+/// Sum of two uniform variables: most values are close to the middle, with
+/// a few short and long ones.
+unsigned int triangular(Random& rng, unsigned int min, unsigned int max)
+{
+	const unsigned int half = (max - min) / 2;
+	return min + rng.between(0, half) + rng.between(0, max - min - half);
+}
+
+std::string xml_escape(const std::string& s)
+{
+	std::string result;
+	result.reserve(s.size());
+	for (const char c : s) {
+		switch (c) {
+		case '<':
+			result.append("&lt;");
+			break;
+		case '>':
+			result.append("&gt;");
+			break;
+		case '&':
+			result.append("&amp;");
+			break;
+		case '"':
+			result.append("&quot;");
+			break;
+		default:
+			result.push_back(c);
+		}
+	}
+	return result;
+}
+
+std::string paragraph(Random& rng)
+{
+	// Sentences of plain text with some markup sprinkled in.
+	std::string result = "<p>";
+	const unsigned int sentences = triangular(rng, 1, 7);
+	for (unsigned int i = 0; i < sentences; ++i) {
+		if (i > 0) {
+			result.push_back(' ');
+		}
+		result.append(xml_escape(words(rng, triangular(rng, 4, 24))));
+		if (rng.chance(20)) {
+			result.append(" <a href=\"https://example.com/" +
+				std::to_string(rng.between(1, 100000)) + "\">" +
+				xml_escape(words(rng, rng.between(1, 4))) + "</a>");
+		}
+		if (rng.chance(15)) {
+			const std::string tag = rng.chance(50) ? "b" : "em";
+			result.append(" <" + tag + ">");
+			result.append(xml_escape(words(rng, rng.between(1, 3))));
+			result.append("</" + tag + ">");
+		}
+		result.push_back('.');
+	}
+	result.append("</p>\n");
+	return result;
+}
+
+std::string description(Random& rng)
+{
+	const bool long_read = rng.chance(10);
+	const unsigned int paragraphs = long_read
+		? triangular(rng, 15, 40)
+		: triangular(rng, 1, 6);
+
+	std::string result;
+	for (unsigned int i = 0; i < paragraphs; ++i) {
+		result.append(paragraph(rng));
+		if (rng.chance(8)) {
+			result.append("<ul>\n");
+			for (unsigned int j = rng.between(2, 6); j > 0; --j) {
+				result.append("<li>" + xml_escape(words(rng, rng.between(2,
+									10))) + "</li>\n");
+			}
+			result.append("</ul>\n");
+		}
+		if (rng.chance(4)) {
+			result.append("<pre><code>for (auto&amp; x : xs) {\n"
+				"\tstd::cout &lt;&lt; x &lt;&lt; '\\n';\n}</code></pre>\n");
+		}
+		if (rng.chance(5)) {
+			result.append("<img src=\"https://example.com/img/" +
+				std::to_string(rng.between(1, 1000)) +
+				".png\" alt=\"" + xml_escape(words(rng, 2)) + "\">\n");
+		}
+	}
+	return result;
+}
+
+std::string rfc822_date(time_t t)
+{
+	static const char* const days[] = {
+		"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"
+	};
+	static const char* const months[] = {
+		"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+		"Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+	};
+	struct tm tm;
+	gmtime_r(&t, &tm);
+	char buf[64];
+	snprintf(buf, sizeof(buf), "%s, %02d %s %04d %02d:%02d:%02d +0000",
+		days[tm.tm_wday],
+		tm.tm_mday,
+		months[tm.tm_mon],
+		tm.tm_year + 1900,
+		tm.tm_hour,
+		tm.tm_min,
+		tm.tm_sec);
+	return buf;
+}
+
+std::string w3c_date(time_t t)
+{
+	struct tm tm;
+	gmtime_r(&t, &tm);
+	char buf[64];
+	strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
+	return buf;
+}
+
+std::string rss20_xml(const FeedData& feed)
+{
+	std::string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		"<rss version=\"2.0\">\n<channel>\n";
+	xml.append("<title>" + xml_escape(feed.title) + "</title>\n");
+	xml.append("<link>" + xml_escape(feed.link) + "</link>\n");
+	xml.append("<description>Synthetic feed</description>\n");
+	for (const auto& item : feed.items) {
+		xml.append("<item>\n");
+		xml.append("<title>" + xml_escape(item.title) + "</title>\n");
+		xml.append("<link>" + xml_escape(item.link) + "</link>\n");
+		xml.append("<guid isPermaLink=\"false\">" + xml_escape(item.guid) +
+			"</guid>\n");
+		if (!item.author.empty()) {
+			xml.append("<author>" + xml_escape(item.author) + "</author>\n");
+		}
+		xml.append("<pubDate>" + rfc822_date(item.pubdate) + "</pubDate>\n");
+		xml.append("<description>" + xml_escape(item.description) +
+			"</description>\n");
+		xml.append("</item>\n");
+	}
+	xml.append("</channel>\n</rss>\n");
+	return xml;
+}
+
+std::string rss10_xml(const FeedData& feed)
+{
+	std::string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		"<rdf:RDF xmlns:rdf=\"http://www.w3.org/1999/02/22-rdf-syntax-ns#\" "
+		"xmlns=\"http://purl.org/rss/1.0/\" "
+		"xmlns:dc=\"http://purl.org/dc/elements/1.1/\" "
+		"xmlns:content=\"http://purl.org/rss/1.0/modules/content/\">\n";
+	xml.append("<channel rdf:about=\"" + xml_escape(feed.url) + "\">\n");
+	xml.append("<title>" + xml_escape(feed.title) + "</title>\n");
+	xml.append("<link>" + xml_escape(feed.link) + "</link>\n");
+	xml.append("<description>Synthetic feed</description>\n");
+	xml.append("<items><rdf:Seq>\n");
+	for (const auto& item : feed.items) {
+		xml.append("<rdf:li rdf:resource=\"" + xml_escape(item.guid) +
+			"\"/>\n");
+	}
+	xml.append("</rdf:Seq></items>\n</channel>\n");
+	for (const auto& item : feed.items) {
+		xml.append("<item rdf:about=\"" + xml_escape(item.guid) + "\">\n");
+		xml.append("<title>" + xml_escape(item.title) + "</title>\n");
+		xml.append("<link>" + xml_escape(item.link) + "</link>\n");
+		if (!item.author.empty()) {
+			xml.append("<dc:creator>" + xml_escape(item.author) +
+				"</dc:creator>\n");
+		}
+		xml.append("<dc:date>" + w3c_date(item.pubdate) + "</dc:date>\n");
+		xml.append("<content:encoded><![CDATA[" + item.description +
+			"]]></content:encoded>\n");
+		xml.append("</item>\n");
+	}
+	xml.append("</rdf:RDF>\n");
+	return xml;
+}
+
+std::string atom_xml(const FeedData& feed)
+{
+	std::string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		"<feed xmlns=\"http://www.w3.org/2005/Atom\">\n";
+	xml.append("<title>" + xml_escape(feed.title) + "</title>\n");
+	xml.append("<link href=\"" + xml_escape(feed.link) + "\"/>\n");
+	xml.append("<id>" + xml_escape(feed.url) + "</id>\n");
+	if (!feed.items.empty()) {
+		xml.append("<updated>" + w3c_date(feed.items.front().pubdate) +
+			"</updated>\n");
+	}
+	for (const auto& item : feed.items) {
+		xml.append("<entry>\n");
+		xml.append("<title>" + xml_escape(item.title) + "</title>\n");
+		xml.append("<link href=\"" + xml_escape(item.link) + "\"/>\n");
+		xml.append("<id>" + xml_escape(item.guid) + "</id>\n");
+		if (!item.author.empty()) {
+			xml.append("<author><name>" + xml_escape(item.author) +
+				"</name></author>\n");
+		}
+		xml.append("<updated>" + w3c_date(item.pubdate) + "</updated>\n");
+		xml.append("<content type=\"html\">" + xml_escape(item.description) +
+			"</content>\n");
+		xml.append("</entry>\n");
+	}
+	xml.append("</feed>\n");
+	return xml;
+}
+
+} // namespace
+
+Random::Random(std::uint64_t seed)
+	: state(seed)
+{
+}
+
+std::uint64_t Random::next()
+{
+	std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+std::uint32_t Random::between(std::uint32_t min, std::uint32_t max)
+{
+	// The modulo bias is negligible for the small ranges used here.
+	return min + next() % (static_cast<std::uint64_t>(max) - min + 1);
+}
+
+bool Random::chance(unsigned int percent)
+{
+	return between(0, 99) < percent;
+}
+
+std::string FeedData::to_xml() const
+{
+	switch (format) {
+	case FeedFormat::RSS_2_0:
+		return rss20_xml(*this);
+	case FeedFormat::RSS_1_0:
+		return rss10_xml(*this);
+	case FeedFormat::ATOM_1_0:
+		return atom_xml(*this);
+	}
+	return {};
+}
+
+std::shared_ptr<newsboat::RssFeed> FeedData::to_rssfeed(
+	newsboat::Cache* cache) const
+{
+	auto feed = std::make_shared<newsboat::RssFeed>(cache);
+	feed->set_rssurl(url);
+	feed->set_title(title);
+	feed->set_link(link);
+	for (const auto& data : items) {
+		auto item = std::make_shared<newsboat::RssItem>(cache);
+		item->set_guid(data.guid);
+		item->set_title(data.title);
+		item->set_link(data.link);
+		item->set_author(data.author);
+		item->set_description(data.description);
+		item->set_pubDate(data.pubdate);
+		item->set_unread_nowrite(data.unread);
+		item->set_feedurl(url);
+		feed->add_item(item);
+	}
+	feed->set_feedptrs(feed);
+	return feed;
+}
+
+std::vector<FeedData> generate_corpus(unsigned int feed_count,
+	unsigned int items_per_feed,
+	std::uint64_t seed)
+{
+	// 2020-01-01T00:00:00Z; items go back in time from here.
+	const time_t newest = 1577836800;
+
+	Random rng(seed);
+	std::vector<FeedData> corpus;
+	corpus.reserve(feed_count);
+	for (unsigned int f = 0; f < feed_count; ++f) {
+		FeedData feed;
+		switch (f % 3) {
+		case 0:
+			feed.format = FeedFormat::RSS_2_0;
+			break;
+		case 1:
+			feed.format = FeedFormat::RSS_1_0;
+			break;
+		default:
+			feed.format = FeedFormat::ATOM_1_0;
+			break;
+		}
+		const std::string site = "https://feed" + std::to_string(f) +
+			".example.com/";
+		feed.url = site + "feed.xml";
+		feed.link = site;
+		feed.title = words(rng, triangular(rng, 1, 6));
+
+		time_t pubdate = newest - rng.between(0, 86400);
+		feed.items.reserve(items_per_feed);
+		for (unsigned int i = 0; i < items_per_feed; ++i) {
+			ItemData item;
+			item.link = site + "posts/" + std::to_string(i);
+			item.guid = "tag:feed" + std::to_string(f) + ".example.com," +
+				std::to_string(i);
+			item.title = words(rng, triangular(rng, 2, 14));
+			item.author = AUTHORS[rng.between(0, AUTHORS.size() - 1)];
+			item.description = description(rng);
+			item.pubdate = pubdate;
+			// The newest articles are the ones that are still unread.
+			item.unread = i < items_per_feed / 4 || rng.chance(10);
+			feed.items.push_back(std::move(item));
+
+			pubdate -= rng.between(60, 3 * 86400);
+		}
+		corpus.push_back(std::move(feed));
+	}
+	return corpus;
+}
+
+} // namespace Bench
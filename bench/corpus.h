@@ -0,0 +1,82 @@
+#ifndef NEWSBOAT_BENCH_CORPUS_H_
+#define NEWSBOAT_BENCH_CORPUS_H_
+
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace newsboat {
+class Cache;
+class RssFeed;
+}
+
+namespace Bench {
+
+/// \brief Pseudo-random number generator (SplitMix64).
+///
+/// The distributions from <random> are implementation-defined, so they'd give
+/// a different corpus with every standard library; this one gives the same
+/// numbers everywhere.
+class Random {
+public:
+	explicit Random(std::uint64_t seed);
+
+	std::uint64_t next();
+
+	/// \brief Returns a number in [min; max].
+	std::uint32_t between(std::uint32_t min, std::uint32_t max);
+
+	/// \brief Returns `true` with the given probability (in percent).
+	bool chance(unsigned int percent);
+
+private:
+	std::uint64_t state;
+};
+
+enum class FeedFormat { RSS_2_0, RSS_1_0, ATOM_1_0 };
+
+struct ItemData {
+	std::string guid;
+	std::string title;
+	std::string link;
+	std::string author;
+	/// HTML
+	std::string description;
+	time_t pubdate;
+	bool unread;
+};
+
+struct FeedData {
+	FeedFormat format;
+	std::string url;
+	std::string title;
+	std::string link;
+	std::vector<ItemData> items;
+
+	/// \brief Serializes the feed in its format.
+	std::string to_xml() const;
+
+	/// \brief Creates an RssFeed with the same contents, as if it was just
+	/// downloaded and parsed.
+	std::shared_ptr<newsboat::RssFeed> to_rssfeed(newsboat::Cache* cache)
+	const;
+};
+
+const std::uint64_t DEFAULT_SEED = 20200101;
+
+/// \brief Generates `feed_count` feeds with `items_per_feed` items each.
+///
+/// The same arguments always produce the same corpus. Feeds cycle through
+/// RSS 2.0, RSS 1.0 and Atom. Titles are mostly five to ten words long;
+/// descriptions are HTML with links, emphasis, lists and the occasional
+/// code block, mostly a few paragraphs long, with one article in ten being a
+/// long read.
+std::vector<FeedData> generate_corpus(unsigned int feed_count,
+	unsigned int items_per_feed,
+	std::uint64_t seed = DEFAULT_SEED);
+
+} // namespace Bench
+
+#endif /* NEWSBOAT_BENCH_CORPUS_H_ */
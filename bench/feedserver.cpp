@@ -0,0 +1,308 @@
+#include "feedserver.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <functional>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <zlib.h>
+
+namespace Bench {
+
+namespace {
+
+std::string gzip(const std::string& data)
+{
+	z_stream zs{};
+	// 16 added to the window bits asks for a gzip header instead of a zlib
+	// one.
+	if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+			Z_DEFAULT_STRATEGY) != Z_OK) {
+		throw std::runtime_error("deflateInit2 failed");
+	}
+
+	std::string result(deflateBound(&zs, data.size()), '\0');
+	zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+	zs.avail_in = data.size();
+	zs.next_out = reinterpret_cast<Bytef*>(&result[0]);
+	zs.avail_out = result.size();
+	const int status = deflate(&zs, Z_FINISH);
+	deflateEnd(&zs);
+	if (status != Z_STREAM_END) {
+		throw std::runtime_error("deflate failed");
+	}
+	result.resize(zs.total_out);
+	return result;
+}
+
+std::string http_date(time_t t)
+{
+	static const char* const days[] = {
+		"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"
+	};
+	static const char* const months[] = {
+		"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+		"Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+	};
+	struct tm tm;
+	gmtime_r(&t, &tm);
+	char buf[64];
+	snprintf(buf, sizeof(buf), "%s, %02d %s %04d %02d:%02d:%02d GMT",
+		days[tm.tm_wday],
+		tm.tm_mday,
+		months[tm.tm_mon],
+		tm.tm_year + 1900,
+		tm.tm_hour,
+		tm.tm_min,
+		tm.tm_sec);
+	return buf;
+}
+
+/// Returns the value of the header `name` (which must be lowercase), or an
+/// empty string if the request doesn't have it.
+std::string get_header(const std::string& request, const std::string& name)
+{
+	std::size_t pos = request.find("\r\n");
+	while (pos != std::string::npos) {
+		const std::size_t start = pos + 2;
+		const std::size_t end = request.find("\r\n", start);
+		const std::size_t colon = request.find(':', start);
+		if (end == std::string::npos || colon == std::string::npos
+			|| colon > end) {
+			break;
+		}
+		std::string key = request.substr(start, colon - start);
+		std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+		if (key == name) {
+			std::size_t value_start = colon + 1;
+			while (value_start < end && request[value_start] == ' ') {
+				value_start++;
+			}
+			return request.substr(value_start, end - value_start);
+		}
+		pos = end;
+	}
+	return {};
+}
+
+} // namespace
+
+FeedServer::FeedServer(const std::vector<FeedData>& corpus,
+	const FeedServerOptions& options)
+	: options(options)
+	, rng(options.seed)
+{
+	for (const auto& feed : corpus) {
+		Document doc;
+		doc.body = feed.to_xml();
+		doc.gzipped_body = gzip(doc.body);
+		doc.etag = "\"" + std::to_string(std::hash<std::string>()(doc.body)) +
+			"\"";
+		doc.last_modified = http_date(feed.items.empty()
+				? 0
+				: feed.items.front().pubdate);
+		documents.push_back(std::move(doc));
+	}
+
+	listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (listen_fd < 0) {
+		throw std::runtime_error("FeedServer: couldn't create a socket");
+	}
+	const int yes = 1;
+	setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+	sockaddr_in addr{};
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+	socklen_t addr_len = sizeof(addr);
+	if (bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0
+		|| listen(listen_fd, 64) != 0
+		|| getsockname(listen_fd, reinterpret_cast<sockaddr*>(&addr),
+			&addr_len) != 0) {
+		close(listen_fd);
+		throw std::runtime_error("FeedServer: couldn't listen on localhost");
+	}
+	port = ntohs(addr.sin_port);
+
+	acceptor = std::thread(&FeedServer::accept_connections, this);
+}
+
+FeedServer::~FeedServer()
+{
+	stopping = true;
+	acceptor.join();
+	close(listen_fd);
+
+	std::lock_guard<std::mutex> guard(connections_mtx);
+	for (auto& connection : connections) {
+		connection.join();
+	}
+}
+
+std::string FeedServer::url(std::size_t index) const
+{
+	return "http://127.0.0.1:" + std::to_string(port) + "/feed/" +
+		std::to_string(index) + ".xml";
+}
+
+FeedServer::Stats FeedServer::stats() const
+{
+	std::lock_guard<std::mutex> guard(stats_mtx);
+	return current_stats;
+}
+
+void FeedServer::accept_connections()
+{
+	while (!stopping) {
+		// Polling with a timeout lets the destructor stop us.
+		pollfd pfd{listen_fd, POLLIN, 0};
+		if (poll(&pfd, 1, 100) <= 0) {
+			continue;
+		}
+		const int fd = accept(listen_fd, nullptr, nullptr);
+		if (fd < 0) {
+			continue;
+		}
+		std::lock_guard<std::mutex> guard(connections_mtx);
+		connections.emplace_back(&FeedServer::serve_connection, this, fd);
+	}
+}
+
+void FeedServer::serve_connection(int fd)
+{
+	std::string buffer;
+	char chunk[4096];
+	while (!stopping) {
+		const std::size_t end_of_request = buffer.find("\r\n\r\n");
+		if (end_of_request != std::string::npos) {
+			const std::string request = buffer.substr(0, end_of_request + 2);
+			buffer.erase(0, end_of_request + 4);
+
+			if (options.latency.count() > 0) {
+				std::this_thread::sleep_for(options.latency);
+			}
+			if (!send_all(fd, respond(request))) {
+				break;
+			}
+			if (get_header(request, "connection") == "close") {
+				break;
+			}
+			continue;
+		}
+
+		pollfd pfd{fd, POLLIN, 0};
+		if (poll(&pfd, 1, 100) <= 0) {
+			continue;
+		}
+		const ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+		if (n <= 0) {
+			break;
+		}
+		buffer.append(chunk, n);
+	}
+	close(fd);
+}
+
+std::string FeedServer::respond(const std::string& request)
+{
+	std::lock_guard<std::mutex> guard(stats_mtx);
+	current_stats.requests++;
+
+	const std::string request_line = request.substr(0, request.find("\r\n"));
+	const std::string prefix = "GET /feed/";
+	std::size_t index = documents.size();
+	if (request_line.compare(0, prefix.size(), prefix) == 0) {
+		index = std::strtoul(request_line.c_str() + prefix.size(), nullptr, 10);
+	}
+
+	if (index >= documents.size()) {
+		return "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+	}
+	if (should_fail()) {
+		current_stats.errors++;
+		return "HTTP/1.1 500 Internal Server Error\r\n"
+			"Content-Length: 0\r\n\r\n";
+	}
+
+	const auto& doc = documents[index];
+	std::string headers;
+	if (options.conditional_get) {
+		headers.append("ETag: " + doc.etag + "\r\n");
+		headers.append("Last-Modified: " + doc.last_modified + "\r\n");
+
+		const auto if_none_match = get_header(request, "if-none-match");
+		const auto if_modified_since = get_header(request,
+				"if-modified-since");
+		if ((!if_none_match.empty() && if_none_match == doc.etag)
+			|| (if_none_match.empty()
+				&& if_modified_since == doc.last_modified)) {
+			current_stats.not_modified++;
+			return "HTTP/1.1 304 Not Modified\r\n" + headers + "\r\n";
+		}
+	}
+
+	const bool compress = options.gzip
+		&& get_header(request, "accept-encoding").find("gzip")
+		!= std::string::npos;
+	const std::string& body = compress ? doc.gzipped_body : doc.body;
+	if (compress) {
+		headers.append("Content-Encoding: gzip\r\n");
+	}
+	current_stats.bytes_sent += body.size();
+
+	return "HTTP/1.1 200 OK\r\n"
+		"Content-Type: application/xml; charset=utf-8\r\n"
+		"Content-Length: " + std::to_string(body.size()) + "\r\n" +
+		headers + "\r\n" + body;
+}
+
+bool FeedServer::send_all(int fd, const std::string& data)
+{
+#ifdef MSG_NOSIGNAL
+	const int flags = MSG_NOSIGNAL;
+#else
+	const int flags = 0;
+#endif
+
+	// Without a bandwidth limit, everything goes out at once. With one, the
+	// data is sent in slices, each one after the previous ones would've
+	// taken their time.
+	const std::size_t slice = options.bandwidth > 0
+		? std::max<std::size_t>(options.bandwidth / 50, 1)
+		: data.size();
+	const auto start = std::chrono::steady_clock::now();
+
+	std::size_t sent = 0;
+	while (sent < data.size() && !stopping) {
+		if (options.bandwidth > 0) {
+			const auto due = start + std::chrono::microseconds(
+					static_cast<std::int64_t>(sent) * 1000000 / options.bandwidth);
+			std::this_thread::sleep_until(due);
+		}
+		const std::size_t length = std::min(slice, data.size() - sent);
+		const ssize_t n = send(fd, data.data() + sent, length, flags);
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		sent += n;
+	}
+	return sent == data.size();
+}
+
+bool FeedServer::should_fail()
+{
+	std::lock_guard<std::mutex> guard(rng_mtx);
+	return rng.chance(options.error_rate);
+}
+
+} // namespace Bench
@@ -0,0 +1,99 @@
+#ifndef NEWSBOAT_BENCH_FEEDSERVER_H_
+#define NEWSBOAT_BENCH_FEEDSERVER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "corpus.h"
+
+namespace Bench {
+
+struct FeedServerOptions {
+	/// How long the server waits before answering a request.
+	std::chrono::milliseconds latency{0};
+
+	/// Bytes per second for each connection; 0 means unlimited.
+	std::size_t bandwidth = 0;
+
+	/// Percentage of requests that are answered with "500 Internal Server
+	/// Error".
+	unsigned int error_rate = 0;
+
+	/// Whether to send ETag and Last-Modified, and to answer matching
+	/// conditional requests with "304 Not Modified".
+	bool conditional_get = true;
+
+	/// Whether to compress responses if the client accepts gzip.
+	bool gzip = true;
+
+	/// Decides which requests fail.
+	std::uint64_t seed = DEFAULT_SEED;
+};
+
+/// \brief A minimal HTTP/1.1 server on localhost, serving a generated corpus.
+///
+/// It only knows GET, and serves the feed `i` of the corpus at `url(i)`.
+/// Each connection is handled by a thread of its own, and is kept alive
+/// until the client closes it, just like a real server would do for
+/// Newsboat's reload threads.
+class FeedServer {
+public:
+	/// \brief Starts listening on an ephemeral port.
+	///
+	/// Throws std::runtime_error if that isn't possible.
+	FeedServer(const std::vector<FeedData>& corpus,
+		const FeedServerOptions& options);
+	~FeedServer();
+	FeedServer(const FeedServer&) = delete;
+	FeedServer& operator=(const FeedServer&) = delete;
+
+	std::string url(std::size_t index) const;
+
+	struct Stats {
+		std::uint64_t requests = 0;
+		std::uint64_t not_modified = 0;
+		std::uint64_t errors = 0;
+		std::uint64_t bytes_sent = 0;
+	};
+	Stats stats() const;
+
+private:
+	struct Document {
+		std::string body;
+		std::string gzipped_body;
+		std::string etag;
+		std::string last_modified;
+	};
+
+	void accept_connections();
+	void serve_connection(int fd);
+	std::string respond(const std::string& request);
+	bool send_all(int fd, const std::string& data);
+	bool should_fail();
+
+	const FeedServerOptions options;
+	std::vector<Document> documents;
+
+	int listen_fd = -1;
+	std::uint16_t port = 0;
+	std::atomic<bool> stopping{false};
+	std::thread acceptor;
+
+	std::mutex connections_mtx;
+	std::vector<std::thread> connections;
+
+	std::mutex rng_mtx;
+	Random rng;
+
+	mutable std::mutex stats_mtx;
+	Stats current_stats;
+};
+
+} // namespace Bench
+
+#endif /* NEWSBOAT_BENCH_FEEDSERVER_H_ */
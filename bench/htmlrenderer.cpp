@@ -0,0 +1,37 @@
+#include "htmlrenderer.h"
+
+#include <algorithm>
+
+#include "3rd-party/catch.hpp"
+#include "corpus.h"
+
+using namespace newsboat;
+
+TEST_CASE("HtmlRenderer::render()", "[HtmlRenderer]")
+{
+	const auto corpus = Bench::generate_corpus(1, 200);
+	auto items = corpus.front().items;
+	std::sort(items.begin(), items.end(),
+	[](const Bench::ItemData& a, const Bench::ItemData& b) {
+		return a.description.size() < b.description.size();
+	});
+
+	const auto& typical = items[items.size() / 2].description;
+	const auto& longest = items.back().description;
+
+	HtmlRenderer renderer;
+	BENCHMARK("typical article, " + std::to_string(typical.size()) +
+		" bytes") {
+		std::vector<std::pair<LineType, std::string>> lines;
+		std::vector<LinkPair> links;
+		renderer.render(typical, lines, links, "https://example.com/");
+		return lines.size();
+	};
+
+	BENCHMARK("long article, " + std::to_string(longest.size()) + " bytes") {
+		std::vector<std::pair<LineType, std::string>> lines;
+		std::vector<LinkPair> links;
+		renderer.render(longest, lines, links, "https://example.com/");
+		return lines.size();
+	};
+}
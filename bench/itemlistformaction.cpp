@@ -0,0 +1,61 @@
+#include "itemlistformaction.h"
+
+#include "3rd-party/catch.hpp"
+#include "allocations.h"
+#include "cache.h"
+#include "configpaths.h"
+#include "corpus.h"
+#include "itemlist.h"
+#include "regexmanager.h"
+#include "rssfeed.h"
+#include "strprintf.h"
+
+using namespace newsboat;
+
+TEST_CASE("ItemListFormAction::prepare() formatting every line",
+	"[ItemListFormAction]")
+{
+	const auto corpus = Bench::generate_corpus(1, 1000);
+
+	ConfigPaths paths;
+	Controller c(paths);
+	newsboat::View v(&c);
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	FilterContainer filters;
+	RegexManager rxman;
+
+	v.set_config_container(&cfg);
+	c.set_view(&v);
+
+	const auto feed = corpus.front().to_rssfeed(&rsscache);
+
+	ItemListFormAction itemlist(&v, itemlist_str, &rsscache, filters, &cfg,
+		rxman);
+	itemlist.set_feed(feed);
+
+	const auto report_allocations = [&](const std::string& name) {
+		itemlist.set_redraw(true);
+		Bench::AllocationCounter allocations;
+		itemlist.prepare();
+		WARN(strprintf::fmt("%s: %.1f allocations per line",
+				name,
+				allocations.count() / 1000.0));
+	};
+
+	// The form is never displayed, so the list has no height and every line
+	// counts as visible.
+	BENCHMARK("default articlelist-format, 1000 items") {
+		itemlist.set_redraw(true);
+		itemlist.prepare();
+	};
+	report_allocations("default articlelist-format");
+
+	cfg.set_configvalue("articlelist-format",
+		"%4i %f %D %6L %-20a %?T?|%-17T|  &?%t");
+	BENCHMARK("with author and feed title, 1000 items") {
+		itemlist.set_redraw(true);
+		itemlist.prepare();
+	};
+	report_allocations("with author and feed title");
+}
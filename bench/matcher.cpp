@@ -0,0 +1,40 @@
+#include "matcher.h"
+
+#include "3rd-party/catch.hpp"
+#include "cache.h"
+#include "configcontainer.h"
+#include "corpus.h"
+#include "rssfeed.h"
+#include "rssitem.h"
+
+using namespace newsboat;
+
+TEST_CASE("Matcher::matches()", "[Matcher]")
+{
+	const auto corpus = Bench::generate_corpus(1, 1000);
+
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	const auto feed = corpus.front().to_rssfeed(&rsscache);
+
+	const std::vector<std::string> filters = {
+		"unread = \"yes\"",
+		"title =~ \"kernel|release\"",
+		"author = \"Carol\" or content =~ \"caf.\"",
+		"unread = \"yes\" and age < 30 and title !~ \"weekly\"",
+	};
+
+	for (const auto& filter : filters) {
+		Matcher m;
+		REQUIRE(m.parse(filter));
+		BENCHMARK(filter + ", 1000 items") {
+			unsigned int count = 0;
+			for (const auto& item : feed->items()) {
+				if (m.matches(item.get())) {
+					count++;
+				}
+			}
+			return count;
+		};
+	}
+}
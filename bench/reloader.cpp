@@ -0,0 +1,206 @@
+#include "reloader.h"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+
+#include "3rd-party/catch.hpp"
+#include "cliargsparser.h"
+#include "configpaths.h"
+#include "controller.h"
+#include "corpus.h"
+#include "feedserver.h"
+#include "scopemeasure.h"
+#include "strprintf.h"
+#include "test/test-helpers/opts.h"
+#include "test/test-helpers/tempdir.h"
+#include "view.h"
+
+using namespace newsboat;
+
+namespace {
+
+struct Scenario {
+	std::string name;
+	Bench::FeedServerOptions server;
+	unsigned int reload_threads;
+};
+
+/// What the trace says about one reload.
+struct ReloadProfile {
+	double wall_ms = 0;
+	std::vector<double> feed_latencies_ms;
+	double fetch_cpu_ms = 0;
+	double parse_cpu_ms = 0;
+	double cache_cpu_ms = 0;
+};
+
+/// Runs `newsboat -x reload` against the server, and returns the profile of
+/// the reload itself (not of the startup).
+ReloadProfile run_reload(const std::string& dir, const std::string& cache)
+{
+	TestHelpers::Opts opts = {
+		"newsboat",
+		"-u", dir + "urls",
+		"-C", dir + "config",
+		"-c", dir + cache,
+		"-x", "reload"
+	};
+	CliArgsParser args(opts.argc(), opts.argv());
+
+	ScopeMeasure::take_trace_events();
+	{
+		ConfigPaths paths;
+		REQUIRE(paths.initialized());
+		paths.process_args(args);
+		Controller c(paths);
+		newsboat::View v(&c);
+		c.set_view(&v);
+		REQUIRE(c.run(args) == EXIT_SUCCESS);
+	}
+	const auto events = ScopeMeasure::take_trace_events();
+
+	const auto reload_all = std::find_if(events.begin(), events.end(),
+	[](const ScopeMeasure::TraceEvent& event) {
+		return event.name == "Reloader::reload_all";
+	});
+	REQUIRE(reload_all != events.end());
+	const auto start = reload_all->start_ns;
+	const auto end = start + reload_all->duration_ns;
+
+	// Thread CPU time of all scopes with a given name, summed over the
+	// threads.
+	std::map<std::string, std::int64_t> cpu_ns;
+	ReloadProfile profile;
+	profile.wall_ms = reload_all->duration_ns / 1e6;
+	for (const auto& event : events) {
+		if (event.phase != 'X' || event.start_ns < start
+			|| event.start_ns > end) {
+			continue;
+		}
+		cpu_ns[event.name] += event.thread_duration_ns;
+		if (event.name == "Reloader::reload") {
+			profile.feed_latencies_ms.push_back(event.duration_ns / 1e6);
+		}
+	}
+
+	// parse_url() downloads the feed and then calls parse_buffer(), and
+	// RssParser::parse() calls parse_url() and then converts the result.
+	const auto fetch = cpu_ns["rsspp::Parser::parse_url"]
+		- cpu_ns["rsspp::Parser::parse_buffer"];
+	const auto cache_in_parse = cpu_ns["Cache::remove_old_deleted_items"];
+	profile.fetch_cpu_ms = fetch / 1e6;
+	profile.parse_cpu_ms = (cpu_ns["RssParser::parse"] - fetch
+			- cache_in_parse) / 1e6;
+	profile.cache_cpu_ms = (cpu_ns["Cache::externalize_feed"]
+			+ cpu_ns["Cache::internalize_rssfeed"] + cache_in_parse) / 1e6;
+	return profile;
+}
+
+double percentile(std::vector<double> values, unsigned int p)
+{
+	if (values.empty()) {
+		return 0;
+	}
+	std::sort(values.begin(), values.end());
+	const std::size_t index = (values.size() - 1) * p / 100;
+	return values[index];
+}
+
+void report(const std::string& name, unsigned int feed_count,
+	const std::vector<ReloadProfile>& runs)
+{
+	double wall_ms = 0;
+	double fetch_ms = 0;
+	double parse_ms = 0;
+	double cache_ms = 0;
+	std::vector<double> latencies;
+	for (const auto& run : runs) {
+		wall_ms += run.wall_ms;
+		fetch_ms += run.fetch_cpu_ms;
+		parse_ms += run.parse_cpu_ms;
+		cache_ms += run.cache_cpu_ms;
+		latencies.insert(latencies.end(), run.feed_latencies_ms.begin(),
+			run.feed_latencies_ms.end());
+	}
+	const double n = runs.size();
+
+	WARN(strprintf::fmt("%s\n"
+			"feeds per second: %.1f\n"
+			"per-feed latency p50: %.2f ms\n"
+			"per-feed latency p99: %.2f ms\n"
+			"CPU time fetching: %.2f ms\n"
+			"CPU time parsing: %.2f ms\n"
+			"CPU time writing to the cache: %.2f ms",
+			name,
+			feed_count / (wall_ms / n / 1000),
+			percentile(latencies, 50),
+			percentile(latencies, 99),
+			fetch_ms / n,
+			parse_ms / n,
+			cache_ms / n));
+}
+
+} // namespace
+
+TEST_CASE("Reloader::reload_all() against a local server", "[Reloader]")
+{
+	const unsigned int feed_count = 100;
+	const unsigned int runs = 3;
+	const auto corpus = Bench::generate_corpus(feed_count, 20);
+
+	// In-memory only; the events are analyzed by run_reload().
+	ScopeMeasure::start_tracing("");
+
+	std::vector<Scenario> scenarios;
+	{
+		Scenario s;
+		s.name = "no latency, 1 thread";
+		s.reload_threads = 1;
+		scenarios.push_back(s);
+	}
+	for (const unsigned int threads : std::vector<unsigned int> {1, 8}) {
+		Scenario s;
+		s.name = "50 ms latency, " + std::to_string(threads) + " thread(s)";
+		s.server.latency = std::chrono::milliseconds(50);
+		s.reload_threads = threads;
+		scenarios.push_back(s);
+	}
+	{
+		Scenario s;
+		s.name = "50 ms latency, 1 MB/s, 5% errors, no gzip, 8 threads";
+		s.server.latency = std::chrono::milliseconds(50);
+		s.server.bandwidth = 1024 * 1024;
+		s.server.error_rate = 5;
+		s.server.gzip = false;
+		s.reload_threads = 8;
+		scenarios.push_back(s);
+	}
+
+	for (const auto& scenario : scenarios) {
+		Bench::FeedServer server(corpus, scenario.server);
+
+		TestHelpers::TempDir dir;
+		{
+			std::ofstream urls(dir.get_path() + "urls");
+			for (unsigned int i = 0; i < feed_count; ++i) {
+				urls << server.url(i) << '\n';
+			}
+			std::ofstream config(dir.get_path() + "config");
+			config << "reload-threads " << scenario.reload_threads << '\n';
+		}
+
+		std::vector<ReloadProfile> initial;
+		std::vector<ReloadProfile> unchanged;
+		for (unsigned int run = 0; run < runs; ++run) {
+			const auto cache = "cache" + std::to_string(run) + ".db";
+			// The first reload into an empty cache gets every feed in full;
+			// the second one mostly gets "304 Not Modified".
+			initial.push_back(run_reload(dir.get_path(), cache));
+			unchanged.push_back(run_reload(dir.get_path(), cache));
+		}
+
+		report(scenario.name + ", empty cache", feed_count, initial);
+		report(scenario.name + ", nothing changed", feed_count, unchanged);
+	}
+}
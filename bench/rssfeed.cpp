@@ -0,0 +1,48 @@
+#include "rssfeed.h"
+
+#include "3rd-party/catch.hpp"
+#include "cache.h"
+#include "configcontainer.h"
+#include "corpus.h"
+
+using namespace newsboat;
+
+TEST_CASE("RssFeed::sort_unlocked()", "[RssFeed]")
+{
+	const auto corpus = Bench::generate_corpus(1, 1000);
+
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	const auto feed = corpus.front().to_rssfeed(&rsscache);
+
+	// Every run starts from the same shuffled order, rather than from the
+	// result of the previous run.
+	auto shuffled = feed->items();
+	Bench::Random rng(Bench::DEFAULT_SEED);
+	for (std::size_t i = shuffled.size(); i > 1; --i) {
+		std::swap(shuffled[i - 1], shuffled[rng.between(0, i - 1)]);
+	}
+
+	const std::vector<std::pair<std::string, ArtSortMethod>> methods = {
+		{"date", ArtSortMethod::DATE},
+		{"title", ArtSortMethod::TITLE},
+		{"author", ArtSortMethod::AUTHOR},
+		{"guid", ArtSortMethod::GUID},
+	};
+
+	for (const auto& method : methods) {
+		ArticleSortStrategy strategy;
+		strategy.sm = method.second;
+		strategy.sd = SortDirection::DESC;
+
+		BENCHMARK_ADVANCED("by " + method.first + ", 1000 items")(
+			Catch::Benchmark::Chronometer meter) {
+			std::vector<std::vector<std::shared_ptr<RssItem>>> orders(
+				meter.runs(), shuffled);
+			meter.measure([&](int i) {
+				feed->items().swap(orders[i]);
+				feed->sort_unlocked(strategy);
+			});
+		};
+	}
+}
@@ -0,0 +1,18 @@
+#include "rss/parser.h"
+
+#include "3rd-party/catch.hpp"
+#include "corpus.h"
+
+TEST_CASE("rsspp::Parser::parse_buffer()", "[rsspp::Parser]")
+{
+	const auto corpus = Bench::generate_corpus(3, 100);
+	const std::vector<std::string> formats = {"RSS 2.0", "RSS 1.0", "Atom 1.0"};
+
+	rsspp::Parser parser;
+	for (std::size_t i = 0; i < corpus.size(); ++i) {
+		const auto xml = corpus[i].to_xml();
+		BENCHMARK(formats[i] + ", 100 items") {
+			return parser.parse_buffer(xml);
+		};
+	}
+}
@@ -1,11 +1,14 @@
 #ifndef NEWSBOAT_CACHE_H_
 #define NEWSBOAT_CACHE_H_
 
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <sqlite3.h>
 #include <unordered_set>
+#include <vector>
 
+#include "3rd-party/optional.hpp"
 #include "configcontainer.h"
 
 namespace newsboat {
@@ -39,6 +42,25 @@ const SchemaVersion unknown_version = {0, 0};
 
 using schema_patches = std::map<SchemaVersion, std::vector<std::string>>;
 
+enum class OutboxAction {
+	MARK_UNREAD = 0,
+	MARK_READ = 1,
+	UPDATE_FLAGS = 2,
+};
+
+/// \brief A change to an article that hasn't been sent to the remote API
+/// yet. See RemoteOutbox.
+struct OutboxEntry {
+	int64_t id;
+	std::string guid;
+	OutboxAction action;
+	/// Only used by OutboxAction::UPDATE_FLAGS.
+	std::string oldflags;
+	std::string newflags;
+	/// How many times sending this change has failed.
+	unsigned int attempts;
+};
+
 class Cache {
 public:
 	Cache(const std::string& cachefile, ConfigContainer* c);
@@ -68,6 +90,15 @@ public:
 	void update_lastmodified(const std::string& uri,
 		time_t t,
 		const std::string& etag);
+	/// \brief Returns where the last sync of a remote API feed stopped
+	/// (e.g. the highest article ID seen), and when the whole feed was last
+	/// fetched.
+	void fetch_sync_state(const std::string& feedurl,
+		std::string& token,
+		time_t& last_full_sync);
+	void update_sync_state(const std::string& feedurl,
+		const std::string& token,
+		time_t last_full_sync);
 	void mark_item_deleted(const std::string& guid, bool b);
 	void mark_feed_items_deleted(const std::string& feedurl);
 	void remove_old_deleted_items(RssFeed* feed);
@@ -75,15 +106,59 @@ public:
 	std::vector<std::string> get_read_item_guids();
 	void fetch_descriptions(RssFeed* feed);
 
+	/// \brief Queues up marking \a guid read or unread on \a backend.
+	///
+	/// Replaces any read state change for the same article that hasn't
+	/// been sent yet.
+	void outbox_add_read_state(const std::string& backend,
+		const std::string& guid,
+		bool read);
+	/// \brief Queues up changing the flags of \a guid on \a backend.
+	///
+	/// Changes that are already queued are left alone, even for the same
+	/// article, since they might be being sent right now; RemoteOutbox
+	/// merges them when it sends them.
+	void outbox_add_flags(const std::string& backend,
+		const std::string& guid,
+		const std::string& oldflags,
+		const std::string& newflags);
+	/// \brief Drops the read state changes queued on \a backend for
+	/// articles of \a feedurl.
+	void outbox_remove_read_state(const std::string& backend,
+		const std::string& feedurl);
+	/// \brief Returns queued changes for \a backend that shouldn't be
+	/// postponed any longer at time \a now, oldest first.
+	std::vector<OutboxEntry> outbox_get_due(const std::string& backend,
+		time_t now);
+	/// \brief Returns the time at which the earliest queued change for
+	/// \a backend is due, or nothing if no changes are queued.
+	nonstd::optional<time_t> outbox_next_due(const std::string& backend);
+	void outbox_remove(const std::vector<int64_t>& ids);
+	/// \brief Bumps the attempt counter of the given changes and doesn't
+	/// return them from outbox_get_due() until \a next_attempt.
+	void outbox_postpone(const std::vector<int64_t>& ids, time_t next_attempt);
+
+	/// \brief Returns the feeds subscribed to on \a backend, as last saved
+	/// with set_remote_subscriptions(): URLs with their tags, in order.
+	std::vector<std::pair<std::string, std::vector<std::string>>>
+		get_remote_subscriptions(const std::string& backend);
+	void set_remote_subscriptions(const std::string& backend,
+		const std::vector<std::pair<std::string, std::vector<std::string>>>&
+		subscriptions);
+
 private:
 	SchemaVersion get_schema_version();
 	void populate_tables();
 	void set_pragmas();
 	void delete_item(const std::shared_ptr<RssItem>& item);
 	void clean_old_articles();
+	/// Items whose guid is in \a unsent_read_state keep their read state,
+	/// even if the feed tells otherwise: the server doesn't know about the
+	/// change yet.
 	void update_rssitem_unlocked(std::shared_ptr<RssItem> item,
 		const std::string& feedurl,
-		bool reset_unread);
+		bool reset_unread,
+		const std::unordered_set<std::string>& unsent_read_state);
 
 	std::string prepare_query(const std::string& format);
 	template<typename... Args>
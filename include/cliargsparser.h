@@ -77,6 +77,18 @@ public:
 
 	nonstd::optional<Level> log_level() const;
 
+	nonstd::optional<std::string> trace_file() const;
+
+	/// If non-null, HTTP responses should be recorded into this archive.
+	nonstd::optional<std::string> record_http() const;
+
+	/// If non-null, HTTP responses should be replayed from this archive.
+	nonstd::optional<std::string> replay_http() const;
+
+	/// If `true`, replayed responses should take as long as they did when
+	/// they were recorded.
+	bool replay_http_timing() const;
+
 	/// Returns the pointer to the Rust object.
 	///
 	/// This is only meant to be used in situations when one wants to pass
@@ -14,6 +14,8 @@
 #include "regexmanager.h"
 #include "reloader.h"
 #include "remoteapi.h"
+#include "remoteoutbox.h"
+#include "remotesubscriptions.h"
 #include "rssignores.h"
 #include "urlreader.h"
 
@@ -55,6 +57,15 @@ public:
 	}
 	void enqueue_url(std::shared_ptr<RssItem> item, std::shared_ptr<RssFeed> feed);
 
+	/// \brief Waits until the remote subscriptions have been checked
+	/// against the server, if that's still going on in the background.
+	///
+	/// If they turned out to have changed, and \a apply_changes is `true`,
+	/// the feed list is reloaded. If logging in failed, that's shown to
+	/// the user.
+	///
+	/// Can be called from any thread.
+	void wait_for_subscriptions(bool apply_changes);
 	void reload_urls_file();
 	void edit_urls_file();
 
@@ -128,6 +139,10 @@ private:
 	ColorManager colorman;
 	RegexManager rxman;
 	RemoteApi* api;
+	/// Sends read state and flag changes to `api` in the background.
+	std::unique_ptr<RemoteOutbox> outbox;
+	/// Caches the list of feeds subscribed to on `api`.
+	std::unique_ptr<RemoteSubscriptions> subscriptions;
 	std::mutex feeds_mutex;
 
 	std::unique_ptr<FsLock> fslock;
@@ -0,0 +1,127 @@
+#ifndef PODBOAT_DOWNLOADSCHEDULER_H_
+#define PODBOAT_DOWNLOADSCHEDULER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <curl/curl.h>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "configcontainer.h"
+#include "download.h"
+
+namespace podboat {
+
+enum class DlPriority {
+	NORMAL = 0,
+	/// Started right away, even if that exceeds the number of parallel
+	/// downloads.
+	HIGH
+};
+
+/// \brief Runs podboat's downloads on a single curl multi handle.
+///
+/// Downloads are queued with enqueue(), and started in order of priority,
+/// then in the order they were queued, as long as fewer than
+/// set_max_parallel() of them are running. All transfers are driven by one
+/// background thread, which is the only thing that updates the Download
+/// objects while they're being downloaded.
+///
+/// `max-download-speed` limits the speed of all downloads together. It's
+/// enforced with a token bucket that's refilled every TICK, and split
+/// between the running transfers so that each gets an equal share; what a
+/// slow transfer doesn't use goes to the others. A transfer that used up
+/// its share is paused until the next refill.
+class DownloadScheduler {
+public:
+	explicit DownloadScheduler(newsboat::ConfigContainer* cfg);
+	~DownloadScheduler();
+
+	/// \brief Queues \a dl for download, and marks it as queued.
+	///
+	/// Does nothing if \a dl is already queued or being downloaded, except
+	/// raising its priority.
+	void enqueue(Download* dl, DlPriority priority);
+
+	void set_max_parallel(unsigned int max_parallel);
+
+	/// \brief Forgets the queued downloads and stops the background thread.
+	///
+	/// Transfers that are still running are cancelled. Afterwards, nothing
+	/// refers to the Download objects anymore, so they can be moved or
+	/// destroyed. Queueing another download starts the thread again.
+	void stop();
+
+	/// \brief Splits \a budget bytes between the transfers whose allowances
+	/// are in \a tokens.
+	///
+	/// Each transfer gets an equal share, but none ends up with more than
+	/// \a cap; what doesn't fit is split between the rest. Returns the bytes
+	/// that didn't fit anywhere.
+	static double share_bandwidth(std::vector<double>& tokens,
+		double budget,
+		double cap);
+
+	/// \brief Adds the bytes that \a bytes_per_second allows in \a elapsed
+	/// seconds to the allowances of the running transfers in \a tokens.
+	///
+	/// Each allowance is capped, so that transfers which didn't use it
+	/// can't save up for a burst.
+	static void refill(std::vector<double>& tokens,
+		double bytes_per_second,
+		double elapsed);
+
+	static const std::chrono::milliseconds TICK;
+
+private:
+	struct Transfer;
+	struct QueuedDownload {
+		Download* dl;
+		DlPriority priority;
+		uint64_t order;
+	};
+
+	static size_t write_callback(void* buffer,
+		size_t size,
+		size_t nmemb,
+		void* userp);
+	static int progress_callback(void* clientp,
+		double dltotal,
+		double dlnow,
+		double ultotal,
+		double ulnow);
+
+	void run();
+	void start_queued();
+	/// Both of these have to be called with `mtx` held.
+	bool is_queued(const Download* dl) const;
+	bool has_transfer(const Download* dl) const;
+	bool start_transfer(Download* dl);
+	void finish_transfer(Transfer* transfer, CURLcode result);
+	void refill_tokens();
+
+	newsboat::ConfigContainer* cfg;
+	CURLM* multi_handle;
+
+	/// Only changed by the background thread, with `mtx` held
+	std::vector<std::unique_ptr<Transfer>> transfers;
+	std::chrono::steady_clock::time_point last_refill;
+	double bytes_per_second;
+
+	std::thread thread;
+	std::mutex mtx;
+	std::condition_variable queue_cv;
+	std::vector<QueuedDownload> queue;
+	uint64_t next_order;
+	unsigned int max_parallel;
+	bool stopping;
+};
+
+} // namespace podboat
+
+#endif /* PODBOAT_DOWNLOADSCHEDULER_H_ */
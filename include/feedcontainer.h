@@ -12,6 +12,12 @@ namespace newsboat {
 
 class RssFeed;
 
+struct TagCounts {
+	unsigned int feed_count;
+	unsigned int unread_feed_count;
+	unsigned int unread_item_count;
+};
+
 class FeedContainer {
 public:
 	FeedContainer() = default;
@@ -29,6 +35,13 @@ public:
 	/// Count unread items in feeds tagged with `tag`
 	unsigned int get_unread_item_count_per_tag(const std::string& tag);
 
+	/// Same as the three functions above, but for all `tags` at once;
+	/// element N of the result corresponds to `tags[N]`. This is one pass
+	/// over the feeds, which doesn't look at their items, as
+	/// RssFeed::unread_item_count() is kept up to date by the feeds.
+	std::vector<TagCounts> get_counts_per_tag(
+		const std::vector<std::string>& tags);
+
 	std::shared_ptr<RssFeed> get_feed_by_url(const std::string& feedurl);
 	void populate_query_feeds();
 	unsigned int get_pos_of_next_unread(unsigned int pos);
@@ -14,9 +14,15 @@ public:
 	~FeedHqApi() override;
 	bool authenticate() override;
 	std::vector<TaggedFeedUrl> get_subscribed_urls() override;
+	bool supports_cached_subscriptions() override
+	{
+		return true;
+	}
 	void add_custom_headers(curl_slist** custom_headers) override;
 	bool mark_all_read(const std::string& feedurl) override;
 	bool mark_article_read(const std::string& guid, bool read) override;
+	bool mark_articles_read(const std::vector<std::string>& guids,
+		bool read) override;
 	bool update_article_flags(const std::string& oldflags,
 		const std::string& newflags,
 		const std::string& guid) override;
@@ -29,7 +35,8 @@ private:
 		const std::string& postdata);
 	bool star_article(const std::string& guid, bool star);
 	bool share_article(const std::string& guid, bool share);
-	bool mark_article_read_with_token(const std::string& guid,
+	bool mark_articles_read_with_token(
+		const std::vector<std::string>& guids,
 		bool read,
 		const std::string& token);
 	std::string auth;
@@ -4,6 +4,7 @@
 #include "3rd-party/optional.hpp"
 
 #include "configcontainer.h"
+#include "fmtstrformatter.h"
 #include "history.h"
 #include "listformaction.h"
 #include "listwidget.h"
@@ -74,8 +75,7 @@ private:
 
 	std::string get_title(std::shared_ptr<RssFeed> feed);
 
-	std::string format_line(const std::string& feedlist_format,
-		std::shared_ptr<RssFeed> feed,
+	std::string format_line(std::shared_ptr<RssFeed> feed,
 		unsigned int pos,
 		unsigned int width);
 
@@ -99,6 +99,12 @@ private:
 
 	nonstd::optional<FeedSortStrategy> old_sort_strategy;
 
+	/// Parsed `feedlist-format`, plus the formatter and the buffer that
+	/// format_line() reuses for every line.
+	FmtStrTemplate feedlist_template;
+	FmtStrFormatter line_fmt;
+	std::string line_buffer;
+
 	ListWidget feeds_list;
 };
 
@@ -6,6 +6,33 @@
 
 namespace newsboat {
 
+/// \brief A format string that's parsed once and then used for many lines.
+///
+/// List views format every line with the same format string. Keep a template
+/// around and call set_format() whenever the setting might have changed; the
+/// string is only parsed again if it actually did.
+class FmtStrTemplate {
+public:
+	FmtStrTemplate();
+	~FmtStrTemplate();
+	FmtStrTemplate(const FmtStrTemplate&) = delete;
+	FmtStrTemplate& operator=(const FmtStrTemplate&) = delete;
+
+	void set_format(const std::string& format);
+
+	/// \brief Returns `true` if the format string refers to `key`.
+	///
+	/// Values of other keys are never used, so there's no need to compute
+	/// and register them.
+	bool uses(char key) const;
+
+private:
+	friend class FmtStrFormatter;
+
+	std::string format;
+	void* rs_template = nullptr;
+};
+
 class FmtStrFormatter {
 public:
 	FmtStrFormatter();
@@ -13,6 +40,12 @@ public:
 	void register_fmt(char f, const std::string& value);
 	std::string do_format(const std::string& fmt, unsigned int width = 0);
 
+	/// \brief Same as do_format(), but with a format string that was already
+	/// parsed. The result replaces the contents of `result`, reusing its
+	/// buffer.
+	void do_format(const FmtStrTemplate& tmpl, unsigned int width,
+		std::string& result);
+
 private:
 	void* rs_fmt = nullptr;
 };
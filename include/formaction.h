@@ -52,6 +52,18 @@ public:
 
 	virtual void recalculate_form();
 
+	/// \brief Returns `true` if the formaction has some work it could do
+	/// while the user isn't pressing any keys.
+	virtual bool has_idle_work()
+	{
+		return false;
+	}
+	/// \brief Does a small piece of the work announced by has_idle_work().
+	///
+	/// Called by View when no input arrived for a moment, so it shouldn't
+	/// take long: any keypress has to wait until it returns.
+	virtual void do_idle_work() {}
+
 	std::string get_qna_response(unsigned int i)
 	{
 		return (qna_responses.size() >= (i + 1)) ? qna_responses[i]
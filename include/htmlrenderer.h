@@ -2,8 +2,8 @@
 #define NEWSBOAT_HTMLRENDERER_H_
 
 #include <istream>
-#include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "textformatter.h"
@@ -118,7 +118,10 @@ private:
 	std::string absolute_url(const std::string& url,
 		const std::string& link);
 	std::string type2str(LinkType type);
-	std::map<std::string, HtmlTag> tags;
+	/// Maps the links added during the current render() to their numbers,
+	/// which are 1-based positions in `links`.
+	std::unordered_map<std::string, unsigned int> link_numbers;
+	std::size_t indexed_links;
 	void render_table(const Table& table,
 		std::vector<std::pair<LineType, std::string>>& lines);
 	void add_nonempty_line(const std::string& curline,
@@ -15,9 +15,15 @@ public:
 	virtual ~InoreaderApi();
 	virtual bool authenticate();
 	virtual std::vector<TaggedFeedUrl> get_subscribed_urls();
+	virtual bool supports_cached_subscriptions()
+	{
+		return true;
+	}
 	virtual void add_custom_headers(curl_slist** custom_headers);
 	virtual bool mark_all_read(const std::string& feedurl);
 	virtual bool mark_article_read(const std::string& guid, bool read);
+	virtual bool mark_articles_read(const std::vector<std::string>& guids,
+		bool read);
 	virtual bool update_article_flags(const std::string& inoflags,
 		const std::string& newflags,
 		const std::string& guid);
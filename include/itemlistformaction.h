@@ -5,6 +5,7 @@
 
 #include "3rd-party/optional.hpp"
 
+#include "fmtstrformatter.h"
 #include "history.h"
 #include "listformaction.h"
 #include "listformatter.h"
@@ -53,6 +54,10 @@ public:
 		pos = p;
 	}
 	std::string get_guid();
+	/// \brief Returns up to \a count items on either side of the selected
+	/// one, closest first, alternating between the next and previous ones.
+	std::vector<std::shared_ptr<RssItem>> get_neighbouring_items(
+			unsigned int count);
 	KeyMapHintEntry* get_keymap_hint() override;
 
 	bool jump_to_next_unread_item(bool start_with_first);
@@ -122,7 +127,6 @@ private:
 
 	std::string item2formatted_line(const ItemPtrPosPair& item,
 		const unsigned int width,
-		const std::string& itemlist_format,
 		const std::string& datetime_format);
 
 	unsigned int pos;
@@ -145,6 +149,8 @@ private:
 	RegexManager& rxman;
 
 	unsigned int old_width;
+	std::string old_itemlist_format;
+	std::string old_datetime_format;
 	int old_itempos;
 	nonstd::optional<ArticleSortStrategy> old_sort_strategy;
 
@@ -152,6 +158,13 @@ private:
 	std::vector<unsigned int> invalidated_itempos;
 
 	ListFormatter listfmt;
+
+	/// Parsed `articlelist-format`, plus the formatter and the buffer that
+	/// item2formatted_line() reuses for every line.
+	FmtStrTemplate itemlist_template;
+	FmtStrFormatter line_fmt;
+	std::string line_buffer;
+
 	Cache* rsscache;
 	FilterContainer& filters;
 
@@ -0,0 +1,95 @@
+#ifndef NEWSBOAT_ITEMRENDERCACHE_H_
+#define NEWSBOAT_ITEMRENDERCACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "htmlrenderer.h"
+
+namespace newsboat {
+
+class ConfigContainer;
+class RegexManager;
+class RssItem;
+
+/// \brief Keeps a few recently rendered articles around.
+///
+/// Rendering an article (HTML rendering, wrapping and highlighting) is the
+/// most expensive thing the article view does, and it used to be redone every
+/// time an article was opened. Entries are keyed by everything that affects
+/// the result, so a stale rendering is never returned: the article's contents,
+/// the widths, the `html-renderer` setting, the highlighting rules and the
+/// links the caller started with (they affect how links are numbered).
+class ItemRenderCache {
+public:
+	explicit ItemRenderCache(std::size_t capacity);
+
+	/// \brief Same as item_renderer::to_stfl_list(), but returns a cached
+	/// result if one is available.
+	///
+	/// Like to_stfl_list(), it renders the links that are already in
+	/// \a links as part of the article, and adds the article's own after
+	/// them.
+	std::pair<std::string, std::size_t> get_stfl_list(
+		ConfigContainer& cfg,
+		std::shared_ptr<RssItem> item,
+		unsigned int text_width,
+		unsigned int window_width,
+		RegexManager& rxman,
+		const std::string& location,
+		std::vector<LinkPair>& links);
+
+	/// \brief Returns `true` if get_stfl_list() with these arguments would
+	/// be answered from the cache.
+	bool contains(ConfigContainer& cfg,
+		std::shared_ptr<RssItem> item,
+		unsigned int text_width,
+		unsigned int window_width,
+		RegexManager& rxman,
+		const std::string& location,
+		const std::vector<LinkPair>& links) const;
+
+	void clear();
+
+private:
+	struct Key {
+		std::string guid;
+		std::size_t content_hash;
+		unsigned int text_width;
+		unsigned int window_width;
+		std::string location;
+		std::string html_renderer;
+		std::uint64_t rules_version;
+		std::vector<LinkPair> initial_links;
+
+		bool operator==(const Key& other) const;
+	};
+
+	struct Entry {
+		Key key;
+		std::string formatted_text;
+		std::size_t num_lines;
+		/// Including the initial ones
+		std::vector<LinkPair> links;
+	};
+
+	static Key make_key(ConfigContainer& cfg,
+		const std::shared_ptr<RssItem>& item,
+		unsigned int text_width,
+		unsigned int window_width,
+		const RegexManager& rxman,
+		const std::string& location,
+		const std::vector<LinkPair>& links);
+
+	/// Most recently used entries come first.
+	std::list<Entry> entries;
+	const std::size_t capacity;
+};
+
+} // namespace newsboat
+
+#endif /* NEWSBOAT_ITEMRENDERCACHE_H_ */
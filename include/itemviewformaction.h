@@ -1,8 +1,11 @@
 #ifndef NEWSBOAT_ITEMVIEWFORMACTION_H_
 #define NEWSBOAT_ITEMVIEWFORMACTION_H_
 
+#include <deque>
+
 #include "formaction.h"
 #include "htmlrenderer.h"
+#include "itemrendercache.h"
 #include "regexmanager.h"
 #include "textformatter.h"
 #include "textviewwidget.h"
@@ -20,7 +23,8 @@ public:
 		std::string formstr,
 		Cache* cc,
 		ConfigContainer* cfg,
-		RegexManager& r);
+		RegexManager& r,
+		ItemRenderCache& rc);
 	~ItemViewFormAction() override;
 	void prepare() override;
 	void init() override;
@@ -52,6 +56,9 @@ public:
 
 	void update_percent();
 
+	bool has_idle_work() override;
+	void do_idle_work() override;
+
 private:
 	void register_format_styles();
 
@@ -82,6 +89,12 @@ private:
 	bool in_search;
 	Cache* rsscache;
 	TextviewWidget textview;
+	ItemRenderCache& render_cache;
+	/// Articles around the current one, to be rendered in advance while
+	/// the user is reading.
+	std::deque<std::shared_ptr<RssItem>> prerender_queue;
+	unsigned int last_text_width;
+	unsigned int last_window_width;
 };
 
 } // namespace newsboat
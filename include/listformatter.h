@@ -25,9 +25,19 @@ public:
 		const std::string& text,
 		const std::string& id = "",
 		unsigned int width = 0);
+
+	/// \brief Adds an empty line that is meant to be filled in later with
+	/// set_line(), once it scrolls into view.
+	void add_placeholder(const std::string& id = "");
+	bool is_placeholder(const unsigned int itempos) const
+	{
+		return itempos < placeholders.size() && placeholders[itempos];
+	}
+
 	void clear()
 	{
 		lines.clear();
+		placeholders.clear();
 	}
 	std::string format_list() const;
 	unsigned int get_lines_count() const
@@ -37,6 +47,7 @@ public:
 
 private:
 	std::vector<LineIdPair> lines;
+	std::vector<bool> placeholders;
 	RegexManager* rxman;
 	std::string location;
 };
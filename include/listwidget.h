@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 
 #include "listformatter.h"
 #include "stflpp.h"
@@ -28,6 +29,23 @@ public:
 
 	std::uint32_t get_width();
 	std::uint32_t get_height();
+
+	/// \brief Range [first, last) of lines that might be on screen if the
+	/// list had `line_count` lines, widened by `margin` lines on each side.
+	///
+	/// Lists with lots of lines can format just these, and leave the rest as
+	/// placeholders (see ListFormatter::add_placeholder()).
+	std::pair<std::uint32_t, std::uint32_t> get_visible_range(
+		std::uint32_t line_count,
+		std::uint32_t margin);
+
+	/// \brief Does the work of get_visible_range() for a list that is
+	/// `height` lines high (0 if unknown) and has line `position` selected.
+	static std::pair<std::uint32_t, std::uint32_t> visible_range(
+		std::uint32_t line_count,
+		std::uint32_t position,
+		std::uint32_t height,
+		std::uint32_t margin);
 private:
 	const std::string list_name;
 	Stfl::Form& form;
@@ -10,7 +10,8 @@ enum class Level;
 
 extern "C" {
 	uint64_t rs_get_loglevel();
-	void rs_log(newsboat::Level level, const char* message);
+	void rs_log(newsboat::Level level, const char* message,
+		std::size_t message_len);
 }
 
 namespace newsboat {
@@ -28,7 +29,8 @@ void log(Level l, const std::string& format, Args... args)
 {
 	if (l == Level::USERERROR
 		|| static_cast<uint64_t>(l) <= rs_get_loglevel()) {
-		rs_log(l, strprintf::fmt(format, args...).c_str());
+		const auto message = strprintf::fmt(format, args...);
+		rs_log(l, message.data(), message.size());
 	}
 }
 };
@@ -2,6 +2,7 @@
 #define NEWSBOAT_NEWSBLURAPI_H_
 
 #include <json.h>
+#include <memory>
 
 #include "remoteapi.h"
 #include "rss/feed.h"
@@ -21,20 +22,42 @@ public:
 	void add_custom_headers(curl_slist** custom_headers) override;
 	bool mark_all_read(const std::string& feedurl) override;
 	bool mark_article_read(const std::string& guid, bool read) override;
+	bool mark_articles_read(const std::vector<std::string>& guids,
+		bool read) override;
 	bool update_article_flags(const std::string& oldflags,
 		const std::string& newflags,
 		const std::string& guid) override;
-	rsspp::Feed fetch_feed(const std::string& id);
+	/// \brief Fetches stories of feed \a id.
+	///
+	/// Pages are requested in parallel, up to MAX_PARALLEL_PAGES at a time.
+	/// If \a sync_token isn't empty, the first page is requested alone,
+	/// and paging stops at the first page that reaches back to stories
+	/// published at or before it. On success, \a sync_token is set to the
+	/// publication time of the newest story; if any page fails, the
+	/// returned feed's rss_version is UNKNOWN.
+	rsspp::Feed fetch_feed(const std::string& id, std::string& sync_token);
 	// TODO
 private:
 	std::string retrieve_auth();
 	json_object* query_api(const std::string& url,
 		const std::string* postdata);
+	/// \brief Requests pages \a first to \a last of feed \a id at once.
+	///
+	/// Returns them in order; pages that couldn't be fetched are null.
+	std::vector<std::shared_ptr<json_object>> fetch_pages(
+			const std::string& id,
+			unsigned int first,
+			unsigned int last);
+	bool parse_stories(const std::shared_ptr<json_object>& page,
+		const std::string& id,
+		std::vector<rsspp::Item>& items);
 	std::map<std::string, std::vector<std::string>> mk_feeds_to_tags(
 			json_object*);
 	std::string api_location;
 	FeedMap known_feeds;
 	unsigned int min_pages;
+
+	static const unsigned int MAX_PARALLEL_PAGES = 8;
 };
 
 } // namespace newsboat
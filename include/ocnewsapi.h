@@ -17,15 +17,29 @@ public:
 	std::vector<TaggedFeedUrl> get_subscribed_urls() override;
 	bool mark_all_read(const std::string& feedurl) override;
 	bool mark_article_read(const std::string& guid, bool read) override;
+	bool mark_articles_read(const std::vector<std::string>& guids,
+		bool read) override;
 	bool update_article_flags(const std::string& oldflags,
 		const std::string& newflags,
 		const std::string& guid) override;
 	void add_custom_headers(curl_slist**) override;
-	rsspp::Feed fetch_feed(const std::string& feed_id);
+	/// \brief Fetches items of feed \a feed_id.
+	///
+	/// If \a sync_token isn't empty, only items that were added or changed
+	/// (e.g. marked read) since that time are fetched, or taken from what
+	/// prefetch_feeds() got. On success, \a sync_token is set to the newest
+	/// modification time seen; on failure, the returned feed's rss_version
+	/// is UNKNOWN.
+	rsspp::Feed fetch_feed(const std::string& feed_id,
+		std::string& sync_token);
+	bool prefetch_feeds(const std::string& since) override;
 
 private:
 	typedef std::map<std::string, std::pair<rsspp::Feed, long>> FeedMap;
 	std::string retrieve_auth();
+	rsspp::Item item_from_json(json_object* item_j,
+		long& feed_id,
+		int64_t& newest);
 	bool query(const std::string& query,
 		json_object** result = nullptr,
 		const std::string& post = "");
@@ -7,6 +7,7 @@
 
 #include "configcontainer.h"
 #include "download.h"
+#include "downloadscheduler.h"
 #include "fslock.h"
 #include "queueloader.h"
 
@@ -45,7 +46,12 @@ public:
 	void purge_queue();
 
 	unsigned int get_maxdownloads();
+	/// \brief Queues all downloads that are waiting, to be started as
+	/// soon as fewer than get_maxdownloads() are running.
 	void start_downloads();
+	/// \brief Starts \a dl right away, even if that exceeds
+	/// get_maxdownloads().
+	void start_download(Download& dl);
 
 	void increase_parallel_downloads();
 	void decrease_parallel_downloads();
@@ -77,6 +83,7 @@ private:
 	std::string cmdlinefile;
 
 	unsigned int max_dls;
+	std::unique_ptr<DownloadScheduler> scheduler;
 
 	QueueLoader* ql;
 
@@ -1,11 +1,15 @@
 #ifndef NEWSBOAT_REGEXMANAGER_H_
 #define NEWSBOAT_REGEXMANAGER_H_
 
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <regex>
 #include <regex.h>
 #include <string>
 #include <sys/types.h>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -31,6 +35,13 @@ public:
 		size_t start, size_t end);
 	std::string get_attrs_stfl_string(const std::string& location, bool hasFocus);
 
+	/// \brief Returns a number that changes every time a highlighting rule
+	/// is added or removed.
+	std::uint64_t get_rules_version() const
+	{
+		return rules_version;
+	}
+
 private:
 	typedef std::vector<std::pair<std::shared_ptr<Regex>, std::string>>
 		RegexStyleVector;
@@ -38,6 +49,14 @@ private:
 	std::vector<std::string> cheat_store_for_dump_config;
 	std::vector<std::pair<std::shared_ptr<Matcher>, int>> matchers;
 
+	/// Results of quote_and_highlight() for each location, keyed by input.
+	/// Lists re-highlight the same lines on every redraw.
+	std::map<std::string, std::unordered_map<std::string, std::string>>
+		highlight_cache;
+	std::mutex highlight_cache_mutex;
+	std::uint64_t rules_version;
+	void rules_changed();
+
 	void handle_highlight_action(const std::vector<std::string>& params);
 	void handle_highlight_article_action(
 		const std::vector<std::string>& params);
@@ -19,7 +19,11 @@ public:
 
 	static std::unique_ptr<Regex> compile(std::string reg_expression,
 		int regcomp_flags, std::string& error);
-	std::vector<std::pair<int, int>> matches(std::string input, int max_matches,
+	std::vector<std::pair<int, int>> matches(const std::string& input,
+			int max_matches, int flags) const;
+	/// Same as above, but lets callers match the tail of a string without
+	/// copying it.
+	std::vector<std::pair<int, int>> matches(const char* input, int max_matches,
 			int flags) const;
 
 private:
@@ -86,6 +86,10 @@ private:
 	void notify_reload_finished(unsigned int unread_feeds_before,
 		unsigned int unread_articles_before);
 
+	/// \brief Lets the remote API fetch new articles of all feeds at once,
+	/// so that reloading them doesn't need a request per feed.
+	void prefetch_remote_feeds(bool unattended);
+
 	Controller* ctrl;
 	Cache* rsscache;
 	ConfigContainer* cfg;
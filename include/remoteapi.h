@@ -2,11 +2,14 @@
 #define NEWSBOAT_REMOTEAPI_H_
 
 #include <curl/curl.h>
+#include <map>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "configcontainer.h"
+#include "rss/item.h"
 
 namespace newsboat {
 
@@ -26,12 +29,49 @@ public:
 	virtual ~RemoteApi() {}
 	virtual bool authenticate() = 0;
 	virtual std::vector<TaggedFeedUrl> get_subscribed_urls() = 0;
+	/// \brief Whether feeds can be fetched knowing nothing but their URLs,
+	/// i.e. get_subscribed_urls() doesn't set up anything that fetching
+	/// relies on.
+	///
+	/// Only such backends can start from subscriptions saved in the cache
+	/// while the real ones are still being requested.
+	virtual bool supports_cached_subscriptions()
+	{
+		return false;
+	}
+	/// \brief Makes the next get_subscriptions() call return \a urls
+	/// instead of asking the server.
+	void set_subscriptions(std::vector<TaggedFeedUrl> urls);
+	/// \brief Returns the subscriptions passed to set_subscriptions(), or
+	/// if there are none, those returned by get_subscribed_urls().
+	std::vector<TaggedFeedUrl> get_subscriptions();
 	virtual void add_custom_headers(curl_slist** custom_headers) = 0;
 	virtual bool mark_all_read(const std::string& feedurl) = 0;
 	virtual bool mark_article_read(const std::string& guid, bool read) = 0;
+	/// \brief Marks several articles read or unread.
+	///
+	/// Backends that can change many articles in one request override this;
+	/// the default makes one mark_article_read() call per article. Unlike
+	/// mark_article_read(), this always blocks until the server replied.
+	virtual bool mark_articles_read(const std::vector<std::string>& guids,
+		bool read);
 	virtual bool update_article_flags(const std::string& oldflags,
 		const std::string& newflags,
 		const std::string& guid) = 0;
+	/// \brief Fetches new articles of all subscribed feeds at once.
+	///
+	/// Backends that can return articles of many feeds in one request
+	/// override this to fetch everything newer than \a since (a sync token
+	/// as used by their fetch_feed()) in a few paged requests. The articles
+	/// are kept until fetch_feed() hands them out, or until
+	/// drop_prefetched() is called. Returns `false` if the backend doesn't
+	/// support this or the requests failed; feeds are then fetched one by
+	/// one as usual.
+	virtual bool prefetch_feeds(const std::string& /* since */)
+	{
+		return false;
+	}
+	void drop_prefetched();
 	static const std::string read_password(const std::string& file);
 	static const std::string eval_password(const std::string& cmd);
 	// TODO
@@ -39,6 +79,32 @@ protected:
 	ConfigContainer* cfg;
 	Credentials get_credentials(const std::string& scope,
 		const std::string& name);
+
+	/// \brief Keeps articles fetched by prefetch_feeds(), grouped by feed
+	/// ID. \a sync_token is where the bulk fetch stopped.
+	void store_prefetched(std::map<std::string, std::vector<rsspp::Item>> items,
+		const std::string& sync_token);
+	/// \brief Moves the prefetched articles of \a feed_id (possibly none)
+	/// into \a items, and advances \a sync_token to where the bulk fetch
+	/// stopped.
+	///
+	/// Returns `false` if nothing was prefetched.
+	bool take_prefetched(const std::string& feed_id,
+		std::vector<rsspp::Item>& items,
+		std::string& sync_token);
+	/// \brief Advances \a sync_token to where the bulk fetch stopped, if
+	/// there was one. Used for feeds that were fetched on their own anyway.
+	void skip_prefetched(std::string& sync_token);
+
+private:
+	std::mutex subscriptions_mtx;
+	bool has_subscriptions = false;
+	std::vector<TaggedFeedUrl> subscriptions;
+
+	std::mutex prefetch_mtx;
+	bool has_prefetched = false;
+	std::map<std::string, std::vector<rsspp::Item>> prefetched;
+	std::string prefetched_token;
 };
 
 } // namespace newsboat
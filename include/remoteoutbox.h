@@ -0,0 +1,82 @@
+#ifndef NEWSBOAT_REMOTEOUTBOX_H_
+#define NEWSBOAT_REMOTEOUTBOX_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace newsboat {
+
+class Cache;
+class RemoteApi;
+
+/// \brief Sends read state and flag changes to a remote API in the
+/// background.
+///
+/// Changes are first written to the `remote_outbox` table of the cache, so
+/// marking an article read never waits for the network and changes survive
+/// a restart. A background thread then sends them in batches: read and
+/// unread changes go out through RemoteApi::mark_articles_read(), at most
+/// MAX_BATCH_SIZE articles per request. If a request fails, its changes are
+/// retried later with an exponential backoff.
+class RemoteOutbox {
+public:
+	/// \a backend is the value of `urls-source`. Changes queued for other
+	/// backends are left alone.
+	RemoteOutbox(Cache* cache, RemoteApi* api, const std::string& backend);
+	~RemoteOutbox();
+
+	/// \brief Starts the background thread.
+	void start();
+
+	/// \brief Stops the background thread. Changes that are due are sent
+	/// one last time before it exits; the rest stay in the cache.
+	void stop();
+
+	void mark_article_read(const std::string& guid, bool read);
+	void update_article_flags(const std::string& oldflags,
+		const std::string& newflags,
+		const std::string& guid);
+
+	/// \brief Marks all articles of \a feedurl read on the server, right
+	/// away.
+	///
+	/// Read state changes queued for the feed's articles are dropped, since
+	/// this supersedes them. If some of them are being sent at the moment,
+	/// this waits until they're done, so they can't arrive after it.
+	bool mark_all_read(const std::string& feedurl);
+
+	/// \brief Sends all changes that are due at time \a now.
+	///
+	/// Returns `true` if all of them were accepted by the server.
+	bool flush(time_t now);
+
+	/// \brief How long to wait before retrying a change that failed
+	/// \a attempts times already.
+	static std::chrono::seconds backoff(unsigned int attempts);
+
+	static const std::size_t MAX_BATCH_SIZE = 100;
+
+private:
+	void run();
+
+	Cache* cache;
+	RemoteApi* api;
+	const std::string backend;
+
+	/// Held while talking to the server
+	std::mutex send_mtx;
+
+	std::thread thread;
+	std::mutex mtx;
+	std::condition_variable changes_cv;
+	bool changes_queued;
+	bool stopping;
+};
+
+} // namespace newsboat
+
+#endif /* NEWSBOAT_REMOTEOUTBOX_H_ */
@@ -0,0 +1,81 @@
+#ifndef NEWSBOAT_REMOTESUBSCRIPTIONS_H_
+#define NEWSBOAT_REMOTESUBSCRIPTIONS_H_
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "remoteapi.h"
+
+namespace newsboat {
+
+class Cache;
+
+/// \brief Keeps the list of feeds subscribed to on a remote API in the
+/// cache, so that startup doesn't have to wait for the server.
+///
+/// On startup, use_cached() hands the list saved during the previous run to
+/// the API, and start_revalidation() then logs in and requests the current
+/// list in a background thread. The server is only contacted again once
+/// that's done: wait_for_revalidation() blocks until then, after which
+/// subscriptions_changed() tells whether the cached list was out of date.
+class RemoteSubscriptions {
+public:
+	/// \a backend is the value of `urls-source`. Each backend has its own
+	/// list.
+	RemoteSubscriptions(Cache* cache,
+		RemoteApi* api,
+		const std::string& backend);
+	~RemoteSubscriptions();
+
+	/// \brief Makes the API return the subscriptions saved during the
+	/// previous run.
+	///
+	/// Returns `false` if the API doesn't support that, or nothing was
+	/// saved yet.
+	bool use_cached();
+
+	/// \brief Logs in and requests the current subscriptions, saves them in
+	/// the cache and hands them to the API.
+	///
+	/// Returns `false` if authentication failed.
+	bool revalidate();
+
+	/// \brief Runs revalidate() in a background thread, followed by
+	/// \a then.
+	///
+	/// \a then is for whatever else needs the API to be logged in first,
+	/// and is called even if logging in failed.
+	void start_revalidation(std::function<void()> then);
+
+	/// \brief Waits until the background revalidation is finished.
+	void wait_for_revalidation();
+
+	/// \brief Returns `true` if the server's subscriptions turned out to
+	/// differ from the cached ones, and this is the first call since then.
+	bool subscriptions_changed();
+
+	/// \brief Returns `true` if the background revalidation couldn't log
+	/// in, and this is the first call since then.
+	bool authentication_failed();
+
+private:
+	Cache* cache;
+	RemoteApi* api;
+	const std::string backend;
+	std::vector<TaggedFeedUrl> cached;
+
+	std::thread thread;
+	std::mutex mtx;
+	std::condition_variable done_cv;
+	bool revalidating;
+	bool changed;
+	bool auth_failed;
+};
+
+} // namespace newsboat
+
+#endif /* NEWSBOAT_REMOTESUBSCRIPTIONS_H_ */
@@ -1,19 +1,30 @@
 #ifndef NEWSBOAT_RS_UTILS_H_
 #define NEWSBOAT_RS_UTILS_H_
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rs_write_str.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-struct FilterUrl {
+typedef struct FilterUrl {
 	char* filter;
 	char* url;
-};
+} FilterUrl;
 
-char* rs_replace_all(
+void rs_replace_all(
 	const char* str,
+	size_t str_len,
 	const char* from,
-	const char* to);
+	size_t from_len,
+	const char* to,
+	size_t to_len,
+	void* out,
+	rs_write_str_fn write);
 
 char* rs_consolidate_whitespace(const char* str);
 
@@ -35,13 +46,17 @@ bool rs_is_filter_url(const char* str);
 
 bool rs_is_exec_url(const char* str);
 
-char* rs_censor_url(const char* str);
+void rs_censor_url(const char* str, size_t str_len, void* out,
+	rs_write_str_fn write);
 
-char* rs_quote_for_stfl(const char* str);
+void rs_quote_for_stfl(const char* str, size_t str_len, void* out,
+	rs_write_str_fn write);
 
-char* rs_trim(const char* str);
+void rs_trim(const char* str, size_t str_len, void* out,
+	rs_write_str_fn write);
 
-char* rs_trim_end(const char* str);
+void rs_trim_end(const char* str, size_t str_len, void* out,
+	rs_write_str_fn write);
 
 char* rs_quote(const char* str);
 
@@ -59,7 +74,8 @@ int32_t rs_run_interactively(const char* command, const char* caller);
 
 char* rs_getcwd();
 
-int rs_strnaturalcmp(const char* a, const char* b);
+int rs_strnaturalcmp(const char* a, size_t a_len, const char* b,
+	size_t b_len);
 
 char* rs_get_default_browser();
 
@@ -67,19 +83,21 @@ bool rs_is_valid_color(const char* str);
 
 bool rs_is_valid_attribute(const char* attribute);
 
-size_t rs_strwidth(const char* str);
+size_t rs_strwidth(const char* str, size_t str_len);
 
-size_t rs_strwidth_stfl(const char* str);
+size_t rs_strwidth_stfl(const char* str, size_t str_len);
 
-char* rs_substr_with_width(const char* str, size_t max_width);
+void rs_substr_with_width(const char* str, size_t str_len,
+	size_t max_width, void* out, rs_write_str_fn write);
 
-char* rs_substr_with_width_stfl(const char* str, size_t max_width);
+void rs_substr_with_width_stfl(const char* str, size_t str_len,
+	size_t max_width, void* out, rs_write_str_fn write);
 
 char* rs_remove_soft_hyphens(const char* str);
 
 bool rs_is_valid_podcast_type(const char* mimetype);
 
-std::int64_t rs_podcast_mime_to_link_type(const char* mimetype, bool* success);
+int64_t rs_podcast_mime_to_link_type(const char* mimetype, bool* success);
 
 char* rs_get_command_output(const char* str);
 
@@ -95,7 +113,7 @@ unsigned int rs_newsboat_version_major();
 
 unsigned int rs_gentabs(const char* path);
 
-int rs_mkdir_parents(const char* path, const std::uint32_t mode);
+int rs_mkdir_parents(const char* path, const uint32_t mode);
 
 char* rs_strip_comments(const char* line);
 
@@ -0,0 +1,19 @@
+#ifndef NEWSBOAT_RS_WRITE_STR_H_
+#define NEWSBOAT_RS_WRITE_STR_H_
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Signature of the callback through which Rust functions return strings
+/// into a buffer provided by the caller. C++ code passes
+/// assign_to_std_string() from ruststring.h.
+typedef void (*rs_write_str_fn)(void* out, const char* data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NEWSBOAT_RS_WRITE_STR_H_ */
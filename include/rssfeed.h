@@ -1,6 +1,8 @@
 #ifndef NEWSBOAT_RSSFEED_H_
 #define NEWSBOAT_RSSFEED_H_
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -68,15 +70,19 @@ public:
 	}
 	void add_item(std::shared_ptr<RssItem> item)
 	{
+		track_item(item);
 		items_.push_back(item);
+		item_count_ = items_.size();
 		items_guid_map[item->guid()] = item;
 	}
 	void add_items(const std::vector<std::shared_ptr<RssItem>>& items)
 	{
 		for (const auto& item : items) {
+			track_item(item);
 			items_.push_back(item);
 			items_guid_map[item->guid()] = item;
 		}
+		item_count_ = items_.size();
 	}
 	void set_items(std::vector<std::shared_ptr<RssItem>>& items)
 	{
@@ -87,22 +93,33 @@ public:
 	void clear_items()
 	{
 		LOG(Level::DEBUG, "RssFeed: clearing items");
+		for (const auto& item : items_) {
+			untrack_item(item);
+		}
 		items_.clear();
+		item_count_ = 0;
 		items_guid_map.clear();
+		newest_item_pubdate_ = 0;
 	}
 
 	void erase_items(std::vector<std::shared_ptr<RssItem>>::iterator begin,
 		std::vector<std::shared_ptr<RssItem>>::iterator end)
 	{
 		for (auto it = begin; it != end; ++it) {
+			untrack_item(*it);
 			items_guid_map.erase((*it)->guid());
 		}
 		items_.erase(begin, end);
+		item_count_ = items_.size();
+		update_newest_item_pubdate();
 	}
 	void erase_item(std::vector<std::shared_ptr<RssItem>>::iterator pos)
 	{
+		untrack_item(*pos);
 		items_guid_map.erase((*pos)->guid());
 		items_.erase(pos);
+		item_count_ = items_.size();
+		update_newest_item_pubdate();
 	}
 
 	std::shared_ptr<RssItem> get_item_by_guid(const std::string& guid);
@@ -123,6 +140,22 @@ public:
 		return items_.size();
 	}
 
+	/// \brief Publication date of the newest item, or 0 if there are none.
+	time_t newest_item_pubdate() const
+	{
+		return newest_item_pubdate_;
+	}
+
+	/// \brief Updates the unread counter after an item this feed keeps
+	/// track of (see RssItem::set_unread()) changed its unread status.
+	void item_unread_changed(bool unread);
+
+	/// \brief Updates newest_item_pubdate() after an item this feed keeps
+	/// track of got publication date \a pubdate. Only ever moves the date
+	/// forward; an item that becomes older is accounted for the next time
+	/// items are removed.
+	void item_pubdate_changed(time_t pubdate);
+
 	void set_tags(const std::vector<std::string>& tags);
 	bool matches_tag(const std::string& tag);
 	std::string get_tags();
@@ -208,6 +241,10 @@ public:
 	std::mutex item_mutex;
 
 private:
+	void track_item(const std::shared_ptr<RssItem>& item);
+	void untrack_item(const std::shared_ptr<RssItem>& item);
+	void update_newest_item_pubdate();
+
 	std::string title_;
 	std::string description_;
 	std::string link_;
@@ -227,6 +264,25 @@ private:
 	unsigned int order;
 	std::mutex items_guid_map_mutex;
 
+	/// Items whose unread status is accounted for in `unread_count_`. Items
+	/// are only tracked by one feed at a time, so for query feeds (which
+	/// share their items with regular feeds) this is usually less than the
+	/// number of items, and unread_item_count() has to count them.
+	std::atomic<unsigned int> tracked_items_;
+	std::atomic<unsigned int> unread_count_;
+	/// Copy of `items_.size()`, which unread_item_count() can read without
+	/// taking `item_mutex`. Kept up to date by add_item(), erase_items()
+	/// and the other functions that add or remove items.
+	std::atomic<unsigned int> item_count_;
+
+	/// Result of the last count done by unread_item_count(), and the value
+	/// of RssItem::unread_generation() at the time. Atomic because
+	/// track_item() and untrack_item() reset the latter without holding
+	/// `item_mutex`.
+	std::atomic<unsigned int> counted_unread_;
+	std::atomic<std::uint64_t> counted_generation_;
+	std::atomic<time_t> newest_item_pubdate_;
+
 	DlStatus status_;
 	std::mutex status_mutex_;
 };
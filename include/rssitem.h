@@ -1,7 +1,10 @@
 #ifndef NEWSBOAT_RSSITEM_H_
 #define NEWSBOAT_RSSITEM_H_
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "matchable.h"
@@ -36,6 +39,16 @@ public:
 	}
 	void set_author(const std::string& a);
 
+	/// \brief Title converted to the current locale.
+	///
+	/// Conversion is done once and the result is cached until the title
+	/// changes, so this is cheap enough to be used as a sort key.
+	std::string title_sort_key() const;
+
+	/// \brief Author converted to the current locale; cached like
+	/// title_sort_key().
+	std::string author_sort_key() const;
+
 	std::string description() const
 	{
 		return description_;
@@ -76,6 +89,13 @@ public:
 	void set_unread_nowrite(bool u);
 	void set_unread_nowrite_notify(bool u, bool notify);
 
+	/// \brief Number that changes whenever any item changes its unread
+	/// status. Never 0.
+	static std::uint64_t unread_generation()
+	{
+		return unread_generation_;
+	}
+
 	void set_cache(Cache* c)
 	{
 		ch = c;
@@ -174,6 +194,10 @@ public:
 	}
 
 private:
+	friend class RssFeed;
+
+	void set_unread_and_notify_tracking_feed(bool u);
+
 	std::string title_;
 	std::string link_;
 	std::string author_;
@@ -194,6 +218,21 @@ private:
 	bool enqueued_;
 	bool deleted_;
 	bool override_unread_;
+
+	/// Feed whose unread counter accounts for this item, if any. Managed
+	/// by RssFeed.
+	RssFeed* tracking_feed_;
+
+	/// Guards `tracking_feed_` of all items, so that a feed can't be
+	/// destroyed or stop tracking an item while that item notifies it.
+	/// Shared by all items, as a mutex each would make them much bigger.
+	static std::mutex tracking_mutex_;
+
+	static std::atomic<std::uint64_t> unread_generation_;
+
+	mutable std::mutex sort_keys_mutex_;
+	mutable nonstd::optional<std::string> title_sort_key_;
+	mutable nonstd::optional<std::string> author_sort_key_;
 };
 
 } // namespace newsboat
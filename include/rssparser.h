@@ -31,6 +31,14 @@ public:
 	std::shared_ptr<RssFeed> parse();
 	bool check_and_update_lastmodified();
 
+	/// \brief Returns where the last sync of remote API feed \a uri
+	/// stopped, or an empty string if the whole feed should be fetched
+	/// (because it never was, or `remote-full-sync-interval` has passed).
+	static std::string get_sync_token(const std::string& uri,
+		Cache* c,
+		ConfigContainer* cfg,
+		time_t& last_full_sync);
+
 	void set_easyhandle(CurlHandle* h)
 	{
 		easyhandle = h;
@@ -75,6 +83,11 @@ private:
 	void fetch_ttrss(const std::string& feed_id);
 	void fetch_newsblur(const std::string& feed_id);
 	void fetch_ocnews(const std::string& feed_id);
+	std::string load_sync_token();
+	/// \brief Records how far the fetch that just finished got; does
+	/// nothing if it failed.
+	void store_sync_token(const std::string& old_token,
+		const std::string& new_token);
 
 	std::string my_uri;
 	Cache* ch;
@@ -85,6 +98,11 @@ private:
 	bool is_ttrss;
 	bool is_newsblur;
 	bool is_ocnews;
+	bool is_greader;
+	time_t last_full_sync;
+	/// \brief Whether the remote API was asked only for articles changed
+	/// since the last sync.
+	bool incremental_sync;
 
 	CurlHandle* easyhandle;
 };
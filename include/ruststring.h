@@ -1,8 +1,26 @@
 #ifndef NEWSBOAT_RUSTSTRING_H_
 #define NEWSBOAT_RUSTSTRING_H_
 
+#include <cstddef>
 #include <string>
 
+#include "rs_write_str.h"
+
+extern "C" {
+	/// Replaces the contents of the std::string that `out` points to with
+	/// `len` bytes starting at `data`.
+	///
+	/// Pass this along with a pointer to the destination string to Rust
+	/// functions that take an `rs_write_str_fn`. That way the result is
+	/// copied once, straight into the std::string, instead of being turned
+	/// into a C string that has to be measured, copied and freed.
+	///
+	/// Aborts if the string can't be allocated, since exceptions mustn't
+	/// propagate into Rust.
+	void assign_to_std_string(void* out, const char* data,
+		std::size_t len) noexcept;
+}
+
 namespace newsboat {
 
 class RustString {
@@ -2,22 +2,98 @@
 #define NEWSBOAT_SCOPEMEASURE_H_
 
 #include <chrono>
+#include <cstdint>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "logger.h"
 
 namespace newsboat {
 
+/// \brief Measures how long a scope took, and logs it on destruction.
+///
+/// Measures nest: each thread keeps a stack of the live ScopeMeasure objects,
+/// so when tracing is enabled (see start_tracing()) the scopes are recorded
+/// as a hierarchy that can be loaded into chrome://tracing or Perfetto.
 class ScopeMeasure {
 public:
+	struct TraceEvent {
+		std::string name;
+		/// 'X' for a complete event (a scope), 'i' for an instant one (a
+		/// stopover).
+		char phase;
+		unsigned int tid;
+		/// Nanoseconds since tracing started.
+		std::int64_t start_ns;
+		std::int64_t duration_ns;
+		/// CPU time the thread spent in the scope.
+		std::int64_t thread_duration_ns;
+		std::vector<std::pair<std::string, std::int64_t>> args;
+	};
+
 	ScopeMeasure(const std::string& func, Level ll = Level::DEBUG);
 	~ScopeMeasure();
+	ScopeMeasure(const ScopeMeasure&) = delete;
+	ScopeMeasure& operator=(const ScopeMeasure&) = delete;
+
 	void stopover(const std::string& son = "");
 
+	/// \brief Adds `amount` to this scope's counter called `name` (e.g.
+	/// "items" or "bytes").
+	///
+	/// Counters are logged along with the duration, and end up in the
+	/// "args" of the trace event.
+	void add_counter(const std::string& name, std::int64_t amount);
+
+	/// \brief Adds `amount` to the counter `name` of the innermost
+	/// ScopeMeasure of the calling thread. Does nothing if there is none.
+	///
+	/// This is meant for hot code which is too small to be worth a scope of
+	/// its own, so `name` is taken as a C string to avoid an allocation per
+	/// call.
+	static void add_to_current(const char* name, std::int64_t amount);
+
+	/// \brief Starts recording every scope into a trace which is written to
+	/// `filename` in Chrome's Trace Event Format when the program exits.
+	///
+	/// If `filename` is empty, the trace is only kept in memory (see
+	/// take_trace_events()).
+	static void start_tracing(const std::string& filename);
+
+	/// \brief Stops recording and forgets the events recorded so far, so
+	/// nothing is written at exit. Tracing can then be started again.
+	///
+	/// This is meant for tests, which mustn't leave tracing on for the
+	/// rest of the test binary.
+	static void stop_tracing();
+
+	static bool is_tracing();
+
+	/// \brief Returns the events recorded so far, and forgets them.
+	///
+	/// Each thread's events are in the order in which they were recorded,
+	/// but events of different threads may be interleaved in any order.
+	/// This lets benchmarks analyze a trace without going through a file.
+	static std::vector<TraceEvent> take_trace_events();
+
+	/// \brief Writes the trace collected so far. Called automatically at
+	/// exit if start_tracing() was called.
+	static void write_trace();
+
 private:
 	std::chrono::time_point<std::chrono::steady_clock> start_time;
+	/// CPU time of the thread when the scope started; only measured while
+	/// tracing.
+	std::int64_t start_thread_cpu_ns = 0;
 	std::string funcname;
 	Level lvl = Level::DEBUG;
+
+	/// The ScopeMeasure that was innermost on this thread when this one was
+	/// created.
+	ScopeMeasure* parent;
+
+	std::vector<std::pair<std::string, std::int64_t>> counters;
 };
 
 } // namespace newsboat
@@ -1,6 +1,7 @@
 #ifndef NEWSBOAT_SELECTFORMACTION_H_
 #define NEWSBOAT_SELECTFORMACTION_H_
 
+#include "feedcontainer.h"
 #include "filtercontainer.h"
 #include "formaction.h"
 #include "listwidget.h"
@@ -52,6 +53,7 @@ private:
 
 	std::string format_line(const std::string& selecttag_format,
 		const std::string& tag,
+		const TagCounts& counts,
 		unsigned int pos,
 		unsigned int width);
 
@@ -19,28 +19,38 @@ public:
 
 	TagSoupPullParser();
 	virtual ~TagSoupPullParser();
+	/// \brief Parses the contents of \a is.
+	///
+	/// The stream is read in full right away.
 	void set_input(std::istream& is);
+	/// \brief Parses \a input, which has to outlive the parser (or the
+	/// next call to set_input()).
+	void set_input(const std::string& input);
+	/// Temporaries wouldn't outlive the parser; pass them as a stream.
+	void set_input(std::string&&) = delete;
 	std::string get_attribute_value(const std::string& name) const;
 	Event get_event_type() const;
-	std::string get_text() const;
+	const std::string& get_text() const;
 	Event next();
 
 private:
 	typedef std::pair<std::string, std::string> Attribute;
 	std::vector<Attribute> attributes;
 	std::string text;
-	std::istream* inputstream;
+	/// Copy of the input passed as a stream; unused otherwise.
+	std::string input_buffer;
+	const char* input_pos;
+	const char* input_end;
 	Event current_event;
 
 	void add_attribute(std::string s);
-	std::string read_tag();
 	Event determine_tag_type();
 	std::string decode_attribute(const std::string& s);
 	std::string decode_entities(const std::string& s);
 	std::string decode_entity(std::string s);
 	void parse_tag(const std::string& tagstr);
 	void handle_tag();
-	void handle_text(char c);
+	void handle_text();
 };
 
 } // namespace newsboat
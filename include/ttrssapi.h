@@ -1,6 +1,8 @@
 #ifndef NEWSBOAT_TTRSSAPI_H_
 #define NEWSBOAT_TTRSSAPI_H_
 
+#include <functional>
+
 #include "3rd-party/json.hpp"
 #include "cache.h"
 #include "remoteapi.h"
@@ -20,17 +22,63 @@ public:
 		const std::map<std::string, std::string>& args,
 		bool try_login = true,
 		CURL* cached_handle = nullptr);
+	/// \brief Like run_op(), but hands each element of the reply's
+	/// "content" array to \a handle_element as soon as it's parsed.
+	///
+	/// The elements are dropped afterwards, so a large reply (e.g.
+	/// headlines with their content) is never held in memory as a whole
+	/// JSON tree. On success, the returned content is an array holding
+	/// only the elements that weren't objects (normally none). On failure,
+	/// null is returned, and elements handed over before the error was
+	/// found should be discarded by the caller. Exceptions thrown by
+	/// \a handle_element are passed on to the caller.
+	nlohmann::json run_op_streaming(const std::string& op,
+		const std::map<std::string, std::string>& args,
+		const std::function<void(nlohmann::json&)>& handle_element,
+		CURL* cached_handle = nullptr);
+	/// \brief Parses \a reply, a reply of the API.
+	///
+	/// If \a handle_element isn't null, each object in the reply's
+	/// "content" array is handed to it as soon as it's parsed, and then
+	/// removed from the array. Throws nlohmann::json::parse_error if
+	/// \a reply isn't valid JSON; objects that came before the error have
+	/// already been handed over by then.
+	static nlohmann::json parse_reply(const std::string& reply,
+		const std::function<void(nlohmann::json&)>* handle_element);
 	std::vector<TaggedFeedUrl> get_subscribed_urls() override;
+	bool supports_cached_subscriptions() override
+	{
+		return true;
+	}
 	void add_custom_headers(curl_slist** custom_headers) override;
 	bool mark_all_read(const std::string& feedurl) override;
 	bool mark_article_read(const std::string& guid, bool read) override;
+	bool mark_articles_read(const std::vector<std::string>& guids,
+		bool read) override;
 	bool update_article_flags(const std::string& oldflags,
 		const std::string& newflags,
 		const std::string& guid) override;
-	rsspp::Feed fetch_feed(const std::string& id, CURL* cached_handle);
+	/// \brief Fetches articles of feed \a id.
+	///
+	/// If \a sync_token isn't empty, only articles with IDs greater than it
+	/// are fetched, or taken from what prefetch_feeds() got. On success,
+	/// \a sync_token is set to the greatest article ID seen; on failure,
+	/// the returned feed's rss_version is UNKNOWN.
+	rsspp::Feed fetch_feed(const std::string& id,
+		std::string& sync_token,
+		CURL* cached_handle);
+	bool prefetch_feeds(const std::string& since) override;
 	bool update_article(const std::string& guid, int mode, int field);
 
 private:
+	nlohmann::json perform_op(const std::string& op,
+		const std::map<std::string, std::string>& args,
+		const std::function<void(nlohmann::json&)>* handle_element,
+		bool try_login,
+		CURL* cached_handle);
+	rsspp::Item headline_to_item(const nlohmann::json& item_obj,
+		int& item_id);
+	void sort_items(rsspp::Feed& f);
 	void fetch_feeds_per_category(const nlohmann::json& cat,
 		std::vector<TaggedFeedUrl>& feeds);
 	bool star_article(const std::string& guid, bool star);
@@ -46,6 +94,8 @@ private:
 	bool single;
 	std::mutex auth_lock;
 	int api_level = -1;
+
+	static const unsigned int PREFETCH_PAGE_SIZE = 200;
 };
 
 } // namespace newsboat
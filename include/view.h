@@ -12,6 +12,7 @@
 #include "filebrowserformaction.h"
 #include "dirbrowserformaction.h"
 #include "htmlrenderer.h"
+#include "itemrendercache.h"
 #include "keymap.h"
 #include "regexmanager.h"
 #include "stflpp.h"
@@ -156,6 +157,7 @@ protected:
 	std::vector<std::string> tags;
 
 	RegexManager& rxman;
+	ItemRenderCache item_render_cache;
 
 	std::map<std::string, std::string> fg_colors;
 	std::map<std::string, std::string> bg_colors;
@@ -99,14 +99,41 @@ void print_usage(const std::string& argv0, const std::string& config_path,
 			_s("<file>"),
 			_s("import list of read articles from <file>")
 		},
+		{
+			'\0',
+			"trace-file",
+			_s("<tracefile>"),
+			_s("write a Chrome trace of where time was spent to <tracefile>")
+		},
+		{
+			'\0',
+			"record-http",
+			_s("<archive>"),
+			_s("record all HTTP responses into <archive>")
+		},
+		{
+			'\0',
+			"replay-http",
+			_s("<archive>"),
+			_s("serve HTTP responses from <archive> instead of the network")
+		},
+		{
+			'\0',
+			"replay-http-timing",
+			"",
+			_s("make replayed responses take as long as the recorded ones")
+		},
 		{'h', "help", "", _s("this help")}
 	};
 
 	std::stringstream ss;
 	for (const auto& a : args) {
-		std::string longcolumn("-");
-		longcolumn += a.name;
-		longcolumn += ", --" + a.longname;
+		// Options without a short form get spaces instead, so that the long
+		// forms line up
+		std::string longcolumn = a.name != '\0'
+			? std::string("-") + a.name + ", "
+			: std::string(4, ' ');
+		longcolumn += "--" + a.longname;
 		longcolumn += a.params.size() > 0 ? "=" + a.params : "";
 		ss << "\t" << longcolumn;
 		for (unsigned int j = 0; j < utils::gentabs(longcolumn); j++) {
@@ -0,0 +1,244 @@
+#include "httparchive.h"
+
+#include <cinttypes>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include "config.h"
+#include "exception.h"
+#include "logger.h"
+#include "strprintf.h"
+
+using namespace newsboat;
+
+namespace {
+
+const std::string ARCHIVE_MAGIC = "newsboat-http-archive 1";
+
+enum class Mode { OFF, RECORDING, REPLAYING };
+
+std::mutex archive_mutex;
+Mode mode = Mode::OFF;
+std::ofstream recording;
+std::map<std::string, std::deque<rsspp::HttpResponse>> replays;
+bool replay_timing = false;
+
+void write_field(std::ostream& out,
+	const std::string& name,
+	const std::string& value)
+{
+	out << name << ' ' << value.length() << '\n' << value << '\n';
+}
+
+/// Reads a "name value" line and returns the value.
+std::string read_line(std::istream& in, const std::string& name)
+{
+	std::string line;
+	if (!std::getline(in, line)
+		|| line.compare(0, name.length() + 1, name + " ") != 0) {
+		throw rsspp::Exception(strprintf::fmt(
+				_("malformed HTTP archive: expected `%s'"), name));
+	}
+	return line.substr(name.length() + 1);
+}
+
+template<typename T>
+T read_number(std::istream& in, const std::string& name)
+{
+	std::istringstream value(read_line(in, name));
+	T result{};
+	if (!(value >> result)) {
+		throw rsspp::Exception(strprintf::fmt(
+				_("malformed HTTP archive: invalid value for `%s'"), name));
+	}
+	return result;
+}
+
+/// Number of bytes between the current position and the end of \a in.
+std::size_t remaining_bytes(std::istream& in)
+{
+	const auto pos = in.tellg();
+	in.seekg(0, std::ios::end);
+	const auto end = in.tellg();
+	in.seekg(pos);
+	return static_cast<std::size_t>(end - pos);
+}
+
+std::string read_field(std::istream& in, const std::string& name)
+{
+	const auto length = read_number<std::size_t>(in, name);
+	// The length is checked before allocating, so that a corrupted one
+	// doesn't make us allocate gigabytes (or throw std::bad_alloc)
+	if (length > remaining_bytes(in)) {
+		throw rsspp::Exception(strprintf::fmt(
+				_("malformed HTTP archive: `%s' is longer than the rest of "
+					"the file"),
+				name));
+	}
+	std::string value(length, '\0');
+	if (!in.read(&value[0], length) || in.get() != '\n') {
+		throw rsspp::Exception(strprintf::fmt(
+				_("malformed HTTP archive: truncated `%s'"), name));
+	}
+	return value;
+}
+
+} // namespace
+
+namespace rsspp {
+
+void HttpArchive::start_recording(const std::string& filename)
+{
+	std::lock_guard<std::mutex> guard(archive_mutex);
+
+	replays.clear();
+	if (recording.is_open()) {
+		recording.close();
+	}
+	recording.open(filename,
+		std::ios::out | std::ios::trunc | std::ios::binary);
+	if (!recording.is_open()) {
+		mode = Mode::OFF;
+		throw Exception(strprintf::fmt(
+				_("couldn't open HTTP archive `%s' for writing"), filename));
+	}
+	recording << ARCHIVE_MAGIC << '\n';
+	recording.flush();
+	mode = Mode::RECORDING;
+
+	LOG(Level::INFO, "HttpArchive: recording responses into %s", filename);
+}
+
+void HttpArchive::start_replaying(const std::string& filename,
+	bool keep_timing)
+{
+	std::ifstream in(filename, std::ios::in | std::ios::binary);
+	if (!in.is_open()) {
+		throw Exception(strprintf::fmt(
+				_("couldn't open HTTP archive `%s'"), filename));
+	}
+
+	std::string line;
+	if (!std::getline(in, line) || line != ARCHIVE_MAGIC) {
+		throw Exception(strprintf::fmt(
+				_("`%s' is not a newsboat HTTP archive"), filename));
+	}
+
+	std::map<std::string, std::deque<HttpResponse>> loaded;
+	std::size_t count = 0;
+	while (std::getline(in, line)) {
+		if (line != "record") {
+			throw Exception(_("malformed HTTP archive: expected `record'"));
+		}
+
+		const auto url = read_field(in, "url");
+		HttpResponse response;
+		response.curl_code = read_number<int>(in, "curl-code");
+		response.status = read_number<long>(in, "status");
+		response.elapsed = std::chrono::microseconds(
+				read_number<int64_t>(in, "elapsed-us"));
+		response.headers = read_field(in, "headers");
+		response.body = read_field(in, "body");
+
+		loaded[url].push_back(std::move(response));
+		count++;
+	}
+
+	std::lock_guard<std::mutex> guard(archive_mutex);
+	if (recording.is_open()) {
+		recording.close();
+	}
+	replays = std::move(loaded);
+	replay_timing = keep_timing;
+	mode = Mode::REPLAYING;
+
+	LOG(Level::INFO,
+		"HttpArchive: replaying %" PRIu64 " responses for %" PRIu64
+		" URLs from %s",
+		static_cast<uint64_t>(count),
+		static_cast<uint64_t>(replays.size()),
+		filename);
+}
+
+void HttpArchive::stop()
+{
+	std::lock_guard<std::mutex> guard(archive_mutex);
+	if (recording.is_open()) {
+		recording.close();
+	}
+	replays.clear();
+	mode = Mode::OFF;
+}
+
+bool HttpArchive::is_recording()
+{
+	std::lock_guard<std::mutex> guard(archive_mutex);
+	return mode == Mode::RECORDING;
+}
+
+bool HttpArchive::is_replaying()
+{
+	std::lock_guard<std::mutex> guard(archive_mutex);
+	return mode == Mode::REPLAYING;
+}
+
+void HttpArchive::record(const std::string& url, const HttpResponse& response)
+{
+	std::lock_guard<std::mutex> guard(archive_mutex);
+	if (mode != Mode::RECORDING) {
+		return;
+	}
+
+	recording << "record\n";
+	write_field(recording, "url", url);
+	recording << "curl-code " << response.curl_code << '\n';
+	recording << "status " << response.status << '\n';
+	recording << "elapsed-us " << response.elapsed.count() << '\n';
+	write_field(recording, "headers", response.headers);
+	write_field(recording, "body", response.body);
+	// Flushing after every record keeps the archive usable even if Newsboat
+	// is killed halfway through a reload.
+	recording.flush();
+
+	if (!recording) {
+		LOG(Level::ERROR, "HttpArchive::record: failed to write %s", url);
+	}
+}
+
+HttpResponse HttpArchive::replay(const std::string& url)
+{
+	HttpResponse response;
+	bool keep_timing = false;
+	{
+		std::lock_guard<std::mutex> guard(archive_mutex);
+		const auto it = replays.find(url);
+		if (mode != Mode::REPLAYING || it == replays.end()) {
+			throw Exception(strprintf::fmt(
+					_("no recorded response for %s"), url));
+		}
+
+		auto& queue = it->second;
+		response = queue.front();
+		if (queue.size() > 1) {
+			queue.pop_front();
+		}
+		keep_timing = replay_timing;
+	}
+
+	LOG(Level::DEBUG,
+		"HttpArchive::replay: serving %" PRIu64 " bytes for %s",
+		static_cast<uint64_t>(response.body.length()),
+		url);
+
+	if (keep_timing) {
+		std::this_thread::sleep_for(response.elapsed);
+	}
+
+	return response;
+}
+
+} // namespace rsspp
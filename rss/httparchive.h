@@ -0,0 +1,74 @@
+#ifndef NEWSBOAT_RSSPP_HTTPARCHIVE_H_
+#define NEWSBOAT_RSSPP_HTTPARCHIVE_H_
+
+#include <chrono>
+#include <string>
+
+namespace rsspp {
+
+/// \brief A response to a single HTTP request, as seen by Parser::parse_url().
+struct HttpResponse {
+	/// Result of curl_easy_perform(), as an integer so that a recording made
+	/// with one version of libcurl can be read by another.
+	int curl_code = 0;
+	long status = 0;
+	/// Raw header lines, each terminated by CRLF, in the order in which they
+	/// arrived. Headers of redirects are included.
+	std::string headers;
+	std::string body;
+	/// How long the request took from start to finish.
+	std::chrono::microseconds elapsed{0};
+};
+
+/// \brief Records HTTP responses into an archive file, or serves them back
+/// from one instead of going to the network.
+///
+/// This makes it possible to re-run a reload against exactly the same
+/// responses, e.g. to compare the speed of two builds without the noise of
+/// the network, or to reproduce a bug report. The archive is a plain-text
+/// file in which every variable-length field is prefixed by its length in
+/// bytes, so bodies are stored verbatim.
+///
+/// At most one of the modes can be active, and it stays active until stop()
+/// is called. All methods are thread-safe.
+class HttpArchive {
+public:
+	/// \brief Starts appending every response to \a filename, which is
+	/// truncated first.
+	///
+	/// Throws rsspp::Exception if the file can't be opened.
+	static void start_recording(const std::string& filename);
+
+	/// \brief Loads the archive \a filename and starts serving responses
+	/// from it.
+	///
+	/// If \a keep_timing is `true`, each response is delayed by as much as
+	/// the original request took; otherwise responses are served immediately.
+	///
+	/// Throws rsspp::Exception if the file can't be read or is malformed.
+	static void start_replaying(const std::string& filename,
+		bool keep_timing);
+
+	/// \brief Stops recording or replaying.
+	static void stop();
+
+	static bool is_recording();
+	static bool is_replaying();
+
+	/// \brief Appends the response for \a url to the archive. Does nothing
+	/// unless recording.
+	static void record(const std::string& url, const HttpResponse& response);
+
+	/// \brief Returns the next recorded response for \a url.
+	///
+	/// Responses for the same URL are served in the order in which they were
+	/// recorded; once they run out, the last one is served again.
+	///
+	/// Throws rsspp::Exception if the archive contains no response for
+	/// \a url.
+	static HttpResponse replay(const std::string& url);
+};
+
+} // namespace rsspp
+
+#endif /* NEWSBOAT_RSSPP_HTTPARCHIVE_H_ */
@@ -1,5 +1,6 @@
 #include "parser.h"
 
+#include <chrono>
 #include <cinttypes>
 #include <cstring>
 #include <curl/curl.h>
@@ -8,11 +9,13 @@
 
 #include "config.h"
 #include "exception.h"
+#include "httparchive.h"
 #include "logger.h"
 #include "remoteapi.h"
 #include "rssparser.h"
 #include "rssparserfactory.h"
 #include "rsspp_uris.h"
+#include "scopemeasure.h"
 #include "strprintf.h"
 #include "utils.h"
 
@@ -100,6 +103,14 @@ static size_t handle_headers(void* ptr, size_t size, size_t nmemb, void* data)
 	return size * nmemb;
 }
 
+static size_t collect_headers(void* ptr, size_t size, size_t nmemb,
+	void* data)
+{
+	std::string* headers = static_cast<std::string*>(data);
+	headers->append(static_cast<const char*>(ptr), size * nmemb);
+	return size * nmemb;
+}
+
 Feed Parser::parse_url(const std::string& url,
 	time_t lastmodified,
 	const std::string& etag,
@@ -107,8 +118,81 @@ Feed Parser::parse_url(const std::string& url,
 	const std::string& cookie_cache,
 	CURL* ehandle)
 {
-	std::string buf;
-	CURLcode ret;
+	ScopeMeasure m1("rsspp::Parser::parse_url");
+
+	HttpResponse response;
+	if (HttpArchive::is_replaying()) {
+		response = HttpArchive::replay(url);
+	} else {
+		response = fetch(url, lastmodified, etag, api, cookie_cache, ehandle);
+		HttpArchive::record(url, response);
+	}
+
+	HeaderValues hdrs;
+	std::string::size_type pos = 0;
+	while (pos < response.headers.length()) {
+		auto eol = response.headers.find('\n', pos);
+		eol = (eol == std::string::npos) ? response.headers.length() : eol + 1;
+		handle_headers(&response.headers[pos], 1, eol - pos, &hdrs);
+		pos = eol;
+	}
+
+	lm = hdrs.lastmodified;
+	et = hdrs.etag;
+
+	const auto ret = static_cast<CURLcode>(response.curl_code);
+	LOG(Level::DEBUG,
+		"rsspp::Parser::parse_url: ret = %d (%s)",
+		ret,
+		curl_easy_strerror(ret));
+
+	if (ret != 0) {
+		LOG(Level::ERROR,
+			"rsspp::Parser::parse_url: curl_easy_perform returned "
+			"err "
+			"%d: %s",
+			ret,
+			curl_easy_strerror(ret));
+		std::string msg;
+		if (ret == CURLE_HTTP_RETURNED_ERROR && response.status != 0) {
+			msg = strprintf::fmt(
+					"%s %" PRIi64,
+					curl_easy_strerror(ret),
+					// `status` is `long`, which is at least 32 bits, and on x86_64
+					// it's actually 64 bits. Thus casting to `int64_t` is either
+					// a no-op, or an up-cast which are always safe.
+					static_cast<int64_t>(response.status));
+		} else {
+			msg = curl_easy_strerror(ret);
+		}
+		throw Exception(msg);
+	}
+
+	const std::string& buf = response.body;
+	LOG(Level::INFO,
+		"Parser::parse_url: retrieved data for %s: %s",
+		url,
+		buf);
+
+	m1.add_counter("bytes", buf.length());
+	if (buf.length() > 0) {
+		LOG(Level::DEBUG,
+			"Parser::parse_url: handing over data to "
+			"parse_buffer()");
+		return parse_buffer(buf, url);
+	}
+
+	return Feed();
+}
+
+HttpResponse Parser::fetch(const std::string& url,
+	time_t lastmodified,
+	const std::string& etag,
+	newsboat::RemoteApi* api,
+	const std::string& cookie_cache,
+	CURL* ehandle)
+{
+	HttpResponse response;
 	curl_slist* custom_headers{};
 
 	CURL* easyhandle = ehandle;
@@ -129,7 +213,7 @@ Feed Parser::parse_url(const std::string& url,
 	curl_easy_setopt(easyhandle, CURLOPT_URL, url.c_str());
 	curl_easy_setopt(easyhandle, CURLOPT_SSL_VERIFYPEER, verify_ssl);
 	curl_easy_setopt(easyhandle, CURLOPT_WRITEFUNCTION, my_write_data);
-	curl_easy_setopt(easyhandle, CURLOPT_WRITEDATA, &buf);
+	curl_easy_setopt(easyhandle, CURLOPT_WRITEDATA, &response.body);
 	curl_easy_setopt(easyhandle, CURLOPT_NOSIGNAL, 1);
 	curl_easy_setopt(easyhandle, CURLOPT_FOLLOWLOCATION, 1);
 	curl_easy_setopt(easyhandle, CURLOPT_MAXREDIRS, 10);
@@ -162,9 +246,8 @@ Feed Parser::parse_url(const std::string& url,
 		curl_easy_setopt(easyhandle, CURLOPT_CAINFO, curl_ca_bundle);
 	}
 
-	HeaderValues hdrs;
-	curl_easy_setopt(easyhandle, CURLOPT_HEADERDATA, &hdrs);
-	curl_easy_setopt(easyhandle, CURLOPT_HEADERFUNCTION, handle_headers);
+	curl_easy_setopt(easyhandle, CURLOPT_HEADERDATA, &response.headers);
+	curl_easy_setopt(easyhandle, CURLOPT_HEADERFUNCTION, collect_headers);
 
 	if (lastmodified != 0) {
 		curl_easy_setopt(easyhandle,
@@ -189,24 +272,21 @@ Feed Parser::parse_url(const std::string& url,
 			easyhandle, CURLOPT_HTTPHEADER, custom_headers);
 	}
 
-	ret = curl_easy_perform(easyhandle);
-
-	lm = hdrs.lastmodified;
-	et = hdrs.etag;
+	const auto started = std::chrono::steady_clock::now();
+	response.curl_code = curl_easy_perform(easyhandle);
+	response.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - started);
 
 	if (custom_headers) {
 		curl_easy_setopt(easyhandle, CURLOPT_HTTPHEADER, 0);
 		curl_slist_free_all(custom_headers);
 	}
 
-	LOG(Level::DEBUG,
-		"rsspp::Parser::parse_url: ret = %d (%s)",
-		ret,
-		curl_easy_strerror(ret));
-
-	long status;
-	CURLcode infoOk =
-		curl_easy_getinfo(easyhandle, CURLINFO_RESPONSE_CODE, &status);
+	long status = 0;
+	if (curl_easy_getinfo(easyhandle, CURLINFO_RESPONSE_CODE, &status)
+		== CURLE_OK) {
+		response.status = status;
+	}
 
 	curl_easy_reset(easyhandle);
 	if (cookie_cache != "") {
@@ -218,45 +298,12 @@ Feed Parser::parse_url(const std::string& url,
 		curl_easy_cleanup(easyhandle);
 	}
 
-	if (ret != 0) {
-		LOG(Level::ERROR,
-			"rsspp::Parser::parse_url: curl_easy_perform returned "
-			"err "
-			"%d: %s",
-			ret,
-			curl_easy_strerror(ret));
-		std::string msg;
-		if (ret == CURLE_HTTP_RETURNED_ERROR && infoOk == CURLE_OK) {
-			msg = strprintf::fmt(
-					"%s %" PRIi64,
-					curl_easy_strerror(ret),
-					// `status` is `long`, which is at least 32 bits, and on x86_64
-					// it's actually 64 bits. Thus casting to `int64_t` is either
-					// a no-op, or an up-cast which are always safe.
-					static_cast<int64_t>(status));
-		} else {
-			msg = curl_easy_strerror(ret);
-		}
-		throw Exception(msg);
-	}
-
-	LOG(Level::INFO,
-		"Parser::parse_url: retrieved data for %s: %s",
-		url,
-		buf);
-
-	if (buf.length() > 0) {
-		LOG(Level::DEBUG,
-			"Parser::parse_url: handing over data to "
-			"parse_buffer()");
-		return parse_buffer(buf, url);
-	}
-
-	return Feed();
+	return response;
 }
 
 Feed Parser::parse_buffer(const std::string& buffer, const std::string& url)
 {
+	ScopeMeasure m1("rsspp::Parser::parse_buffer");
 	doc = xmlReadMemory(buffer.c_str(),
 			buffer.length(),
 			url.c_str(),
@@ -10,6 +10,8 @@
 
 namespace rsspp {
 
+struct HttpResponse;
+
 class Parser {
 public:
 	Parser(unsigned int timeout = 30,
@@ -41,6 +43,12 @@ public:
 	static void global_cleanup();
 
 private:
+	HttpResponse fetch(const std::string& url,
+		time_t lastmodified,
+		const std::string& etag,
+		newsboat::RemoteApi* api,
+		const std::string& cookie_cache,
+		CURL* ehandle);
 	Feed parse_xmlnode(xmlNode* node);
 	unsigned int to;
 	const std::string ua;
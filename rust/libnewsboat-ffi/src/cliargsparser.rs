@@ -251,6 +251,41 @@ pub unsafe extern "C" fn rs_cliargsparser_log_file(object: *mut c_void) -> *mut
     with_cliargsparser_opt_pathbuf(object, |o| &o.log_file)
 }
 
+#[no_mangle]
+pub unsafe extern "C" fn rs_cliargsparser_set_trace_file(object: *mut c_void) -> bool {
+    with_cliargsparser(object, |o| o.trace_file.is_some(), false)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn rs_cliargsparser_trace_file(object: *mut c_void) -> *mut c_char {
+    with_cliargsparser_opt_pathbuf(object, |o| &o.trace_file)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn rs_cliargsparser_set_record_http(object: *mut c_void) -> bool {
+    with_cliargsparser(object, |o| o.record_http.is_some(), false)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn rs_cliargsparser_record_http(object: *mut c_void) -> *mut c_char {
+    with_cliargsparser_opt_pathbuf(object, |o| &o.record_http)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn rs_cliargsparser_set_replay_http(object: *mut c_void) -> bool {
+    with_cliargsparser(object, |o| o.replay_http.is_some(), false)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn rs_cliargsparser_replay_http(object: *mut c_void) -> *mut c_char {
+    with_cliargsparser_opt_pathbuf(object, |o| &o.replay_http)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn rs_cliargsparser_replay_http_timing(object: *mut c_void) -> bool {
+    with_cliargsparser(object, |o| o.replay_http_timing, false)
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn rs_cliargsparser_set_log_level(object: *mut c_void) -> bool {
     with_cliargsparser(object, |o| o.log_level.is_some(), false)
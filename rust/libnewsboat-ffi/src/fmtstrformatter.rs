@@ -1,7 +1,6 @@
-use crate::abort_on_panic;
+use crate::{abort_on_panic, str_from_raw_parts, write_str, WriteStrFn};
 use libc::{c_char, c_void};
-use libnewsboat::fmtstrformatter::FmtStrFormatter;
-use std::ffi::{CStr, CString};
+use libnewsboat::fmtstrformatter::{FmtStrFormatter, FmtStrTemplate};
 use std::mem;
 
 #[no_mangle]
@@ -24,18 +23,14 @@ pub unsafe extern "C" fn rs_fmtstrformatter_register_fmt(
     fmt: *mut c_void,
     key: c_char,
     value: *const c_char,
+    value_len: usize,
 ) {
     abort_on_panic(|| {
         let mut fmt = {
             assert!(!fmt.is_null());
             Box::from_raw(fmt as *mut FmtStrFormatter)
         };
-        let value = {
-            assert!(!value.is_null());
-            CStr::from_ptr(value)
-        }
-        .to_string_lossy()
-        .into_owned();
+        let value = str_from_raw_parts(value, value_len).into_owned();
         // Keys are ASCII, so it's safe to cast c_char (i8) to u8 (0-127 map to the same bits).
         // From there, it's safe to cast to Rust's char.
         let key = key as u8 as char;
@@ -50,25 +45,70 @@ pub unsafe extern "C" fn rs_fmtstrformatter_register_fmt(
 pub unsafe extern "C" fn rs_fmtstrformatter_do_format(
     fmt: *mut c_void,
     format: *const c_char,
+    format_len: usize,
     width: u32,
-) -> *mut c_char {
+    out: *mut c_void,
+    write: WriteStrFn,
+) {
     abort_on_panic(|| {
         let fmt = {
             assert!(!fmt.is_null());
             Box::from_raw(fmt as *mut FmtStrFormatter)
         };
-        let format = {
-            assert!(!format.is_null());
-            CStr::from_ptr(format)
-        }
-        .to_str()
-        .expect("format contained invalid UTF-8");
-        let result = fmt.do_format(format, width);
-        let result = CString::new(result).unwrap().into_raw();
+        let format = str_from_raw_parts(format, format_len);
+        let result = fmt.do_format(&format, width);
+        write_str(&result, out, write);
 
         // Do not deallocate the object - C still has a pointer to it
         mem::forget(fmt);
+    })
+}
 
-        result
+#[no_mangle]
+pub unsafe extern "C" fn rs_fmtstrformatter_do_format_template(
+    fmt: *mut c_void,
+    template: *const c_void,
+    width: u32,
+    out: *mut c_void,
+    write: WriteStrFn,
+) {
+    abort_on_panic(|| {
+        assert!(!fmt.is_null());
+        assert!(!template.is_null());
+        let fmt = &*(fmt as *const FmtStrFormatter);
+        let template = &*(template as *const FmtStrTemplate);
+        let result = fmt.do_format_template(template, width);
+        write_str(&result, out, write);
+    })
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn rs_fmtstrtemplate_new(
+    format: *const c_char,
+    format_len: usize,
+) -> *mut c_void {
+    abort_on_panic(|| {
+        let format = str_from_raw_parts(format, format_len);
+        Box::into_raw(Box::new(FmtStrTemplate::new(&format))) as *mut c_void
+    })
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn rs_fmtstrtemplate_free(template: *mut c_void) {
+    abort_on_panic(|| {
+        if template.is_null() {
+            return;
+        }
+        Box::from_raw(template as *mut FmtStrTemplate);
+    })
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn rs_fmtstrtemplate_uses_key(template: *const c_void, key: c_char) -> bool {
+    abort_on_panic(|| {
+        assert!(!template.is_null());
+        let template = &*(template as *const FmtStrTemplate);
+        // Keys are ASCII, so it's safe to cast c_char (i8) to u8 (0-127 map to the same bits).
+        template.uses_key(key as u8 as char)
     })
 }
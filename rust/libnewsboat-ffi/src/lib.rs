@@ -1,7 +1,9 @@
-use libc::c_char;
+use libc::{c_char, c_void};
+use std::borrow::Cow;
 use std::ffi::CString;
 use std::panic::{catch_unwind, UnwindSafe};
 use std::process::abort;
+use std::slice;
 
 pub mod cliargsparser;
 pub mod configpaths;
@@ -21,6 +23,26 @@ fn abort_on_panic<F: FnOnce() -> R + UnwindSafe, R>(function: F) -> R {
     }
 }
 
+/// Callback through which a function hands a string back to C++ without allocating a C string
+/// for it. It copies `len` bytes starting at `data` into the buffer `out` points to; see
+/// `assign_to_std_string()` in ruststring.h.
+pub type WriteStrFn = unsafe extern "C" fn(out: *mut c_void, data: *const c_char, len: usize);
+
+/// Borrows a string that C++ passed as a pointer and a length. This only allocates if the string
+/// isn't valid UTF-8.
+unsafe fn str_from_raw_parts<'a>(data: *const c_char, len: usize) -> Cow<'a, str> {
+    if len == 0 {
+        return Cow::Borrowed("");
+    }
+    assert!(!data.is_null());
+    String::from_utf8_lossy(slice::from_raw_parts(data as *const u8, len))
+}
+
+/// Hands `string` back to C++ through the caller-provided `write` callback.
+unsafe fn write_str(string: &str, out: *mut c_void, write: WriteStrFn) {
+    write(out, string.as_ptr() as *const c_char, string.len());
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn rs_cstring_free(string: *mut c_char) {
     abort_on_panic(|| {
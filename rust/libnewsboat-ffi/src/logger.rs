@@ -2,12 +2,14 @@ use crate::abort_on_panic;
 use libc::c_char;
 use libnewsboat::logger;
 use std::ffi::CStr;
+use std::slice;
 
 #[no_mangle]
-pub unsafe extern "C" fn rs_log(level: logger::Level, message: *const c_char) {
+pub unsafe extern "C" fn rs_log(level: logger::Level, message: *const c_char, message_len: usize) {
     abort_on_panic(|| {
-        let message = CStr::from_ptr(message);
-        logger::get_instance().log_raw(level, message.to_bytes());
+        assert!(!message.is_null());
+        let message = slice::from_raw_parts(message as *const u8, message_len);
+        logger::get_instance().log_raw(level, message);
     })
 }
 
@@ -1,5 +1,5 @@
-use crate::abort_on_panic;
-use libc::{c_char, c_ulong};
+use crate::{abort_on_panic, str_from_raw_parts, write_str, WriteStrFn};
+use libc::{c_char, c_ulong, c_void};
 use libnewsboat::utils;
 use libnewsboat::{
     log,
@@ -18,30 +18,21 @@ pub struct FilterUrl {
 #[no_mangle]
 pub unsafe extern "C" fn rs_replace_all(
     input: *const c_char,
+    input_len: usize,
     from: *const c_char,
+    from_len: usize,
     to: *const c_char,
-) -> *mut c_char {
+    to_len: usize,
+    out: *mut c_void,
+    write: WriteStrFn,
+) {
     abort_on_panic(|| {
-        let rs_input = CStr::from_ptr(input);
-        let rs_input = rs_input.to_string_lossy().into_owned();
-
-        let rs_from = CStr::from_ptr(from);
-        // This won't panic because all strings in Newsboat are in UTF-8
-        let rs_from = rs_from.to_str().expect("rs_from contained invalid UTF-8");
+        let rs_input = str_from_raw_parts(input, input_len);
+        let rs_from = str_from_raw_parts(from, from_len);
+        let rs_to = str_from_raw_parts(to, to_len);
 
-        let rs_to = CStr::from_ptr(to);
-        // This won't panic because all strings in Newsboat are in UTF-8
-        let rs_to = rs_to.to_str().expect("rs_to contained invalid UTF-8");
-
-        let result = utils::replace_all(rs_input, rs_from, rs_to);
-        // Panic here can't happen because:
-        // 1. panic can only happen if `result` contains null bytes;
-        // 2. `result` contains what `input` contained, plus maybe what `to` contains (if there were
-        //    replacements);
-        // 3. neither `input` nor `to` could contain null bytes because they're null-terminated
-        //    strings we got from C.
-        let result = CString::new(result).unwrap();
-        result.into_raw()
+        let result = utils::replace_all(&rs_input, &rs_from, &rs_to);
+        write_str(&result, out, write);
     })
 }
 
@@ -187,57 +178,54 @@ pub unsafe extern "C" fn rs_is_exec_url(in_str: *const c_char) -> bool {
 }
 
 #[no_mangle]
-pub unsafe extern "C" fn rs_censor_url(url: *const c_char) -> *mut c_char {
+pub unsafe extern "C" fn rs_censor_url(
+    url: *const c_char,
+    url_len: usize,
+    out: *mut c_void,
+    write: WriteStrFn,
+) {
     abort_on_panic(|| {
-        let rs_url = CStr::from_ptr(url);
-        let rs_url = rs_url.to_string_lossy();
-        // `censor_url` replaces part of `rs_url` with `*`. Since `rs_url` came here as a C string,
-        // it doesn't contain NUL bytes. Thus, the result of `censor_url` won't contain NUL either,
-        // and `unwrap` won't panic.
-        CString::new(utils::censor_url(&rs_url)).unwrap().into_raw()
+        let rs_url = str_from_raw_parts(url, url_len);
+        write_str(&utils::censor_url(&rs_url), out, write);
     })
 }
 
 #[no_mangle]
-pub unsafe extern "C" fn rs_quote_for_stfl(string: *const c_char) -> *mut c_char {
+pub unsafe extern "C" fn rs_quote_for_stfl(
+    string: *const c_char,
+    string_len: usize,
+    out: *mut c_void,
+    write: WriteStrFn,
+) {
     abort_on_panic(|| {
-        let rs_string = CStr::from_ptr(string);
-        let rs_string = rs_string.to_string_lossy();
-        CString::new(utils::quote_for_stfl(&rs_string))
-            // CString::new declares returning a NulError if the passed string contains \0-bytes.
-            // Unwrap is checked here, because quote_for_stfl receives a regular, c-style string,
-            // and only inserts additional, non-null bytes ('>'), so unwrapping it will always
-            // succeed.
-            .unwrap()
-            .into_raw()
+        let rs_string = str_from_raw_parts(string, string_len);
+        write_str(&utils::quote_for_stfl(&rs_string), out, write);
     })
 }
 
 #[no_mangle]
-pub unsafe extern "C" fn rs_trim_end(input: *const c_char) -> *mut c_char {
+pub unsafe extern "C" fn rs_trim_end(
+    input: *const c_char,
+    input_len: usize,
+    out: *mut c_void,
+    write: WriteStrFn,
+) {
     abort_on_panic(|| {
-        let rs_input = CStr::from_ptr(input);
-        let rs_input = rs_input.to_string_lossy().into_owned();
-
-        let result = utils::trim_end(rs_input);
-
-        // `result` is a subset of `rs_input`, which is a C string; thus, `unwrap` won't panic.
-        let result = CString::new(result).unwrap();
-        result.into_raw()
+        let rs_input = str_from_raw_parts(input, input_len);
+        write_str(utils::trim_end(&rs_input), out, write);
     })
 }
 
 #[no_mangle]
-pub unsafe extern "C" fn rs_trim(input: *const c_char) -> *mut c_char {
+pub unsafe extern "C" fn rs_trim(
+    input: *const c_char,
+    input_len: usize,
+    out: *mut c_void,
+    write: WriteStrFn,
+) {
     abort_on_panic(|| {
-        let rs_input = CStr::from_ptr(input);
-        let rs_input = rs_input.to_string_lossy().into_owned();
-
-        let result = utils::trim(rs_input);
-
-        // `result` is a subset of `rs_input`, which is a C string; thus, `unwrap` won't panic.
-        let result = CString::new(result).unwrap();
-        result.into_raw()
+        let rs_input = str_from_raw_parts(input, input_len);
+        write_str(utils::trim(&rs_input), out, write);
     })
 }
 
@@ -363,11 +351,16 @@ pub extern "C" fn rs_getcwd() -> *mut c_char {
 }
 
 #[no_mangle]
-pub unsafe extern "C" fn rs_strnaturalcmp(a: *const c_char, b: *const c_char) -> isize {
+pub unsafe extern "C" fn rs_strnaturalcmp(
+    a: *const c_char,
+    a_len: usize,
+    b: *const c_char,
+    b_len: usize,
+) -> isize {
     use std::cmp::Ordering;
     abort_on_panic(|| {
-        let a = CStr::from_ptr(a).to_string_lossy();
-        let b = CStr::from_ptr(b).to_string_lossy();
+        let a = str_from_raw_parts(a, a_len);
+        let b = str_from_raw_parts(b, b_len);
         match utils::strnaturalcmp(&a, &b) {
             Ordering::Less => -1,
             Ordering::Equal => 0,
@@ -442,19 +435,17 @@ pub unsafe extern "C" fn rs_is_valid_attribute(attribute: *const c_char) -> bool
 }
 
 #[no_mangle]
-pub unsafe extern "C" fn rs_strwidth(input: *const c_char) -> usize {
+pub unsafe extern "C" fn rs_strwidth(input: *const c_char, input_len: usize) -> usize {
     abort_on_panic(|| {
-        let rs_str = CStr::from_ptr(input);
-        let rs_str = rs_str.to_string_lossy().into_owned();
+        let rs_str = str_from_raw_parts(input, input_len);
         utils::strwidth(&rs_str)
     })
 }
 
 #[no_mangle]
-pub unsafe extern "C" fn rs_strwidth_stfl(input: *const c_char) -> usize {
+pub unsafe extern "C" fn rs_strwidth_stfl(input: *const c_char, input_len: usize) -> usize {
     abort_on_panic(|| {
-        let rs_str = CStr::from_ptr(input);
-        let rs_str = rs_str.to_string_lossy().into_owned();
+        let rs_str = str_from_raw_parts(input, input_len);
         utils::strwidth_stfl(&rs_str)
     })
 }
@@ -462,32 +453,32 @@ pub unsafe extern "C" fn rs_strwidth_stfl(input: *const c_char) -> usize {
 #[no_mangle]
 pub unsafe extern "C" fn rs_substr_with_width(
     string: *const c_char,
+    string_len: usize,
     max_width: usize,
-) -> *mut c_char {
+    out: *mut c_void,
+    write: WriteStrFn,
+) {
     abort_on_panic(|| {
-        let rs_str = CStr::from_ptr(string);
-        let rs_str = rs_str.to_string_lossy().into_owned();
-        let output = utils::substr_with_width(&rs_str, max_width);
-        // `output` contains a subset of `string`, which is a C string. Thus, we conclude that
-        // `output` doesn't contain null bytes. Therefore, `CString::new` always returns `Some`.
-        let result = CString::new(output).unwrap();
-        result.into_raw()
+        let rs_str = str_from_raw_parts(string, string_len);
+        write_str(&utils::substr_with_width(&rs_str, max_width), out, write);
     })
 }
 
 #[no_mangle]
 pub unsafe extern "C" fn rs_substr_with_width_stfl(
     string: *const c_char,
+    string_len: usize,
     max_width: usize,
-) -> *mut c_char {
-    abort_on_panic(|| {
-        let rs_str = CStr::from_ptr(string);
-        let rs_str = rs_str.to_string_lossy().into_owned();
-        let output = utils::substr_with_width_stfl(&rs_str, max_width);
-        // `output` contains a subset of `string`, which is a C string. Thus, we conclude that
-        // `output` doesn't contain null bytes. Therefore, `CString::new` always returns `Some`.
-        let result = CString::new(output).unwrap();
-        result.into_raw()
+    out: *mut c_void,
+    write: WriteStrFn,
+) {
+    abort_on_panic(|| {
+        let rs_str = str_from_raw_parts(string, string_len);
+        write_str(
+            &utils::substr_with_width_stfl(&rs_str, max_width),
+            out,
+            write,
+        );
     })
 }
 
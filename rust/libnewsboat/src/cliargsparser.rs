@@ -68,6 +68,22 @@ pub struct CliArgsParser {
 
     /// If this contains some value, it's the log level specified by the user.
     pub log_level: Option<Level>,
+
+    /// If this contains some value, it's the path to which a trace of the program's execution
+    /// should be written, in Chrome's Trace Event format.
+    pub trace_file: Option<PathBuf>,
+
+    /// If this contains some value, it's the path to the archive into which all HTTP responses
+    /// should be recorded.
+    pub record_http: Option<PathBuf>,
+
+    /// If this contains some value, it's the path to the archive from which HTTP responses should
+    /// be replayed instead of going to the network.
+    pub replay_http: Option<PathBuf>,
+
+    /// If `true`, replayed responses take as long as they did when they were recorded. Otherwise
+    /// they're served immediately.
+    pub replay_http_timing: bool,
 }
 
 const LOCK_SUFFIX: &str = ".lock";
@@ -85,7 +101,11 @@ impl CliArgsParser {
         const LOG_FILE: &str = "log-file";
         const LOG_LEVEL: &str = "log-level";
         const QUIET: &str = "quiet";
+        const RECORD_HTTP: &str = "record-http";
         const REFRESH_ON_START: &str = "refresh-on-start";
+        const REPLAY_HTTP: &str = "replay-http";
+        const REPLAY_HTTP_TIMING: &str = "replay-http-timing";
+        const TRACE_FILE: &str = "trace-file";
         const URL_FILE: &str = "url-file";
         const VACUUM: &str = "vacuum";
         const VERSION: &str = "version";
@@ -166,7 +186,23 @@ impl CliArgsParser {
                     .short("l")
                     .long(LOG_LEVEL)
                     .takes_value(true),
-            );
+            )
+            .arg(
+                Arg::with_name(TRACE_FILE)
+                    .long(TRACE_FILE)
+                    .takes_value(true),
+            )
+            .arg(
+                Arg::with_name(RECORD_HTTP)
+                    .long(RECORD_HTTP)
+                    .takes_value(true),
+            )
+            .arg(
+                Arg::with_name(REPLAY_HTTP)
+                    .long(REPLAY_HTTP)
+                    .takes_value(true),
+            )
+            .arg(Arg::with_name(REPLAY_HTTP_TIMING).long(REPLAY_HTTP_TIMING));
 
         let mut args = CliArgsParser::default();
 
@@ -264,6 +300,25 @@ impl CliArgsParser {
             args.log_file = Some(utils::resolve_tilde(PathBuf::from(log_file)));
         }
 
+        if let Some(trace_file) = matches.value_of(TRACE_FILE) {
+            args.trace_file = Some(utils::resolve_tilde(PathBuf::from(trace_file)));
+        }
+
+        if let Some(archive) = matches.value_of(RECORD_HTTP) {
+            args.record_http = Some(utils::resolve_tilde(PathBuf::from(archive)));
+        }
+
+        if let Some(archive) = matches.value_of(REPLAY_HTTP) {
+            if args.record_http.is_some() {
+                args.should_print_usage = true;
+                args.return_code = Some(EXIT_FAILURE);
+            } else {
+                args.replay_http = Some(utils::resolve_tilde(PathBuf::from(archive)));
+            }
+        }
+
+        args.replay_http_timing = matches.is_present(REPLAY_HTTP_TIMING);
+
         if let Some(log_level_str) = matches.value_of(LOG_LEVEL) {
             match log_level_str.parse::<u8>() {
                 Ok(1) => {
@@ -719,6 +774,78 @@ mod tests {
         ]);
     }
 
+    #[test]
+    fn t_sets_trace_file_if_dash_dash_trace_file_is_provided() {
+        let filename = "trace file.json";
+
+        let check = |opts| {
+            let args = CliArgsParser::new(opts);
+
+            assert_eq!(args.trace_file, Some(PathBuf::from(filename)));
+        };
+
+        check(vec![
+            "newsboat".to_string(),
+            "--trace-file".to_string(),
+            filename.to_string(),
+        ]);
+        check(vec![
+            "newsboat".to_string(),
+            "--trace-file=".to_string() + &filename,
+        ]);
+    }
+
+    #[test]
+    fn t_sets_record_http_if_dash_dash_record_http_is_provided() {
+        let args = CliArgsParser::new(vec![
+            "newsboat".to_string(),
+            "--record-http".to_string(),
+            "responses.archive".to_string(),
+        ]);
+
+        assert_eq!(args.record_http, Some(PathBuf::from("responses.archive")));
+        assert_eq!(args.replay_http, None);
+    }
+
+    #[test]
+    fn t_sets_replay_http_if_dash_dash_replay_http_is_provided() {
+        let check = |opts, expected_timing| {
+            let args = CliArgsParser::new(opts);
+
+            assert_eq!(args.replay_http, Some(PathBuf::from("responses.archive")));
+            assert_eq!(args.replay_http_timing, expected_timing);
+            assert_eq!(args.record_http, None);
+        };
+
+        check(
+            vec![
+                "newsboat".to_string(),
+                "--replay-http=responses.archive".to_string(),
+            ],
+            false,
+        );
+        check(
+            vec![
+                "newsboat".to_string(),
+                "--replay-http=responses.archive".to_string(),
+                "--replay-http-timing".to_string(),
+            ],
+            true,
+        );
+    }
+
+    #[test]
+    fn t_asks_to_print_usage_and_exit_with_failure_if_both_recording_and_replaying_http() {
+        let args = CliArgsParser::new(vec![
+            "newsboat".to_string(),
+            "--record-http=a.archive".to_string(),
+            "--replay-http=b.archive".to_string(),
+        ]);
+
+        assert!(args.should_print_usage);
+        assert_eq!(args.return_code, Some(EXIT_FAILURE));
+    }
+
     #[test]
     fn t_sets_set_log_level_and_log_level_if_argument_to_dash_l_is_1_to_6() {
         let check = |opts, expected_level| {
@@ -6,7 +6,7 @@ mod parser;
 use crate::utils;
 use limited_string::LimitedString;
 use parser::{parse, Padding, Specifier};
-use std::collections::BTreeMap;
+use std::collections::{BTreeMap, BTreeSet};
 
 /// Produces strings of values in a specified format, strftime(3)-like.
 ///
@@ -77,6 +77,11 @@ impl FmtStrFormatter {
         self.formatting_helper(&ast, width)
     }
 
+    /// Same as `do_format()`, but takes a format string that was already parsed.
+    pub fn do_format_template(&self, template: &FmtStrTemplate, width: u32) -> String {
+        self.formatting_helper(&template.ast, width)
+    }
+
     fn format_spacing(&self, c: char, rest: &[Specifier], width: u32, result: &mut LimitedString) {
         let rest = self.formatting_helper(rest, 0);
         if width == 0 {
@@ -162,7 +167,7 @@ impl FmtStrFormatter {
                     self.format_format(c, &padding, width, &mut result);
                 }
 
-                Specifier::Text(s) => {
+                Specifier::Text(ref s) => {
                     if width == 0 {
                         result.push_str(s);
                     } else {
@@ -186,6 +191,68 @@ impl FmtStrFormatter {
     }
 }
 
+/// A format string that is parsed once and then used to format any number of lines.
+///
+/// List views format every line with the same format string, and parsing it is a big part of what
+/// `FmtStrFormatter::do_format()` does. With a template, the format string is only parsed again
+/// when it changes:
+/// ```
+/// use libnewsboat::fmtstrformatter::*;
+///
+/// let template = FmtStrTemplate::new("%t (%a)");
+/// assert!(template.uses_key('t'));
+/// assert!(!template.uses_key('D'));
+///
+/// let mut fmt = FmtStrFormatter::new();
+/// fmt.register_fmt('t', "How I Spent My Summer".to_string());
+/// fmt.register_fmt('a', "John Doe".to_string());
+/// assert_eq!(
+///     fmt.do_format_template(&template, 0),
+///     "How I Spent My Summer (John Doe)"
+/// );
+/// ```
+pub struct FmtStrTemplate {
+    ast: Vec<Specifier>,
+    /// Keys that the format string refers to, including the ones in conditionals.
+    keys: BTreeSet<char>,
+}
+
+impl FmtStrTemplate {
+    /// Parses the format string.
+    pub fn new(format: &str) -> FmtStrTemplate {
+        let ast = parse(format);
+        let mut keys = BTreeSet::new();
+        collect_keys(&ast, &mut keys);
+        FmtStrTemplate { ast, keys }
+    }
+
+    /// Returns `true` if the format string refers to the given key. Values of other keys are
+    /// never used, so there is no need to compute and register them.
+    pub fn uses_key(&self, key: char) -> bool {
+        self.keys.contains(&key)
+    }
+}
+
+fn collect_keys(format_ast: &[Specifier], keys: &mut BTreeSet<char>) {
+    for specifier in format_ast {
+        match *specifier {
+            Specifier::Format(c, _) => {
+                keys.insert(c);
+            }
+
+            Specifier::Conditional(cond, ref then, ref els) => {
+                keys.insert(cond);
+                collect_keys(then, keys);
+                if let Some(ref els) = *els {
+                    collect_keys(els, keys);
+                }
+            }
+
+            Specifier::Spacing(_) | Specifier::Text(_) => {}
+        }
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -586,6 +653,43 @@ mod tests {
         assert_eq!(fmt.do_format("%x? %y", 0), "What's the ultimate answer? 42");
     }
 
+    #[test]
+    fn t_template_knows_which_keys_it_uses() {
+        let template = FmtStrTemplate::new("%a %-4b %%c %>d %?e?%f&%g?");
+
+        for key in &['a', 'b', 'e', 'f', 'g'] {
+            assert!(template.uses_key(*key), "key: {}", key);
+        }
+        for key in &['c', 'd', 'h'] {
+            assert!(!template.uses_key(*key), "key: {}", key);
+        }
+    }
+
+    #[test]
+    fn t_do_format_template_gives_the_same_results_as_do_format() {
+        let mut fmt = FmtStrFormatter::new();
+
+        fmt.register_fmt('a', "АБВ".to_string());
+        fmt.register_fmt('b', "буква".to_string());
+        fmt.register_fmt('c', String::new());
+
+        for format in &[
+            "",
+            "%a%b%c",
+            "<%a> <%5b> | %-5c%%",
+            "asdf | %a | %?c?%a%b&%b%a? | qwert",
+            "%a%> %b",
+        ] {
+            let template = FmtStrTemplate::new(format);
+            for width in &[0, 5, 30] {
+                assert_eq!(
+                    fmt.do_format_template(&template, *width),
+                    fmt.do_format(format, *width)
+                );
+            }
+        }
+    }
+
     proptest::proptest! {
         #[test]
         fn does_not_crash_when_formatting_with_no_formats_registered(ref input in "\\PC*") {
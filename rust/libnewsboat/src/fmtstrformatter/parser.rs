@@ -18,21 +18,21 @@ pub enum Padding {
 /// Describes all the different "format specifiers" we support, plus a chunk of text that would be
 /// copied to the output verbatim.
 #[derive(PartialEq, Eq, Debug)]
-pub enum Specifier<'a> {
+pub enum Specifier {
     /// Will expand to pad everything that comes next to the right. Given char is used for padding.
     Spacing(char),
     /// A format to be replaced with a value (`%a`, `%t` etc.), padded to the given width on the
     /// left (if it's positive) or on the right (if it's negative).
     Format(char, Padding),
     /// A chunk of text that will be copied to the output verbatim.
-    Text(&'a str),
+    Text(String),
     /// Conditional format that is replaced by one of the sub-formats depending on the value of the
     /// given key. "Else" branch might be missing.
-    Conditional(char, Vec<Specifier<'a>>, Option<Vec<Specifier<'a>>>),
+    Conditional(char, Vec<Specifier>, Option<Vec<Specifier>>),
 }
 
 fn escaped_percent_sign(input: &str) -> IResult<&str, Specifier> {
-    tag("%%")(input).map(|result| (result.0, Specifier::Text(&result.1[0..1])))
+    tag("%%")(input).map(|result| (result.0, Specifier::Text(result.1[0..1].to_string())))
 }
 
 fn spacing(input: &str) -> IResult<&str, Specifier> {
@@ -69,13 +69,13 @@ fn padded_format(input: &str) -> IResult<&str, Specifier> {
 fn text_outside_conditional(input: &str) -> IResult<&str, Specifier> {
     let (input, text) = take_till1(|chr: char| chr == '%')(input)?;
 
-    Ok((input, Specifier::Text(text)))
+    Ok((input, Specifier::Text(text.to_string())))
 }
 
 fn text_inside_conditional(input: &str) -> IResult<&str, Specifier> {
     let (input, text) = take_till1(|chr: char| chr == '%' || chr == '&' || chr == '?')(input)?;
 
-    Ok((input, Specifier::Text(text)))
+    Ok((input, Specifier::Text(text.to_string())))
 }
 
 fn conditional(input: &str) -> IResult<&str, Specifier> {
@@ -147,7 +147,7 @@ fn sanitize(mut input: Vec<Specifier>) -> Vec<Specifier> {
 pub fn parse(input: &str) -> Vec<Specifier> {
     match parser(input) {
         Ok((_leftovers, ast)) => sanitize(ast),
-        Err(_) => vec![Specifier::Text("")],
+        Err(_) => vec![Specifier::Text(String::new())],
     }
 }
 
@@ -160,7 +160,7 @@ mod tests {
         let input = "Hello, world!";
         let (leftovers, result) = parser(input).unwrap();
         assert_eq!(leftovers, "");
-        assert_eq!(result, vec![Specifier::Text("Hello, world!")]);
+        assert_eq!(result, vec![Specifier::Text("Hello, world!".to_string())]);
     }
 
     #[test]
@@ -168,7 +168,7 @@ mod tests {
         let input = "%%";
         let (leftovers, result) = parser(input).unwrap();
         assert_eq!(leftovers, "");
-        assert_eq!(result, vec![Specifier::Text("%")]);
+        assert_eq!(result, vec![Specifier::Text("%".to_string())]);
     }
 
     #[test]
@@ -178,9 +178,9 @@ mod tests {
         assert_eq!(leftovers, "");
 
         let expected = vec![
-            Specifier::Text("100"),
-            Specifier::Text("%"),
-            Specifier::Text(" pure Ceylon tea"),
+            Specifier::Text("100".to_string()),
+            Specifier::Text("%".to_string()),
+            Specifier::Text(" pure Ceylon tea".to_string()),
         ];
         assert_eq!(result, expected);
     }
@@ -194,9 +194,9 @@ mod tests {
 
         let expected = vec![
             Specifier::Format('t', Padding::None),
-            Specifier::Text(" ("),
+            Specifier::Text(" (".to_string()),
             Specifier::Format('a', Padding::None),
-            Specifier::Text(")"),
+            Specifier::Text(")".to_string()),
         ];
         assert_eq!(result, expected);
     }
@@ -257,8 +257,8 @@ mod tests {
 
         let expected = vec![Specifier::Conditional(
             'x',
-            vec![Specifier::Text("success")],
-            Some(vec![Specifier::Text("failure")]),
+            vec![Specifier::Text("success".to_string())],
+            Some(vec![Specifier::Text("failure".to_string())]),
         )];
         assert_eq!(result, expected);
     }
@@ -272,7 +272,7 @@ mod tests {
 
         let expected = vec![Specifier::Conditional(
             'x',
-            vec![Specifier::Text("success")],
+            vec![Specifier::Text("success".to_string())],
             None,
         )];
         assert_eq!(result, expected);
@@ -299,7 +299,7 @@ mod tests {
         let expected = vec![Specifier::Conditional(
             'x',
             vec![],
-            Some(vec![Specifier::Text("nonempty")]),
+            Some(vec![Specifier::Text("nonempty".to_string())]),
         )];
         assert_eq!(result, expected);
     }
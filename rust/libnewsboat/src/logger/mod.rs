@@ -1,12 +1,18 @@
 //! Keeps a record of what the program did.
 
-use chrono::{offset::Local, Datelike, Timelike};
+mod record_queue;
+
+use chrono::{offset::Local, DateTime, Datelike, Timelike};
 use once_cell::sync::OnceCell;
+use record_queue::RecordQueue;
 use std::fmt;
 use std::fs::{File, OpenOptions};
 use std::io::Write;
-use std::sync::atomic::{AtomicUsize, Ordering};
-use std::sync::Mutex;
+use std::panic;
+use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
+use std::sync::{Arc, Mutex};
+use std::thread;
+use std::time::Duration;
 
 #[derive(Clone, Copy, PartialEq, Eq, PartialOrd, Ord, Debug)]
 /// "Importance levels" for log messages.
@@ -75,6 +81,17 @@ impl Default for Level {
     }
 }
 
+/// Longest message, in bytes, that is written to the log. Anything past that is cut off.
+///
+/// Some debug messages contain whole feeds or server responses, which can be megabytes long.
+const MAX_MESSAGE_LENGTH: usize = 16 * 1024;
+
+/// How many messages can wait to be written before new ones are dropped.
+const QUEUE_CAPACITY: usize = 4096;
+
+/// How often the background thread writes out queued messages if there aren't many of them.
+const FLUSH_INTERVAL: Duration = Duration::from_millis(100);
+
 /// Stores the handles for logfiles.
 ///
 /// This is part of `Logger` struct. This struct is not thread-safe, but in `Logger`, it will be
@@ -88,6 +105,134 @@ struct LogFiles {
     user_error_logfile: Option<File>,
 }
 
+/// A message that waits in the queue until the background thread writes it out.
+struct Record {
+    level: Level,
+    timestamp: DateTime<Local>,
+    message: Vec<u8>,
+}
+
+/// The part of `Logger` that is shared with its background thread.
+struct Shared {
+    /// Handles for the files to which messages should be written.
+    files: Mutex<LogFiles>,
+
+    /// Messages that weren't written to the logfile yet.
+    queue: RecordQueue<Record>,
+
+    /// Number of messages that were thrown away because the queue was full, since this was last
+    /// reported in the log.
+    dropped: AtomicUsize,
+
+    /// Maximum "importance level" of the messages that will be written to the log.
+    loglevel: AtomicUsize,
+
+    /// `true` if the logfile was set, i.e. if it makes sense to queue messages.
+    has_logfile: AtomicBool,
+
+    /// Tells the background thread to write out what's left and quit.
+    stop: AtomicBool,
+
+    /// The background thread, so that it can be woken up early.
+    flusher: OnceCell<thread::Thread>,
+}
+
+impl Shared {
+    /// Writes all the queued messages to the logfile.
+    ///
+    /// Takes `files` to make sure the caller holds the lock: that's what keeps the messages in
+    /// order when several threads drain the queue.
+    fn write_queued(&self, files: &mut LogFiles) {
+        let mut buffer = Vec::new();
+
+        let dropped = self.dropped.swap(0, Ordering::Relaxed);
+        if dropped > 0 {
+            let message = format!(
+                "Logger: dropped {} messages because they were logged faster than they could be \
+                 written",
+                dropped
+            );
+            append_line(
+                &mut buffer,
+                &Local::now(),
+                Some(Level::Warn),
+                message.as_bytes(),
+            );
+        }
+
+        while let Some(record) = self.queue.pop() {
+            append_line(
+                &mut buffer,
+                &record.timestamp,
+                Some(record.level),
+                &record.message,
+            );
+        }
+
+        if let Some(ref mut logfile) = files.logfile {
+            // Ignoring the error since checking every log() call will be too bothersome.
+            let _ = logfile.write_all(&buffer);
+        }
+    }
+
+    fn run_flusher(&self) {
+        loop {
+            let stopping = self.stop.load(Ordering::Acquire);
+            {
+                let mut files = self.files.lock().expect("Someone poisoned logger's mutex");
+                self.write_queued(&mut files);
+            }
+            if stopping {
+                break;
+            }
+            thread::park_timeout(FLUSH_INTERVAL);
+        }
+    }
+}
+
+/// Appends a log line: timestamp, level (if given), message, and a newline.
+fn append_line(
+    buffer: &mut Vec<u8>,
+    timestamp: &DateTime<Local>,
+    level: Option<Level>,
+    data: &[u8],
+) {
+    // DateTime::format() is extremely slow; format! is way faster. See
+    // https://github.com/chronotope/chrono/issues/94 for details.
+    let timestamp = format!(
+        "[{}-{:02}-{:02} {:02}:{:02}:{:02}] ",
+        timestamp.year(),
+        timestamp.month(),
+        timestamp.day(),
+        timestamp.hour(),
+        timestamp.minute(),
+        timestamp.second()
+    );
+    buffer.extend_from_slice(timestamp.as_bytes());
+    if let Some(level) = level {
+        buffer.extend_from_slice(format!("{}: ", level).as_bytes());
+    }
+    buffer.extend_from_slice(data);
+    buffer.push(b'\n');
+}
+
+/// Cuts `data` down to at most `MAX_MESSAGE_LENGTH` bytes, noting how much was cut off.
+fn truncate_message(data: &[u8]) -> Vec<u8> {
+    if data.len() <= MAX_MESSAGE_LENGTH {
+        return data.to_vec();
+    }
+
+    // Don't cut a UTF-8 character in half: back off from its continuation bytes
+    let mut end = MAX_MESSAGE_LENGTH;
+    while end > 0 && (data[end] & 0b1100_0000) == 0b1000_0000 {
+        end -= 1;
+    }
+
+    let mut message = data[..end].to_vec();
+    message.extend_from_slice(format!("... ({} more bytes)", data.len() - end).as_bytes());
+    message
+}
+
 /// Keeps a record of what the program did.
 ///
 /// Each Logger object can write up to two logs.
@@ -100,6 +245,13 @@ struct LogFiles {
 ///
 /// Each message in the log is time-stamped, and marked with its importance level.
 ///
+/// Warnings, informational and debug messages are written asynchronously, so that logging doesn't
+/// slow down the program: they are put into a lock-free queue, and a background thread writes them
+/// out in batches. If messages are logged faster than they can be written, the queue fills up; new
+/// messages are then dropped, and the log says how many. Errors are written right away, after the
+/// messages that are still queued, so they make it to the log even if the program crashes a moment
+/// later. Messages longer than 16 KiB are truncated.
+///
 /// This is meant to be a long-lived, shared object that exists for the duration of the program.
 /// Users would call its `log` method to add messages to the log file, like this:
 ///
@@ -121,11 +273,10 @@ struct LogFiles {
 /// logger.log(Level::Debug, &format!("feeds.len() == {}", 42));
 /// ```
 pub struct Logger {
-    /// Handles for the files to which messages should be written.
-    files: Mutex<LogFiles>,
+    shared: Arc<Shared>,
 
-    /// Maximum "importance level" of the messages that will be written to the log.
-    loglevel: AtomicUsize,
+    /// The background thread that writes queued messages. Started by set_logfile().
+    flusher: Mutex<Option<thread::JoinHandle<()>>>,
 }
 
 impl Logger {
@@ -133,12 +284,24 @@ impl Logger {
     ///
     /// To make that Logger useful, you need to call set_logfile() and set_loglevel().
     pub fn new() -> Logger {
+        Logger::with_queue_capacity(QUEUE_CAPACITY)
+    }
+
+    fn with_queue_capacity(capacity: usize) -> Logger {
         Logger {
-            files: Mutex::new(LogFiles {
-                logfile: None,
-                user_error_logfile: None,
+            shared: Arc::new(Shared {
+                files: Mutex::new(LogFiles {
+                    logfile: None,
+                    user_error_logfile: None,
+                }),
+                queue: RecordQueue::new(capacity),
+                dropped: AtomicUsize::new(0),
+                loglevel: AtomicUsize::new(Level::None as usize),
+                has_logfile: AtomicBool::new(false),
+                stop: AtomicBool::new(false),
+                flusher: OnceCell::new(),
             }),
-            loglevel: AtomicUsize::new(Level::None as usize),
+            flusher: Mutex::new(None),
         }
     }
 
@@ -147,7 +310,8 @@ impl Logger {
     /// The file will be created if it doesn't exist yet. It will be opened in the append mode, so
     /// its previous content will stay unchanged.
     ///
-    /// Calling this closes previously opened logfile, if any.
+    /// Calling this closes previously opened logfile, if any. Messages that were logged before
+    /// the call are written to the previous logfile.
     ///
     /// # Errors
     ///
@@ -158,11 +322,43 @@ impl Logger {
 
         match file {
             Ok(file) => {
-                let mut files = self.files.lock().expect("Someone poisoned logger's mutex");
+                let mut files = self
+                    .shared
+                    .files
+                    .lock()
+                    .expect("Someone poisoned logger's mutex");
+                self.shared.write_queued(&mut files);
                 files.logfile = Some(file);
+                self.shared.has_logfile.store(true, Ordering::Release);
             }
             Err(error) => eprintln!("Couldn't open `{}' as a logfile: {}", filename, error),
         }
+
+        self.start_flusher();
+    }
+
+    fn start_flusher(&self) {
+        let mut flusher = self
+            .flusher
+            .lock()
+            .expect("Someone poisoned logger's mutex");
+        if flusher.is_some() {
+            return;
+        }
+
+        let shared = Arc::clone(&self.shared);
+        let spawned = thread::Builder::new()
+            .name("logger".to_string())
+            .spawn(move || shared.run_flusher());
+        match spawned {
+            Ok(handle) => {
+                let _ = self.shared.flusher.set(handle.thread().clone());
+                *flusher = Some(handle);
+            }
+            // Messages still get written: by the next error, by flush(), or when the logger is
+            // dropped.
+            Err(error) => eprintln!("Couldn't start the logger thread: {}", error),
+        }
     }
 
     /// Specifies the file to which all Level::UserError messages will be written.
@@ -183,7 +379,11 @@ impl Logger {
 
         match file {
             Ok(file) => {
-                let mut files = self.files.lock().expect("Someone poisoned logger's mutex");
+                let mut files = self
+                    .shared
+                    .files
+                    .lock()
+                    .expect("Someone poisoned logger's mutex");
                 files.user_error_logfile = Some(file)
             }
             Err(error) => eprintln!(
@@ -220,42 +420,78 @@ impl Logger {
     /// Were you to check the return value of every log() call, you'd just stop writing logs.
     pub fn log_raw(&self, level: Level, data: &[u8]) {
         let timestamp = Local::now();
-        // DateTime::format() is extremely slow; format! is way faster. See
-        // https://github.com/chronotope/chrono/issues/94 for details.
-        let timestamp = format!(
-            "[{}-{:02}-{:02} {:02}:{:02}:{:02}] ",
-            timestamp.year(),
-            timestamp.month(),
-            timestamp.day(),
-            timestamp.hour(),
-            timestamp.minute(),
-            timestamp.second()
-        );
 
-        let mut files = self.files.lock().expect("Someone poisoned logger's mutex");
+        if level > Level::Error {
+            self.queue(level, timestamp, data);
+            return;
+        }
+
+        let data = truncate_message(data);
+        let mut files = self
+            .shared
+            .files
+            .lock()
+            .expect("Someone poisoned logger's mutex");
+        // Whatever was logged before this message has to go first
+        self.shared.write_queued(&mut files);
 
         if level as usize <= self.get_loglevel() {
             if let Some(ref mut logfile) = files.logfile {
-                let level = format!("{}: ", level);
-
+                let mut buffer = Vec::new();
+                append_line(&mut buffer, &timestamp, Some(level), &data);
                 // Ignoring the error since checking every log() call will be too bothersome.
-                let _ = logfile.write_all(timestamp.as_bytes());
-                let _ = logfile.write_all(level.as_bytes());
-                let _ = logfile.write_all(data);
-                let _ = logfile.write_all(b"\n");
+                let _ = logfile.write_all(&buffer);
             }
         }
 
         if level == Level::UserError {
             if let Some(ref mut user_error_logfile) = files.user_error_logfile {
+                let mut buffer = Vec::new();
+                append_line(&mut buffer, &timestamp, None, &data);
                 // Ignoring the error since checking every log() call will be too bothersome.
-                let _ = user_error_logfile.write_all(timestamp.as_bytes());
-                let _ = user_error_logfile.write_all(data);
-                let _ = user_error_logfile.write_all(b"\n");
+                let _ = user_error_logfile.write_all(&buffer);
             }
         }
     }
 
+    /// Puts a message into the queue, for the background thread to write out.
+    fn queue(&self, level: Level, timestamp: DateTime<Local>, data: &[u8]) {
+        if level as usize > self.get_loglevel() || !self.shared.has_logfile.load(Ordering::Acquire)
+        {
+            return;
+        }
+
+        let record = Record {
+            level,
+            timestamp,
+            message: truncate_message(data),
+        };
+        match self.shared.queue.push(record) {
+            Ok(position) => {
+                // Wake the background thread up early if the queue is filling up quickly
+                let quarter = self.shared.queue.capacity() / 4;
+                if quarter > 0 && position % quarter == quarter - 1 {
+                    if let Some(flusher) = self.shared.flusher.get() {
+                        flusher.unpark();
+                    }
+                }
+            }
+            Err(_) => {
+                self.shared.dropped.fetch_add(1, Ordering::Relaxed);
+            }
+        }
+    }
+
+    /// Writes out all the messages that are still queued.
+    pub fn flush(&self) {
+        let mut files = self
+            .shared
+            .files
+            .lock()
+            .expect("Someone poisoned logger's mutex");
+        self.shared.write_queued(&mut files);
+    }
+
     /// Sets maximum "importance level" of the messages that will be written to the log.
     ///
     /// For example, after the call to set_loglevel(Level::Error), only UserError, Critical, and
@@ -266,14 +502,14 @@ impl Logger {
     ///
     /// Calling this doesn't close already opened logs.
     pub fn set_loglevel(&self, level: Level) {
-        self.loglevel.store(level as usize, Ordering::SeqCst);
+        self.shared.loglevel.store(level as usize, Ordering::SeqCst);
     }
 
     /// Returns current maximum "importance level" of the messages that will be written to the log.
     ///
     /// For a more detailed explanation, see `set_loglevel()`.
     pub fn get_loglevel(&self) -> usize {
-        self.loglevel.load(Ordering::Relaxed)
+        self.shared.loglevel.load(Ordering::Relaxed)
     }
 }
 
@@ -283,14 +519,51 @@ impl Default for Logger {
     }
 }
 
+impl Drop for Logger {
+    fn drop(&mut self) {
+        self.shared.stop.store(true, Ordering::Release);
+        let flusher = match self.flusher.get_mut() {
+            Ok(flusher) => flusher.take(),
+            Err(_) => None,
+        };
+        if let Some(flusher) = flusher {
+            flusher.thread().unpark();
+            let _ = flusher.join();
+        }
+        // In case the thread couldn't be started
+        if let Ok(mut files) = self.shared.files.lock() {
+            self.shared.write_queued(&mut files);
+        }
+    }
+}
+
 static GLOBAL_LOGGER: OnceCell<Logger> = OnceCell::new();
 
+/// Writes out the messages that the global logger still has queued.
+///
+/// Statics are never dropped, so this is registered with atexit(3).
+extern "C" fn flush_global_logger() {
+    // Unwinding out of an atexit handler is undefined behaviour
+    let _ = panic::catch_unwind(|| {
+        if let Some(logger) = GLOBAL_LOGGER.get() {
+            if let Ok(mut files) = logger.shared.files.lock() {
+                logger.shared.write_queued(&mut files);
+            }
+        }
+    });
+}
+
 /// Returns a global logger instance.
 ///
 /// This logger exists for the duration of the program. It's better to set the loglevel and
 /// logfiles as early as possible, so no messages are lost.
 pub fn get_instance() -> &'static Logger {
-    GLOBAL_LOGGER.get_or_init(Logger::new)
+    GLOBAL_LOGGER.get_or_init(|| {
+        unsafe {
+            libc::atexit(flush_global_logger);
+        }
+        Logger::new()
+    })
 }
 
 /// Convenience macro for logging.
@@ -838,4 +1111,131 @@ mod tests {
             }
         }
     }
+
+    fn read_log_messages(logfile: &path::Path) -> Vec<(String, String)> {
+        let file = File::open(logfile).unwrap();
+        BufReader::new(file)
+            .lines()
+            .map(|line| {
+                let line = line.unwrap();
+                let (_timestamp, level, message) =
+                    parse_log_line(&line).expect("Failed to split the log line into parts");
+                (level.to_string(), message.to_string())
+            })
+            .collect()
+    }
+
+    #[test]
+    fn t_errors_are_written_right_away_after_queued_messages() {
+        let (_tmp, logfile, _error_logfile, logger) = setup_logger().unwrap();
+        logger.set_loglevel(Level::Debug);
+
+        logger.log(Level::Debug, "first");
+        logger.log(Level::Info, "second");
+        logger.log(Level::Error, "third");
+
+        // The logger is still alive, yet everything is already in the file
+        let messages = read_log_messages(&logfile);
+        let expected = vec![
+            ("DEBUG".to_string(), "first".to_string()),
+            ("INFO".to_string(), "second".to_string()),
+            ("ERROR".to_string(), "third".to_string()),
+        ];
+        assert_eq!(messages, expected);
+    }
+
+    #[test]
+    fn t_flush_writes_queued_messages() {
+        let (_tmp, logfile, _error_logfile, logger) = setup_logger().unwrap();
+        logger.set_loglevel(Level::Debug);
+
+        logger.log(Level::Debug, "hello");
+        logger.flush();
+
+        log_contains_n_lines(&logfile, 1).unwrap();
+    }
+
+    #[test]
+    fn t_long_messages_are_truncated() {
+        let (_tmp, logfile, _error_logfile, logger) = setup_logger().unwrap();
+        logger.set_loglevel(Level::Debug);
+
+        let long_message = "a".repeat(MAX_MESSAGE_LENGTH + 100);
+        logger.log(Level::Debug, &long_message);
+        logger.log(Level::Error, &long_message);
+        // Two-byte characters, one of which straddles the limit
+        let cyrillic = "я".repeat(MAX_MESSAGE_LENGTH / 2 + 10);
+        logger.log(Level::Debug, &format!("a{}", cyrillic));
+        drop(logger);
+
+        let expected = format!(
+            "{}... (100 more bytes)",
+            &long_message[..MAX_MESSAGE_LENGTH]
+        );
+        let messages = read_log_messages(&logfile);
+        assert_eq!(messages.len(), 3);
+        assert_eq!(messages[0].1, expected);
+        assert_eq!(messages[1].1, expected);
+
+        let expected = format!(
+            "a{}... (22 more bytes)",
+            "я".repeat(MAX_MESSAGE_LENGTH / 2 - 1)
+        );
+        assert_eq!(messages[2].1, expected);
+    }
+
+    #[test]
+    fn t_messages_that_dont_fit_into_the_queue_are_dropped_and_counted() {
+        let tmp = TempDir::new().unwrap();
+        let logfile = tmp.path().join("example.log");
+
+        let logger = Logger::with_queue_capacity(4);
+        logger.set_logfile(logfile.to_str().unwrap());
+        logger.set_loglevel(Level::Debug);
+
+        {
+            // Keeps the background thread from emptying the queue
+            let _files = logger.shared.files.lock().unwrap();
+            for i in 0..10 {
+                logger.log(Level::Debug, &format!("message {}", i));
+            }
+        }
+        drop(logger);
+
+        let messages = read_log_messages(&logfile);
+        let mut expected = vec![(
+            "WARNING".to_string(),
+            "Logger: dropped 6 messages because they were logged faster than they could be \
+             written"
+                .to_string(),
+        )];
+        for i in 0..4 {
+            expected.push(("DEBUG".to_string(), format!("message {}", i)));
+        }
+        assert_eq!(messages, expected);
+    }
+
+    #[test]
+    fn t_messages_from_many_threads_are_all_written() {
+        let (_tmp, logfile, _error_logfile, logger) = setup_logger().unwrap();
+        logger.set_loglevel(Level::Debug);
+
+        let logger = Arc::new(logger);
+        let threads = (0..4)
+            .map(|t| {
+                let logger = Arc::clone(&logger);
+                thread::spawn(move || {
+                    for i in 0..100 {
+                        logger.log(Level::Debug, &format!("thread {} message {}", t, i));
+                    }
+                })
+            })
+            .collect::<Vec<_>>();
+        for t in threads {
+            t.join().unwrap();
+        }
+        drop(logger);
+
+        log_contains_n_lines(&logfile, 400).unwrap();
+    }
 }
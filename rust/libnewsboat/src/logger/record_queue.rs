@@ -0,0 +1,227 @@
+//! A bounded queue that any number of threads can push to and pop from without taking a lock.
+//!
+//! This is Dmitry Vyukov's bounded MPMC queue. Every slot carries a sequence number, which tells
+//! whether the slot is ready to be written (it equals the position being pushed to) or read (it
+//! equals the position being popped from, plus one). Producers and consumers claim positions by
+//! bumping their counters with a compare-and-swap, so they never wait for each other; when the
+//! queue is full, `push()` fails right away instead of blocking.
+
+use std::cell::UnsafeCell;
+use std::mem::MaybeUninit;
+use std::sync::atomic::{AtomicUsize, Ordering};
+
+struct Slot<T> {
+    sequence: AtomicUsize,
+    value: UnsafeCell<MaybeUninit<T>>,
+}
+
+pub struct RecordQueue<T> {
+    slots: Box<[Slot<T>]>,
+    /// `slots.len() - 1`; the length is a power of two, so this turns positions into indices.
+    mask: usize,
+    enqueue_pos: AtomicUsize,
+    dequeue_pos: AtomicUsize,
+}
+
+// A value is only ever accessed by the one thread that claimed its slot, and the sequence numbers
+// make sure that a write is visible before the value is read.
+unsafe impl<T: Send> Send for RecordQueue<T> {}
+unsafe impl<T: Send> Sync for RecordQueue<T> {}
+
+impl<T> RecordQueue<T> {
+    /// Creates a queue that can hold at least `capacity` values. The capacity is rounded up to the
+    /// next power of two, and is at least 2.
+    pub fn new(capacity: usize) -> RecordQueue<T> {
+        let capacity = capacity.max(2).next_power_of_two();
+        let slots = (0..capacity)
+            .map(|i| Slot {
+                sequence: AtomicUsize::new(i),
+                value: UnsafeCell::new(MaybeUninit::uninit()),
+            })
+            .collect::<Vec<_>>()
+            .into_boxed_slice();
+
+        RecordQueue {
+            slots,
+            mask: capacity - 1,
+            enqueue_pos: AtomicUsize::new(0),
+            dequeue_pos: AtomicUsize::new(0),
+        }
+    }
+
+    pub fn capacity(&self) -> usize {
+        self.mask + 1
+    }
+
+    /// Adds `value` to the end of the queue, and returns the position it got. If the queue is
+    /// full, gives `value` back.
+    pub fn push(&self, value: T) -> Result<usize, T> {
+        let mut pos = self.enqueue_pos.load(Ordering::Relaxed);
+        loop {
+            let slot = &self.slots[pos & self.mask];
+            let sequence = slot.sequence.load(Ordering::Acquire);
+            let diff = sequence.wrapping_sub(pos) as isize;
+
+            if diff == 0 {
+                match self.enqueue_pos.compare_exchange_weak(
+                    pos,
+                    pos.wrapping_add(1),
+                    Ordering::Relaxed,
+                    Ordering::Relaxed,
+                ) {
+                    Ok(_) => {
+                        unsafe { (*slot.value.get()).as_mut_ptr().write(value) };
+                        slot.sequence.store(pos.wrapping_add(1), Ordering::Release);
+                        return Ok(pos);
+                    }
+                    Err(current) => pos = current,
+                }
+            } else if diff < 0 {
+                // The slot still holds a value from the previous lap: the queue is full.
+                return Err(value);
+            } else {
+                pos = self.enqueue_pos.load(Ordering::Relaxed);
+            }
+        }
+    }
+
+    /// Removes the value at the front of the queue, if any.
+    pub fn pop(&self) -> Option<T> {
+        let mut pos = self.dequeue_pos.load(Ordering::Relaxed);
+        loop {
+            let slot = &self.slots[pos & self.mask];
+            let sequence = slot.sequence.load(Ordering::Acquire);
+            let diff = sequence.wrapping_sub(pos.wrapping_add(1)) as isize;
+
+            if diff == 0 {
+                match self.dequeue_pos.compare_exchange_weak(
+                    pos,
+                    pos.wrapping_add(1),
+                    Ordering::Relaxed,
+                    Ordering::Relaxed,
+                ) {
+                    Ok(_) => {
+                        let value = unsafe { (*slot.value.get()).as_ptr().read() };
+                        slot.sequence
+                            .store(pos.wrapping_add(self.mask + 1), Ordering::Release);
+                        return Some(value);
+                    }
+                    Err(current) => pos = current,
+                }
+            } else if diff < 0 {
+                // Nothing was pushed to this slot yet: the queue is empty.
+                return None;
+            } else {
+                pos = self.dequeue_pos.load(Ordering::Relaxed);
+            }
+        }
+    }
+}
+
+impl<T> Drop for RecordQueue<T> {
+    fn drop(&mut self) {
+        while self.pop().is_some() {}
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::sync::Arc;
+    use std::thread;
+
+    #[test]
+    fn t_capacity_is_rounded_up_to_a_power_of_two() {
+        assert_eq!(RecordQueue::<u32>::new(0).capacity(), 2);
+        assert_eq!(RecordQueue::<u32>::new(3).capacity(), 4);
+        assert_eq!(RecordQueue::<u32>::new(4).capacity(), 4);
+        assert_eq!(RecordQueue::<u32>::new(1000).capacity(), 1024);
+    }
+
+    #[test]
+    fn t_values_are_popped_in_the_order_they_were_pushed() {
+        let queue = RecordQueue::new(4);
+        assert_eq!(queue.pop(), None);
+
+        for lap in 0..3 {
+            for i in 0..4 {
+                assert_eq!(queue.push(lap * 10 + i), Ok((lap * 4 + i) as usize));
+            }
+            for i in 0..4 {
+                assert_eq!(queue.pop(), Some(lap * 10 + i));
+            }
+            assert_eq!(queue.pop(), None);
+        }
+    }
+
+    #[test]
+    fn t_push_gives_the_value_back_if_the_queue_is_full() {
+        let queue = RecordQueue::new(2);
+        assert!(queue.push(String::from("one")).is_ok());
+        assert!(queue.push(String::from("two")).is_ok());
+        assert_eq!(
+            queue.push(String::from("three")),
+            Err(String::from("three"))
+        );
+
+        assert_eq!(queue.pop(), Some(String::from("one")));
+        assert!(queue.push(String::from("three")).is_ok());
+    }
+
+    #[test]
+    fn t_values_left_in_the_queue_are_dropped_with_it() {
+        let value = Arc::new(42);
+        {
+            let queue = RecordQueue::new(4);
+            queue.push(Arc::clone(&value)).unwrap();
+            queue.push(Arc::clone(&value)).unwrap();
+            assert_eq!(Arc::strong_count(&value), 3);
+        }
+        assert_eq!(Arc::strong_count(&value), 1);
+    }
+
+    #[test]
+    fn t_concurrent_producers_and_consumer_see_every_value_exactly_once() {
+        const THREADS: usize = 4;
+        const PER_THREAD: usize = 10_000;
+
+        let queue = Arc::new(RecordQueue::new(64));
+        let producers = (0..THREADS)
+            .map(|t| {
+                let queue = Arc::clone(&queue);
+                thread::spawn(move || {
+                    for i in 0..PER_THREAD {
+                        let mut value = t * PER_THREAD + i;
+                        while let Err(v) = queue.push(value) {
+                            value = v;
+                            thread::yield_now();
+                        }
+                    }
+                })
+            })
+            .collect::<Vec<_>>();
+
+        let mut seen = vec![false; THREADS * PER_THREAD];
+        let mut last_from_thread = vec![None; THREADS];
+        let mut received = 0;
+        while received < THREADS * PER_THREAD {
+            match queue.pop() {
+                Some(value) => {
+                    assert!(!seen[value]);
+                    seen[value] = true;
+                    // Values from a single producer keep their order.
+                    let t = value / PER_THREAD;
+                    assert!(last_from_thread[t].map_or(true, |last| last < value));
+                    last_from_thread[t] = Some(value);
+                    received += 1;
+                }
+                None => thread::yield_now(),
+            }
+        }
+
+        for producer in producers {
+            producer.join().unwrap();
+        }
+        assert_eq!(queue.pop(), None);
+    }
+}
@@ -10,7 +10,7 @@ use std::process::{Command, Stdio};
 use unicode_width::{UnicodeWidthChar, UnicodeWidthStr};
 use url::Url;
 
-pub fn replace_all(input: String, from: &str, to: &str) -> String {
+pub fn replace_all(input: &str, from: &str, to: &str) -> String {
     input.replace(from, to)
 }
 
@@ -213,13 +213,13 @@ pub fn get_default_browser() -> String {
     env::var("BROWSER").unwrap_or_else(|_| "lynx".to_string())
 }
 
-pub fn trim(rs_str: String) -> String {
-    rs_str.trim().to_string()
+pub fn trim(rs_str: &str) -> &str {
+    rs_str.trim()
 }
 
-pub fn trim_end(rs_str: String) -> String {
+pub fn trim_end(rs_str: &str) -> &str {
     let x: &[_] = &['\n', '\r'];
-    rs_str.trim_end_matches(x).to_string()
+    rs_str.trim_end_matches(x)
 }
 
 pub fn quote(input: String) -> String {
@@ -272,7 +272,29 @@ pub fn is_valid_attribute(attribute: &str) -> bool {
     VALID_ATTRIBUTES.contains(&attribute)
 }
 
+/// Returns `true` if `s` consists only of printable ASCII characters, i.e. characters that are
+/// exactly one column wide.
+fn is_printable_ascii(s: &str) -> bool {
+    fn is_printable(b: u8) -> bool {
+        b >= 0x20 && b < 0x7f
+    }
+
+    // Whole chunks are checked without short-circuiting, which lets the compiler vectorize the
+    // loop.
+    const CHUNK_SIZE: usize = 16;
+    let mut chunks = s.as_bytes().chunks_exact(CHUNK_SIZE);
+    for chunk in &mut chunks {
+        if !chunk.iter().fold(true, |acc, &b| acc & is_printable(b)) {
+            return false;
+        }
+    }
+    chunks.remainder().iter().all(|&b| is_printable(b))
+}
+
 pub fn strwidth(rs_str: &str) -> usize {
+    if is_printable_ascii(rs_str) {
+        return rs_str.len();
+    }
     UnicodeWidthStr::width(rs_str)
 }
 
@@ -288,6 +310,10 @@ pub fn strwidth(rs_str: &str) -> usize {
 /// assert_eq!(strwidth_stfl("ＡＢＣＤＥＦ"), 12);
 ///```
 pub fn strwidth_stfl(rs_str: &str) -> usize {
+    if !rs_str.contains('<') {
+        return strwidth(rs_str);
+    }
+
     let mut s = &rs_str[..];
     let mut width = 0;
     loop {
@@ -327,18 +353,23 @@ pub fn strwidth_stfl(rs_str: &str) -> usize {
 /// assert_eq!(substr_with_width("A\u{3042}B\u{3044}C\u{3046}", 5), "A\u{3042}B")
 ///```
 pub fn substr_with_width(string: &str, max_width: usize) -> String {
-    let mut result = String::new();
+    if is_printable_ascii(string) {
+        return string[..string.len().min(max_width)].to_owned();
+    }
+
+    // The result is always a prefix of `string`; we only need to find where it ends.
+    let mut end = 0;
     let mut width = 0;
-    for c in string.chars() {
+    for (idx, c) in string.char_indices() {
         // Control chars count as width 0
         let w = UnicodeWidthChar::width(c).unwrap_or(0);
         if width + w > max_width {
             break;
         }
         width += w;
-        result.push(c);
+        end = idx + c.len_utf8();
     }
-    result
+    string[..end].to_owned()
 }
 
 /// Returns a longest substring fits to the given width.
@@ -356,43 +387,37 @@ pub fn substr_with_width(string: &str, max_width: usize) -> String {
 /// assert_eq!(substr_with_width_stfl("A\u{3042}B\u{3044}C\u{3046}", 5), "A\u{3042}B")
 ///```
 pub fn substr_with_width_stfl(string: &str, max_width: usize) -> String {
-    let mut result = String::new();
-    let mut in_bracket = false;
-    let mut tagbuf = Vec::<char>::new();
+    // The result is always a prefix of `string`; we only need to find where it ends. A tag is
+    // either included in full or not at all.
+    let mut end = 0;
+    let mut tag_start = None;
     let mut width = 0;
-    for c in string.chars() {
-        if in_bracket {
-            tagbuf.push(c);
+    for (idx, c) in string.char_indices() {
+        if let Some(start) = tag_start {
             if c == '>' {
-                in_bracket = false;
-                if tagbuf == ['<', '>'] {
+                tag_start = None;
+                if idx == start + 1 {
+                    // escaped less-than
                     if width + 1 > max_width {
                         break;
                     }
-                    result += "<>"; // escaped less-than
-                    tagbuf.clear();
                     width += 1;
-                } else {
-                    result += &tagbuf.iter().collect::<String>();
-                    tagbuf.clear();
                 }
+                end = idx + 1;
             }
+        } else if c == '<' {
+            tag_start = Some(idx);
         } else {
-            if c == '<' {
-                in_bracket = true;
-                tagbuf.push(c);
-            } else {
-                // Control chars count as width 0
-                let w = UnicodeWidthChar::width(c).unwrap_or(0);
-                if width + w > max_width {
-                    break;
-                }
-                width += w;
-                result.push(c);
+            // Control chars count as width 0
+            let w = UnicodeWidthChar::width(c).unwrap_or(0);
+            if width + w > max_width {
+                break;
             }
+            width += w;
+            end = idx + c.len_utf8();
         }
     }
-    result
+    string[..end].to_owned()
 }
 
 /// Remove all soft-hyphens as they can behave unpredictably (see
@@ -764,30 +789,21 @@ mod tests {
 
     #[test]
     fn t_replace_all() {
-        assert_eq!(
-            replace_all(String::from("aaa"), "a", "b"),
-            String::from("bbb")
-        );
-        assert_eq!(
-            replace_all(String::from("aaa"), "aa", "ba"),
-            String::from("baa")
-        );
-        assert_eq!(
-            replace_all(String::from("aaaaaa"), "aa", "ba"),
-            String::from("bababa")
-        );
-        assert_eq!(replace_all(String::new(), "a", "b"), String::new());
+        assert_eq!(replace_all("aaa", "a", "b"), String::from("bbb"));
+        assert_eq!(replace_all("aaa", "aa", "ba"), String::from("baa"));
+        assert_eq!(replace_all("aaaaaa", "aa", "ba"), String::from("bababa"));
+        assert_eq!(replace_all("", "a", "b"), String::new());
 
         let input = String::from("aaaa");
-        assert_eq!(replace_all(input.clone(), "b", "c"), input);
+        assert_eq!(replace_all(&input, "b", "c"), input);
 
         assert_eq!(
-            replace_all(String::from("this is a normal test text"), " t", " T"),
+            replace_all("this is a normal test text", " t", " T"),
             String::from("this is a normal Test Text")
         );
 
         assert_eq!(
-            replace_all(String::from("o o o"), "o", "<o>"),
+            replace_all("o o o", "o", "<o>"),
             String::from("<o> <o> <o>")
         );
     }
@@ -887,15 +903,15 @@ mod tests {
 
     #[test]
     fn t_trim() {
-        assert_eq!(trim(String::from("  xxx\r\n")), "xxx");
-        assert_eq!(trim(String::from("\n\n abc  foobar\n")), "abc  foobar");
-        assert_eq!(trim(String::from("")), "");
-        assert_eq!(trim(String::from("     \n")), "");
+        assert_eq!(trim("  xxx\r\n"), "xxx");
+        assert_eq!(trim("\n\n abc  foobar\n"), "abc  foobar");
+        assert_eq!(trim(""), "");
+        assert_eq!(trim("     \n"), "");
     }
 
     #[test]
     fn t_trim_end() {
-        assert_eq!(trim_end(String::from("quux\n")), "quux");
+        assert_eq!(trim_end("quux\n"), "quux");
     }
 
     #[test]
@@ -965,6 +981,20 @@ mod tests {
         assert_eq!(strwidth_stfl("<a"), 0); // #415
     }
 
+    #[test]
+    fn t_strwidth_counts_printable_ascii_as_one_column_each() {
+        let long_ascii = "The quick brown fox jumps over the lazy dog. ".repeat(10);
+        assert_eq!(strwidth(&long_ascii), long_ascii.len());
+        assert_eq!(strwidth_stfl(&long_ascii), long_ascii.len());
+
+        // Non-printable and non-ASCII characters in the middle of a long string
+        let with_control = format!("{}\u{0007}{}", long_ascii, long_ascii);
+        assert_eq!(strwidth(&with_control), 2 * long_ascii.len());
+        let with_wide = format!("{}\u{F91F}{}", long_ascii, long_ascii);
+        assert_eq!(strwidth(&with_wide), 2 * long_ascii.len() + 2);
+        assert_eq!(strwidth("\u{007F}"), 0);
+    }
+
     #[test]
     fn t_substr_with_width_given_string_empty() {
         assert_eq!(substr_with_width("", 0), "");
@@ -1,5 +1,6 @@
 #include "cache.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cinttypes>
 #include <cstdlib>
@@ -168,6 +169,56 @@ static int vectorofstring_callback(void* vp, int argc, char** argv,
 	return 0;
 }
 
+static int outboxentry_callback(void* vp, int argc, char** argv,
+	char** /* azColName */)
+{
+	std::vector<OutboxEntry>* entries =
+		static_cast<std::vector<OutboxEntry>*>(vp);
+	assert(argc == 6);
+	assert(argv[0] != nullptr);
+	assert(argv[1] != nullptr);
+	assert(argv[2] != nullptr);
+
+	OutboxEntry entry;
+	entry.id = std::strtoll(argv[0], nullptr, 10);
+	entry.guid = argv[1];
+	entry.action = static_cast<OutboxAction>(std::atoi(argv[2]));
+	entry.oldflags = argv[3] ? argv[3] : "";
+	entry.newflags = argv[4] ? argv[4] : "";
+	entry.attempts = argv[5] ? std::strtoul(argv[5], nullptr, 10) : 0;
+	entries->push_back(std::move(entry));
+	return 0;
+}
+
+static int subscription_callback(void* vp, int argc, char** argv,
+	char** /* azColName */)
+{
+	auto subscriptions = static_cast<
+		std::vector<std::pair<std::string, std::vector<std::string>>>*>(vp);
+	assert(argc == 2);
+	assert(argv[0] != nullptr);
+
+	std::vector<std::string> tags;
+	if (argv[1] != nullptr && argv[1][0] != '\0') {
+		tags = utils::tokenize(argv[1], "\n");
+	}
+	subscriptions->emplace_back(argv[0], std::move(tags));
+	return 0;
+}
+
+static std::string join_ids(const std::vector<int64_t>& ids)
+{
+	std::string idset("(");
+	for (const auto id : ids) {
+		if (idset.length() > 1) {
+			idset.append(", ");
+		}
+		idset.append(std::to_string(id));
+	}
+	idset.append(")");
+	return idset;
+}
+
 static int rssitem_callback(void* myfeed, int argc, char** argv,
 	char** /* azColName */)
 {
@@ -380,6 +431,37 @@ static const schema_patches schemaPatches{
 
 			"INSERT INTO metadata VALUES ( 2, 11 );"
 		}
+	},
+	{	{2, 20},
+		{
+			"CREATE TABLE remote_outbox ( "
+			" id INTEGER PRIMARY KEY AUTOINCREMENT NOT NULL, "
+			" backend VARCHAR(32) NOT NULL, "
+			" guid VARCHAR(64) NOT NULL, "
+			" action INTEGER NOT NULL, "
+			" oldflags VARCHAR(52) NOT NULL DEFAULT \"\", "
+			" newflags VARCHAR(52) NOT NULL DEFAULT \"\", "
+			" attempts INTEGER NOT NULL DEFAULT 0, "
+			" next_attempt INTEGER NOT NULL DEFAULT 0 );",
+
+			"CREATE INDEX IF NOT EXISTS idx_outbox_guid ON "
+			"remote_outbox(backend, guid);",
+
+			"ALTER TABLE rss_feed ADD sync_token VARCHAR(128) NOT NULL "
+			"DEFAULT \"\";",
+
+			"ALTER TABLE rss_feed ADD last_full_sync INTEGER(11) NOT NULL "
+			"DEFAULT 0;",
+
+			"CREATE TABLE remote_subscriptions ( "
+			" backend VARCHAR(32) NOT NULL, "
+			" position INTEGER NOT NULL, "
+			" url TEXT NOT NULL, "
+			" tags TEXT NOT NULL DEFAULT \"\" );",
+
+			"UPDATE metadata SET db_schema_version_major = 2, "
+			"db_schema_version_minor = 20;",
+		}
 	}};
 
 void Cache::populate_tables()
@@ -464,6 +546,39 @@ void Cache::update_lastmodified(const std::string& feedurl,
 	run_sql_nothrow(query);
 }
 
+void Cache::fetch_sync_state(const std::string& feedurl,
+	std::string& token,
+	time_t& last_full_sync)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	std::string query = prepare_query(
+			"SELECT last_full_sync, sync_token FROM rss_feed "
+			"WHERE rssurl = '%q';",
+			feedurl);
+	HeaderValues result = {0, ""};
+	run_sql(query, lastmodified_callback, &result);
+	last_full_sync = result.lastmodified;
+	token = result.etag;
+	LOG(Level::DEBUG,
+		"Cache::fetch_sync_state: last_full_sync = %" PRId64 " token = %s",
+		static_cast<int64_t>(last_full_sync),
+		token);
+}
+
+void Cache::update_sync_state(const std::string& feedurl,
+	const std::string& token,
+	time_t last_full_sync)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	const std::string query = prepare_query(
+			"UPDATE rss_feed SET sync_token = '%q', last_full_sync = %s "
+			"WHERE rssurl = '%q';",
+			token,
+			std::to_string(last_full_sync),
+			feedurl);
+	run_sql_nothrow(query);
+}
+
 void Cache::mark_item_deleted(const std::string& guid, bool b)
 {
 	std::lock_guard<std::mutex> lock(mtx);
@@ -547,13 +662,29 @@ void Cache::externalize_rssfeed(std::shared_ptr<RssFeed> feed,
 	unsigned int days = cfg->get_configvalue_as_int("keep-articles-days");
 	time_t old_time = time(nullptr) - days * 24 * 60 * 60;
 
+	// Read state changes that are still in the remote outbox are newer than
+	// what the server sent us
+	std::vector<std::string> unsent;
+	run_sql(prepare_query(
+			"SELECT DISTINCT guid FROM remote_outbox WHERE action IN (%u, %u);",
+			static_cast<unsigned int>(OutboxAction::MARK_UNREAD),
+			static_cast<unsigned int>(OutboxAction::MARK_READ)),
+		vectorofstring_callback,
+		&unsent);
+	const std::unordered_set<std::string> unsent_read_state(
+		unsent.begin(), unsent.end());
+
 	// the reverse iterator is there for the sorting foo below (think about
 	// it)
 	for (auto it = feed->items().rbegin(); it != feed->items().rend();
 		++it) {
-		if (days == 0 || (*it)->pubDate_timestamp() >= old_time)
-			update_rssitem_unlocked(
-				*it, feed->rssurl(), reset_unread);
+		if (days == 0 || (*it)->pubDate_timestamp() >= old_time) {
+			update_rssitem_unlocked(*it,
+				feed->rssurl(),
+				reset_unread,
+				unsent_read_state);
+			m1.add_counter("items", 1);
+		}
 	}
 }
 
@@ -604,23 +735,22 @@ std::shared_ptr<RssFeed> Cache::internalize_rssfeed(std::string rssurl,
 
 	if (ign != nullptr) {
 		auto& items = feed->items();
-		items.erase(
-			std::remove_if(
+		const auto ignored = std::stable_partition(
 				items.begin(),
 				items.end(),
 		[&](std::shared_ptr<RssItem> item) -> bool {
 			try
 			{
-				return ign->matches(item.get());
+				return !ign->matches(item.get());
 			} catch (const MatcherException& ex)
 			{
 				LOG(Level::DEBUG,
 					"oops, Matcher exception: %s",
 					ex.what());
-				return false;
+				return true;
 			}
-		}),
-		items.end());
+		});
+		feed->erase_items(ignored, items.end());
 	}
 
 	auto feed_weak_ptr = std::weak_ptr<RssFeed>(feed);
@@ -797,7 +927,8 @@ void Cache::cleanup_cache(std::vector<std::shared_ptr<RssFeed>>& feeds)
 
 void Cache::update_rssitem_unlocked(std::shared_ptr<RssItem> item,
 	const std::string& feedurl,
-	bool reset_unread)
+	bool reset_unread,
+	const std::unordered_set<std::string>& unsent_read_state)
 {
 	std::string query = prepare_query(
 			"SELECT count(*) FROM rss_item WHERE guid = '%q';",
@@ -827,7 +958,8 @@ void Cache::update_rssitem_unlocked(std::shared_ptr<RssItem> item,
 			}
 		}
 		std::string update;
-		if (item->override_unread()) {
+		if (item->override_unread() &&
+			unsent_read_state.count(item->guid()) == 0) {
 			update = prepare_query(
 					"UPDATE rss_item "
 					"SET title = '%q', author = '%q', url = '%q', "
@@ -1059,6 +1191,131 @@ std::vector<std::string> Cache::get_read_item_guids()
 	return guids;
 }
 
+void Cache::outbox_add_read_state(const std::string& backend,
+	const std::string& guid,
+	bool read)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+
+	run_sql(prepare_query(
+			"DELETE FROM remote_outbox WHERE backend = '%q' AND guid = '%q' "
+			"AND action IN (%u, %u);",
+			backend,
+			guid,
+			static_cast<unsigned int>(OutboxAction::MARK_UNREAD),
+			static_cast<unsigned int>(OutboxAction::MARK_READ)));
+
+	const auto action =
+		read ? OutboxAction::MARK_READ : OutboxAction::MARK_UNREAD;
+	run_sql(prepare_query(
+			"INSERT INTO remote_outbox (backend, guid, action) "
+			"VALUES ('%q', '%q', %u);",
+			backend,
+			guid,
+			static_cast<unsigned int>(action)));
+}
+
+void Cache::outbox_add_flags(const std::string& backend,
+	const std::string& guid,
+	const std::string& oldflags,
+	const std::string& newflags)
+{
+	if (oldflags == newflags) {
+		return;
+	}
+
+	// If an earlier change is waiting for a retry, this one has to wait as
+	// well, or it would reach the server first
+	std::lock_guard<std::mutex> lock(mtx);
+	run_sql(prepare_query(
+			"INSERT INTO remote_outbox "
+			"(backend, guid, action, oldflags, newflags, next_attempt) "
+			"VALUES ('%q', '%q', %u, '%q', '%q', "
+			"(SELECT IFNULL(MAX(next_attempt), 0) FROM remote_outbox "
+			"WHERE backend = '%q' AND guid = '%q' AND action = %u));",
+			backend,
+			guid,
+			static_cast<unsigned int>(OutboxAction::UPDATE_FLAGS),
+			oldflags,
+			newflags,
+			backend,
+			guid,
+			static_cast<unsigned int>(OutboxAction::UPDATE_FLAGS)));
+}
+
+void Cache::outbox_remove_read_state(const std::string& backend,
+	const std::string& feedurl)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	run_sql(prepare_query(
+			"DELETE FROM remote_outbox "
+			"WHERE backend = '%q' AND action IN (%u, %u) AND guid IN "
+			"(SELECT guid FROM rss_item WHERE feedurl = '%q');",
+			backend,
+			static_cast<unsigned int>(OutboxAction::MARK_UNREAD),
+			static_cast<unsigned int>(OutboxAction::MARK_READ),
+			feedurl));
+}
+
+std::vector<OutboxEntry> Cache::outbox_get_due(const std::string& backend,
+	time_t now)
+{
+	std::vector<OutboxEntry> entries;
+	const std::string query = prepare_query(
+			"SELECT id, guid, action, oldflags, newflags, attempts "
+			"FROM remote_outbox "
+			"WHERE backend = '%q' AND next_attempt <= %s ORDER BY id;",
+			backend,
+			std::to_string(now));
+
+	std::lock_guard<std::mutex> lock(mtx);
+	run_sql(query, outboxentry_callback, &entries);
+	return entries;
+}
+
+nonstd::optional<time_t> Cache::outbox_next_due(const std::string& backend)
+{
+	std::string result;
+	const std::string query = prepare_query(
+			"SELECT MIN(next_attempt) FROM remote_outbox "
+			"WHERE backend = '%q';",
+			backend);
+
+	std::lock_guard<std::mutex> lock(mtx);
+	run_sql(query, single_string_callback, &result);
+	if (result.empty()) {
+		return nonstd::nullopt;
+	}
+	return static_cast<time_t>(std::strtoll(result.c_str(), nullptr, 10));
+}
+
+void Cache::outbox_remove(const std::vector<int64_t>& ids)
+{
+	if (ids.empty()) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mtx);
+	run_sql(prepare_query("DELETE FROM remote_outbox WHERE id IN %s;",
+			join_ids(ids)));
+}
+
+void Cache::outbox_postpone(const std::vector<int64_t>& ids,
+	time_t next_attempt)
+{
+	if (ids.empty()) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mtx);
+	run_sql(prepare_query(
+			"UPDATE remote_outbox "
+			"SET attempts = attempts + 1, next_attempt = %s "
+			"WHERE id IN %s;",
+			std::to_string(next_attempt),
+			join_ids(ids)));
+}
+
 void Cache::clean_old_articles()
 {
 	std::lock_guard<std::mutex> lock(mtx);
@@ -1137,4 +1394,54 @@ SchemaVersion Cache::get_schema_version()
 	return result;
 }
 
+std::vector<std::pair<std::string, std::vector<std::string>>>
+	Cache::get_remote_subscriptions(const std::string& backend)
+{
+	std::vector<std::pair<std::string, std::vector<std::string>>> result;
+	const std::string query = prepare_query(
+			"SELECT url, tags FROM remote_subscriptions "
+			"WHERE backend = '%q' ORDER BY position;",
+			backend);
+
+	std::lock_guard<std::mutex> lock(mtx);
+	run_sql(query, subscription_callback, &result);
+	return result;
+}
+
+void Cache::set_remote_subscriptions(const std::string& backend,
+	const std::vector<std::pair<std::string, std::vector<std::string>>>&
+	subscriptions)
+{
+	std::string query = prepare_query(
+			"BEGIN; DELETE FROM remote_subscriptions WHERE backend = '%q';",
+			backend);
+	unsigned int position = 0;
+	for (const auto& subscription : subscriptions) {
+		std::string tags;
+		for (const auto& tag : subscription.second) {
+			if (!tags.empty()) {
+				tags.push_back('\n');
+			}
+			tags.append(tag);
+		}
+		query += prepare_query(
+				"INSERT INTO remote_subscriptions "
+				"(backend, position, url, tags) "
+				"VALUES ('%q', %u, '%q', '%q');",
+				backend,
+				position++,
+				subscription.first,
+				tags);
+	}
+	query += "COMMIT;";
+
+	std::lock_guard<std::mutex> lock(mtx);
+	try {
+		run_sql(query);
+	} catch (const DbException&) {
+		run_sql_nothrow("ROLLBACK;");
+		throw;
+	}
+}
+
 } // namespace newsboat
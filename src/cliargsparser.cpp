@@ -74,6 +74,20 @@ extern "C" {
 	bool rs_cliargsparser_set_log_level(void* rs_cliargsparser);
 
 	unsigned char rs_cliargsparser_log_level(void* rs_cliargsparser);
+
+	bool rs_cliargsparser_set_trace_file(void* rs_cliargsparser);
+
+	char* rs_cliargsparser_trace_file(void* rs_cliargsparser);
+
+	bool rs_cliargsparser_set_record_http(void* rs_cliargsparser);
+
+	char* rs_cliargsparser_record_http(void* rs_cliargsparser);
+
+	bool rs_cliargsparser_set_replay_http(void* rs_cliargsparser);
+
+	char* rs_cliargsparser_replay_http(void* rs_cliargsparser);
+
+	bool rs_cliargsparser_replay_http_timing(void* rs_cliargsparser);
 }
 
 #define GET_VALUE(NAME, DEFAULT) \
@@ -256,6 +270,26 @@ nonstd::optional<Level> CliArgsParser::log_level() const
 	}
 }
 
+nonstd::optional<std::string> CliArgsParser::trace_file() const
+{
+	GET_OPTIONAL_STRING(set_trace_file, trace_file);
+}
+
+nonstd::optional<std::string> CliArgsParser::record_http() const
+{
+	GET_OPTIONAL_STRING(set_record_http, record_http);
+}
+
+nonstd::optional<std::string> CliArgsParser::replay_http() const
+{
+	GET_OPTIONAL_STRING(set_replay_http, replay_http);
+}
+
+bool CliArgsParser::replay_http_timing() const
+{
+	GET_VALUE(replay_http_timing, false);
+}
+
 void* CliArgsParser::get_rust_pointer() const
 {
 	return rs_cliargsparser;
@@ -213,6 +213,7 @@ ConfigContainer::ConfigContainer()
 		ConfigData("false", ConfigDataType::BOOL)},
 	{"reload-threads", ConfigData("1", ConfigDataType::INT)},
 	{"reload-time", ConfigData("60", ConfigDataType::INT)},
+	{"remote-full-sync-interval", ConfigData("720", ConfigDataType::INT)},
 	{"save-path", ConfigData("~/", ConfigDataType::PATH)},
 	{
 		"search-highlight-colors",
@@ -50,6 +50,8 @@
 #include "opmlurlreader.h"
 #include "regexmanager.h"
 #include "remoteapi.h"
+#include "rss/exception.h"
+#include "rss/httparchive.h"
 #include "rssfeed.h"
 #include "rssparser.h"
 #include "scopemeasure.h"
@@ -87,6 +89,12 @@ Controller::Controller(ConfigPaths& configpaths)
 
 Controller::~Controller()
 {
+	// Both use the cache and the API from their background threads, so
+	// they have to go first. The outbox is started by the subscriptions'
+	// thread, so that one goes before it.
+	subscriptions.reset();
+	outbox.reset();
+
 	delete rsscache;
 	delete urlcfg;
 	delete api;
@@ -116,6 +124,10 @@ int Controller::run(const CliArgsParser& args)
 		Logger::set_loglevel(args.log_level().value());
 	}
 
+	if (args.trace_file().has_value()) {
+		ScopeMeasure::start_tracing(args.trace_file().value());
+	}
+
 	if (!args.display_msg().empty()) {
 		std::cerr << args.display_msg() << std::endl;
 	}
@@ -124,6 +136,18 @@ int Controller::run(const CliArgsParser& args)
 		return args.return_code().value();
 	}
 
+	try {
+		if (args.record_http().has_value()) {
+			rsspp::HttpArchive::start_recording(args.record_http().value());
+		} else if (args.replay_http().has_value()) {
+			rsspp::HttpArchive::start_replaying(args.replay_http().value(),
+				args.replay_http_timing());
+		}
+	} catch (const rsspp::Exception& e) {
+		std::cerr << strprintf::fmt(_("Error: %s"), e.what()) << std::endl;
+		return EXIT_FAILURE;
+	}
+
 	const auto migrated = configpaths.try_migrate_from_newsbeuter();
 	if (migrated) {
 		std::cerr << "\nPlease check the results and press Enter to "
@@ -304,9 +328,23 @@ int Controller::run(const CliArgsParser& args)
 		std::cout.flush();
 	}
 	if (api) {
-		if (!api->authenticate()) {
-			std::cout << "Authentication failed." << std::endl;
-			return EXIT_FAILURE;
+		outbox.reset(new RemoteOutbox(rsscache, api, type));
+		subscriptions.reset(new RemoteSubscriptions(rsscache, api, type));
+
+		// Exporting is the only thing that needs the subscriptions to be
+		// up to date before we go on; everything else can start with the
+		// ones from the previous run, and only has to wait for the server
+		// once it's about to reload feeds.
+		if (!args.do_export() && subscriptions->use_cached()) {
+			subscriptions->start_revalidation([this]() {
+				outbox->start();
+			});
+		} else {
+			if (!subscriptions->revalidate()) {
+				std::cout << "Authentication failed." << std::endl;
+				return EXIT_FAILURE;
+			}
+			outbox->start();
 		}
 	}
 	urlcfg->reload();
@@ -526,11 +564,12 @@ void Controller::mark_all_read(const std::string& feedurl)
 		return;
 	}
 
+	wait_for_subscriptions(false);
 	if (feedurl.empty()) { // Mark all feeds as read
 		if (api) {
 			std::lock_guard<std::mutex> feedslock(feeds_mutex);
 			for (const auto& feed : feedcontainer.feeds) {
-				api->mark_all_read(feed->rssurl());
+				outbox->mark_all_read(feed->rssurl());
 			}
 		}
 		feedcontainer.mark_all_feeds_read();
@@ -542,7 +581,7 @@ void Controller::mark_all_read(const std::string& feedurl)
 		}
 
 		if (api) {
-			api->mark_all_read(feed->rssurl());
+			outbox->mark_all_read(feed->rssurl());
 		}
 
 		feed->mark_all_items_read();
@@ -551,8 +590,8 @@ void Controller::mark_all_read(const std::string& feedurl)
 
 void Controller::mark_article_read(const std::string& guid, bool read)
 {
-	if (api) {
-		api->mark_article_read(guid, read);
+	if (outbox) {
+		outbox->mark_article_read(guid, read);
 	}
 }
 
@@ -560,6 +599,7 @@ void Controller::mark_all_read(unsigned int pos)
 {
 	if (pos < feedcontainer.feeds.size()) {
 		ScopeMeasure m("Controller::mark_all_read");
+		wait_for_subscriptions(false);
 		std::lock_guard<std::mutex> feedslock(feeds_mutex);
 		const auto feed = feedcontainer.get_feed(pos);
 		if (feed->is_query_feed()) {
@@ -567,7 +607,7 @@ void Controller::mark_all_read(unsigned int pos)
 		} else {
 			rsscache->mark_all_read(feed->rssurl());
 			if (api) {
-				api->mark_all_read(feed->rssurl());
+				outbox->mark_all_read(feed->rssurl());
 			}
 		}
 		m.stopover(
@@ -677,8 +717,31 @@ void Controller::enqueue_url(std::shared_ptr<RssItem> item,
 	queueManager.enqueue_url(item, feed);
 }
 
+void Controller::wait_for_subscriptions(bool apply_changes)
+{
+	if (!subscriptions) {
+		return;
+	}
+
+	subscriptions->wait_for_revalidation();
+	if (subscriptions->authentication_failed()) {
+		v->show_error(_("Error: authentication with the server failed."));
+	}
+	if (apply_changes && subscriptions->subscriptions_changed()) {
+		LOG(Level::INFO,
+			"Controller::wait_for_subscriptions: remote subscriptions "
+			"changed, reloading them");
+		reload_urls_file();
+	}
+}
+
 void Controller::reload_urls_file()
 {
+	if (subscriptions) {
+		// Whatever the revalidation found is picked up by the reload below
+		subscriptions->wait_for_revalidation();
+		subscriptions->subscriptions_changed();
+	}
 	urlcfg->reload();
 	std::vector<std::shared_ptr<RssFeed>> new_feeds;
 	unsigned int i = 0;
@@ -711,11 +774,13 @@ void Controller::reload_urls_file()
 		i++;
 	}
 
+	// This runs on the reload thread if the remote subscriptions changed,
+	// so the swap has to be atomic with respect to replace_feed() & co.
+	std::lock_guard<std::mutex> feedslock(feeds_mutex);
 	v->set_tags(urlcfg->get_alltags());
-
 	feedcontainer.set_feeds(new_feeds);
 	feedcontainer.sort_feeds(cfg.get_feed_sort_strategy());
-	update_feedlist();
+	v->set_feedlist(feedcontainer.feeds);
 }
 
 void Controller::edit_urls_file()
@@ -898,8 +963,8 @@ void Controller::dump_config(const std::string& filename)
 
 void Controller::update_flags(std::shared_ptr<RssItem> item)
 {
-	if (api) {
-		api->update_article_flags(
+	if (outbox) {
+		outbox->update_article_flags(
 			item->oldflags(), item->flags(), item->guid());
 	}
 	item->update_flags();
@@ -0,0 +1,474 @@
+#include "downloadscheduler.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <libgen.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "logger.h"
+#include "utils.h"
+
+using namespace newsboat;
+
+namespace {
+
+/// How much of its share of `max-download-speed` a transfer can save up
+/// while it isn't receiving anything. Keeps the total speed from spiking
+/// once it does.
+const double BURST_SECONDS = 0.5;
+
+} // namespace
+
+namespace podboat {
+
+const std::chrono::milliseconds DownloadScheduler::TICK(100);
+
+struct DownloadScheduler::Transfer {
+	Download* dl;
+	CURL* handle;
+	std::ofstream f;
+	std::string filename;
+	bool resumed_download;
+	bool paused;
+	bool limited;
+	/// Bytes this transfer may still receive before it's paused. Goes
+	/// negative when curl hands over more than that at once.
+	double tokens;
+	std::chrono::steady_clock::time_point started;
+	size_t bytecount;
+};
+
+DownloadScheduler::DownloadScheduler(newsboat::ConfigContainer* cfg)
+	: cfg(cfg)
+	, multi_handle(curl_multi_init())
+	, last_refill(std::chrono::steady_clock::now())
+	, bytes_per_second(0)
+	, next_order(0)
+	, max_parallel(1)
+	, stopping(false)
+{
+	const int max_dl_speed = cfg->get_configvalue_as_int("max-download-speed");
+	if (max_dl_speed > 0) {
+		bytes_per_second = max_dl_speed * 1024.0;
+	}
+}
+
+DownloadScheduler::~DownloadScheduler()
+{
+	stop();
+	curl_multi_cleanup(multi_handle);
+}
+
+void DownloadScheduler::enqueue(Download* dl, DlPriority priority)
+{
+	{
+		std::lock_guard<std::mutex> guard(mtx);
+		for (auto& queued : queue) {
+			if (queued.dl == dl) {
+				queued.priority = std::max(queued.priority, priority);
+				// Might have been deleted while it was waiting
+				if (!has_transfer(dl)) {
+					dl->set_status(DlStatus::QUEUED);
+				}
+				return;
+			}
+		}
+
+		// A cancelled transfer keeps running until the scheduler thread
+		// notices. The download stays cancelled until then, so that the
+		// transfer does stop, and finish_transfer() queues it again.
+		if (has_transfer(dl)) {
+			if (dl->status() == DlStatus::CANCELLED) {
+				queue.push_back({dl, priority, next_order++});
+			}
+			return;
+		}
+
+		dl->set_status(DlStatus::QUEUED);
+		queue.push_back({dl, priority, next_order++});
+
+		if (!thread.joinable()) {
+			stopping = false;
+			thread = std::thread(&DownloadScheduler::run, this);
+		}
+	}
+	queue_cv.notify_all();
+}
+
+void DownloadScheduler::set_max_parallel(unsigned int max)
+{
+	{
+		std::lock_guard<std::mutex> guard(mtx);
+		max_parallel = std::max(max, 1u);
+	}
+	queue_cv.notify_all();
+}
+
+void DownloadScheduler::stop()
+{
+	{
+		std::lock_guard<std::mutex> guard(mtx);
+		stopping = true;
+		queue.clear();
+	}
+	queue_cv.notify_all();
+
+	if (thread.joinable()) {
+		thread.join();
+	}
+}
+
+double DownloadScheduler::share_bandwidth(std::vector<double>& tokens,
+	double budget,
+	double cap)
+{
+	std::vector<std::size_t> hungry;
+	for (std::size_t i = 0; i < tokens.size(); i++) {
+		if (tokens[i] < cap) {
+			hungry.push_back(i);
+		}
+	}
+
+	while (budget > 0 && !hungry.empty()) {
+		const double share = budget / hungry.size();
+		budget = 0;
+
+		std::vector<std::size_t> still_hungry;
+		for (const auto i : hungry) {
+			tokens[i] += share;
+			if (tokens[i] >= cap) {
+				budget += tokens[i] - cap;
+				tokens[i] = cap;
+			} else {
+				still_hungry.push_back(i);
+			}
+		}
+		hungry.swap(still_hungry);
+	}
+
+	return budget;
+}
+
+void DownloadScheduler::refill(std::vector<double>& tokens,
+	double bytes_per_second,
+	double elapsed)
+{
+	if (tokens.empty()) {
+		return;
+	}
+
+	const double cap = bytes_per_second * BURST_SECONDS / tokens.size();
+	share_bandwidth(tokens, bytes_per_second * elapsed, cap);
+}
+
+size_t DownloadScheduler::write_callback(void* buffer,
+	size_t size,
+	size_t nmemb,
+	void* userp)
+{
+	Transfer* transfer = static_cast<Transfer*>(userp);
+	if (transfer->dl->status() == DlStatus::CANCELLED) {
+		return 0;
+	}
+
+	// curl keeps the data and hands it over again once we unpause
+	if (transfer->limited && transfer->tokens <= 0) {
+		transfer->paused = true;
+		return CURL_WRITEFUNC_PAUSE;
+	}
+
+	const size_t bytes = size * nmemb;
+	transfer->f.write(static_cast<char*>(buffer), bytes);
+	transfer->tokens -= bytes;
+	transfer->bytecount += bytes;
+	LOG(Level::DEBUG,
+		"DownloadScheduler::write_callback: bad = %u size = %" PRIu64,
+		transfer->f.bad(),
+		static_cast<uint64_t>(bytes));
+	return transfer->f.bad() ? 0 : bytes;
+}
+
+int DownloadScheduler::progress_callback(void* clientp,
+	double dltotal,
+	double dlnow,
+	double /* ultotal */,
+	double /* ulnow */)
+{
+	Transfer* transfer = static_cast<Transfer*>(clientp);
+	if (transfer->dl->status() == DlStatus::CANCELLED) {
+		return -1;
+	}
+
+	using fpseconds = std::chrono::duration<double>;
+	const double elapsed = std::chrono::duration_cast<fpseconds>(
+			std::chrono::steady_clock::now() - transfer->started).count();
+	if (elapsed > 0) {
+		transfer->dl->set_kbps((transfer->bytecount / elapsed) / 1024);
+	}
+	transfer->dl->set_progress(dlnow, dltotal);
+	return 0;
+}
+
+void DownloadScheduler::run()
+{
+	std::unique_lock<std::mutex> lock(mtx);
+	while (!stopping) {
+		start_queued();
+
+		if (transfers.empty()) {
+			queue_cv.wait(lock, [this]() {
+				return stopping || !queue.empty();
+			});
+			continue;
+		}
+		lock.unlock();
+
+		refill_tokens();
+
+		int still_running = 0;
+		curl_multi_perform(multi_handle, &still_running);
+
+		// The messages don't survive removing their handles, so they have
+		// to be read before finishing any transfer
+		std::vector<std::pair<Transfer*, CURLcode>> finished;
+		int msgs_left = 0;
+		while (CURLMsg* msg = curl_multi_info_read(multi_handle, &msgs_left)) {
+			if (msg->msg != CURLMSG_DONE) {
+				continue;
+			}
+			for (const auto& transfer : transfers) {
+				if (transfer->handle == msg->easy_handle) {
+					finished.push_back({transfer.get(), msg->data.result});
+				}
+			}
+		}
+		// Paused transfers don't call back, so they have to be checked here
+		for (const auto& transfer : transfers) {
+			const bool done = std::any_of(finished.begin(), finished.end(),
+			[&](const std::pair<Transfer*, CURLcode>& f) {
+				return f.first == transfer.get();
+			});
+			if (!done && transfer->dl->status() == DlStatus::CANCELLED) {
+				finished.push_back({transfer.get(), CURLE_ABORTED_BY_CALLBACK});
+			}
+		}
+		for (const auto& f : finished) {
+			finish_transfer(f.first, f.second);
+		}
+
+		curl_multi_wait(multi_handle, nullptr, 0, TICK.count(), nullptr);
+
+		lock.lock();
+	}
+	lock.unlock();
+
+	while (!transfers.empty()) {
+		Transfer* transfer = transfers.front().get();
+		LOG(Level::INFO,
+			"DownloadScheduler::run: cancelling download of %s",
+			transfer->dl->url());
+		transfer->dl->set_status(DlStatus::CANCELLED);
+		finish_transfer(transfer, CURLE_ABORTED_BY_CALLBACK);
+	}
+}
+
+void DownloadScheduler::start_queued()
+{
+	// Highest priority first, then in the order they were queued
+	std::sort(queue.begin(), queue.end(),
+	[](const QueuedDownload& a, const QueuedDownload& b) {
+		if (a.priority != b.priority) {
+			return a.priority > b.priority;
+		}
+		return a.order < b.order;
+	});
+
+	auto it = queue.begin();
+	while (it != queue.end()) {
+		if (it->priority != DlPriority::HIGH &&
+			transfers.size() >= max_parallel) {
+			break;
+		}
+
+		// Cancelled and queued again, but the old transfer hasn't stopped yet
+		if (has_transfer(it->dl)) {
+			++it;
+			continue;
+		}
+
+		Download* dl = it->dl;
+		it = queue.erase(it);
+
+		// Might have been deleted while it was waiting
+		if (dl->status() == DlStatus::QUEUED) {
+			start_transfer(dl);
+		}
+	}
+}
+
+bool DownloadScheduler::is_queued(const Download* dl) const
+{
+	return std::any_of(queue.begin(), queue.end(),
+	[dl](const QueuedDownload& queued) {
+		return queued.dl == dl;
+	});
+}
+
+bool DownloadScheduler::has_transfer(const Download* dl) const
+{
+	return std::any_of(transfers.begin(), transfers.end(),
+	[dl](const std::unique_ptr<Transfer>& transfer) {
+		return transfer->dl == dl;
+	});
+}
+
+bool DownloadScheduler::start_transfer(Download* dl)
+{
+	std::unique_ptr<Transfer> transfer(new Transfer());
+	transfer->dl = dl;
+	transfer->filename =
+		dl->filename() + newsboat::ConfigContainer::PARTIAL_FILE_SUFFIX;
+	transfer->paused = false;
+	// curl can't pause local files, which don't take any bandwidth anyway
+	transfer->limited = bytes_per_second > 0 &&
+		dl->url().compare(0, 7, "file://") != 0;
+	transfer->tokens = 0;
+	transfer->started = std::chrono::steady_clock::now();
+	transfer->bytecount = 0;
+
+	CURL* easyhandle = curl_easy_init();
+	transfer->handle = easyhandle;
+	utils::set_common_curl_options(easyhandle, cfg);
+
+	curl_easy_setopt(easyhandle, CURLOPT_URL, dl->url().c_str());
+	curl_easy_setopt(easyhandle, CURLOPT_TIMEOUT, 0);
+	// set up write functions:
+	curl_easy_setopt(easyhandle, CURLOPT_WRITEFUNCTION, write_callback);
+	curl_easy_setopt(easyhandle, CURLOPT_WRITEDATA, transfer.get());
+
+	// set up progress notification:
+	curl_easy_setopt(easyhandle, CURLOPT_NOPROGRESS, 0);
+	curl_easy_setopt(
+		easyhandle, CURLOPT_PROGRESSFUNCTION, progress_callback);
+	curl_easy_setopt(easyhandle, CURLOPT_PROGRESSDATA, transfer.get());
+
+	struct stat sb;
+	if (stat(transfer->filename.c_str(), &sb) == -1) {
+		LOG(Level::INFO,
+			"DownloadScheduler::start_transfer: stat failed: starting "
+			"normal download");
+
+		// Have to copy the string into a vector in order to be able to
+		// get a char* pointer. std::string::c_str() won't do because it
+		// returns const char*, whereas ::dirname() needs non-const.
+		std::vector<char> directory(
+			transfer->filename.begin(), transfer->filename.end());
+		directory.push_back('\0');
+		utils::mkdir_parents(dirname(&directory[0]));
+
+		transfer->f.open(transfer->filename, std::fstream::out);
+		dl->set_offset(0);
+		transfer->resumed_download = false;
+	} else {
+		LOG(Level::INFO,
+			"DownloadScheduler::start_transfer: stat ok: starting download "
+			"from %" PRIi64,
+			// That field is `long int`, which is at least 32 bits. On x86_64,
+			// it's 64 bits. Thus, this cast is either a no-op, or an up-cast
+			// which are always safe.
+			static_cast<int64_t>(sb.st_size));
+		curl_easy_setopt(easyhandle, CURLOPT_RESUME_FROM, sb.st_size);
+		dl->set_offset(sb.st_size);
+		transfer->f.open(
+			transfer->filename, std::fstream::out | std::fstream::app);
+		transfer->resumed_download = true;
+	}
+
+	if (!transfer->f.is_open()) {
+		curl_easy_cleanup(easyhandle);
+		dl->set_status(DlStatus::FAILED);
+		return false;
+	}
+
+	dl->set_status(DlStatus::DOWNLOADING);
+	curl_multi_add_handle(multi_handle, easyhandle);
+	transfers.push_back(std::move(transfer));
+	return true;
+}
+
+void DownloadScheduler::finish_transfer(Transfer* transfer, CURLcode result)
+{
+	transfer->f.close();
+
+	LOG(Level::INFO,
+		"DownloadScheduler::finish_transfer: rc = %u (%s)",
+		result,
+		curl_easy_strerror(result));
+
+	curl_multi_remove_handle(multi_handle, transfer->handle);
+	curl_easy_cleanup(transfer->handle);
+
+	Download* dl = transfer->dl;
+	const std::string filename = transfer->filename;
+	const bool resumed_download = transfer->resumed_download;
+
+	std::lock_guard<std::mutex> guard(mtx);
+	transfers.erase(std::find_if(transfers.begin(), transfers.end(),
+	[&](const std::unique_ptr<Transfer>& t) {
+		return t.get() == transfer;
+	}));
+
+	if (result == CURLE_OK) {
+		LOG(Level::DEBUG,
+			"DownloadScheduler::finish_transfer: download complete, "
+			"deleting temporary suffix");
+		rename(filename.c_str(), dl->filename().c_str());
+		dl->set_status(DlStatus::READY);
+	} else if (dl->status() != DlStatus::CANCELLED) {
+		::unlink(filename.c_str());
+		// attempt complete re-download
+		if (resumed_download) {
+			start_transfer(dl);
+		} else {
+			dl->set_status(DlStatus::FAILED);
+		}
+	} else if (is_queued(dl)) {
+		// Cancelled, then queued again while this transfer was stopping
+		dl->set_status(DlStatus::QUEUED);
+	}
+}
+
+void DownloadScheduler::refill_tokens()
+{
+	using fpseconds = std::chrono::duration<double>;
+
+	const auto now = std::chrono::steady_clock::now();
+	const double elapsed =
+		std::chrono::duration_cast<fpseconds>(now - last_refill).count();
+	last_refill = now;
+
+	if (bytes_per_second <= 0 || transfers.empty()) {
+		return;
+	}
+
+	std::vector<double> tokens;
+	for (const auto& transfer : transfers) {
+		tokens.push_back(transfer->tokens);
+	}
+	refill(tokens, bytes_per_second, elapsed);
+
+	for (std::size_t i = 0; i < transfers.size(); i++) {
+		Transfer* transfer = transfers[i].get();
+		transfer->tokens = tokens[i];
+		if (transfer->paused && transfer->tokens > 0) {
+			transfer->paused = false;
+			// Might call write_callback() right away with the data that
+			// was held back
+			curl_easy_pause(transfer->handle, CURLPAUSE_CONT);
+		}
+	}
+}
+
+} // namespace podboat
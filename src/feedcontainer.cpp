@@ -67,25 +67,14 @@ void FeedContainer::sort_feeds(const FeedSortStrategy& sort_strategy)
 			feeds.end(),
 			[](std::shared_ptr<RssFeed> a,
 		std::shared_ptr<RssFeed> b) {
-			if (a->items().size() == 0 ||
-				b->items().size() == 0) {
-				return a->items().size() >
-					b->items().size();
+			if (a->total_item_count() == 0 ||
+				b->total_item_count() == 0) {
+				return a->total_item_count() >
+					b->total_item_count();
 			}
-			auto cmp =
-				[](std::shared_ptr<RssItem> a,
-			std::shared_ptr<RssItem> b) {
-				return *a < *b;
-			};
-			auto& a_item =
-				*std::min_element(a->items().begin(),
-					a->items().end(),
-					cmp);
-			auto& b_item =
-				*std::min_element(b->items().begin(),
-					b->items().end(),
-					cmp);
-			return cmp(a_item, b_item);
+			// newest items come first
+			return a->newest_item_pubdate() >
+				b->newest_item_pubdate();
 		});
 		break;
 	}
@@ -190,6 +179,27 @@ unsigned int FeedContainer::get_unread_item_count_per_tag(
 	return count;
 }
 
+std::vector<TagCounts> FeedContainer::get_counts_per_tag(
+	const std::vector<std::string>& tags)
+{
+	std::vector<TagCounts> counts(tags.size(), TagCounts{0, 0, 0});
+	std::lock_guard<std::mutex> feedslock(feeds_mutex);
+	for (const auto& feed : feeds) {
+		const auto unread = feed->unread_item_count();
+		for (std::size_t i = 0; i < tags.size(); ++i) {
+			if (feed->matches_tag(tags[i])) {
+				counts[i].feed_count++;
+				if (unread > 0) {
+					counts[i].unread_feed_count++;
+				}
+				counts[i].unread_item_count += unread;
+			}
+		}
+	}
+
+	return counts;
+}
+
 std::shared_ptr<RssFeed> FeedContainer::get_feed_by_url(
 	const std::string& feedurl)
 {
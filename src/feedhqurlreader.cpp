@@ -65,7 +65,7 @@ void FeedHqUrlReader::reload()
 		}
 	}
 
-	std::vector<TaggedFeedUrl> feedurls = api->get_subscribed_urls();
+	std::vector<TaggedFeedUrl> feedurls = api->get_subscriptions();
 	for (const auto& tagged : feedurls) {
 		std::string url = tagged.first;
 		std::vector<std::string> url_tags = tagged.second;
@@ -576,15 +576,14 @@ void FeedListFormAction::set_feedlist(
 
 	const unsigned int width = feeds_list.get_width();
 
-	std::string feedlist_format = cfg->get_configvalue("feedlist-format");
+	feedlist_template.set_format(cfg->get_configvalue("feedlist-format"));
 
 	ListFormatter listfmt(&rxman, "feedlist");
 
 	update_visible_feeds(feeds);
 
 	for (const auto& feed : visible_feeds) {
-		listfmt.add_line(format_line(feedlist_format,
-				feed.first,
+		listfmt.add_line(format_line(feed.first,
 				feed.second,
 				width),
 			std::to_string(feed.second));
@@ -1020,31 +1019,55 @@ std::string FeedListFormAction::get_title(std::shared_ptr<RssFeed> feed)
 	return title;
 }
 
-std::string FeedListFormAction::format_line(const std::string& feedlist_format,
-	std::shared_ptr<RssFeed> feed,
+std::string FeedListFormAction::format_line(std::shared_ptr<RssFeed> feed,
 	unsigned int pos,
 	unsigned int width)
 {
-	FmtStrFormatter fmt;
+	// `line_fmt` is shared by all lines, so every key that the format uses has
+	// to be registered anew. Keys that the format doesn't use are skipped.
+	const auto& tmpl = feedlist_template;
+	auto& fmt = line_fmt;
 	unsigned int unread_count = feed->unread_item_count();
 
-	fmt.register_fmt('i', strprintf::fmt("%u", pos + 1));
-	fmt.register_fmt('u',
-		strprintf::fmt("(%u/%u)",
-			unread_count,
-			static_cast<unsigned int>(feed->total_item_count())));
-	fmt.register_fmt('U', std::to_string(unread_count));
-	fmt.register_fmt('c', std::to_string(feed->total_item_count()));
-	fmt.register_fmt('n', unread_count > 0 ? "N" : " ");
-	fmt.register_fmt('S', feed->get_status());
-	fmt.register_fmt('t', get_title(feed));
-	fmt.register_fmt('T', feed->get_firsttag());
-	fmt.register_fmt('l', utils::censor_url(feed->link()));
-	fmt.register_fmt('L', utils::censor_url(feed->rssurl()));
-	fmt.register_fmt('d', utils::utf8_to_locale(feed->description()));
-
-	auto formattedLine = fmt.do_format(feedlist_format, width);
-	formattedLine = utils::quote_for_stfl(formattedLine);
+	if (tmpl.uses('i')) {
+		fmt.register_fmt('i', std::to_string(pos + 1));
+	}
+	if (tmpl.uses('u')) {
+		fmt.register_fmt('u',
+			strprintf::fmt("(%u/%u)",
+				unread_count,
+				static_cast<unsigned int>(feed->total_item_count())));
+	}
+	if (tmpl.uses('U')) {
+		fmt.register_fmt('U', std::to_string(unread_count));
+	}
+	if (tmpl.uses('c')) {
+		fmt.register_fmt('c', std::to_string(feed->total_item_count()));
+	}
+	if (tmpl.uses('n')) {
+		fmt.register_fmt('n', unread_count > 0 ? "N" : " ");
+	}
+	if (tmpl.uses('S')) {
+		fmt.register_fmt('S', feed->get_status());
+	}
+	if (tmpl.uses('t')) {
+		fmt.register_fmt('t', get_title(feed));
+	}
+	if (tmpl.uses('T')) {
+		fmt.register_fmt('T', feed->get_firsttag());
+	}
+	if (tmpl.uses('l')) {
+		fmt.register_fmt('l', utils::censor_url(feed->link()));
+	}
+	if (tmpl.uses('L')) {
+		fmt.register_fmt('L', utils::censor_url(feed->rssurl()));
+	}
+	if (tmpl.uses('d')) {
+		fmt.register_fmt('d', utils::utf8_to_locale(feed->description()));
+	}
+
+	fmt.do_format(tmpl, width, line_buffer);
+	auto formattedLine = utils::quote_for_stfl(line_buffer);
 	if (unread_count > 0) {
 		formattedLine = strprintf::fmt("<unread>%s</>", formattedLine);
 	}
@@ -15,16 +15,59 @@ extern "C" {
 	void rs_fmtstrformatter_register_fmt(
 		void* fmt,
 		char key,
-		const char* value);
+		const char* value,
+		std::size_t value_len);
 
-	char* rs_fmtstrformatter_do_format(
+	void rs_fmtstrformatter_do_format(
 		void* fmt,
 		const char* format,
-		std::uint32_t width);
+		std::size_t format_len,
+		std::uint32_t width,
+		void* out,
+		rs_write_str_fn write);
+
+	void rs_fmtstrformatter_do_format_template(
+		void* fmt,
+		const void* tmpl,
+		std::uint32_t width,
+		void* out,
+		rs_write_str_fn write);
+
+	void* rs_fmtstrtemplate_new(const char* format, std::size_t format_len);
+
+	void rs_fmtstrtemplate_free(void* tmpl);
+
+	bool rs_fmtstrtemplate_uses_key(const void* tmpl, char key);
 }
 
 namespace newsboat {
 
+FmtStrTemplate::FmtStrTemplate()
+{
+	rs_template = rs_fmtstrtemplate_new(format.data(), format.size());
+}
+
+FmtStrTemplate::~FmtStrTemplate()
+{
+	rs_fmtstrtemplate_free(rs_template);
+}
+
+void FmtStrTemplate::set_format(const std::string& new_format)
+{
+	if (new_format == format) {
+		return;
+	}
+
+	format = new_format;
+	rs_fmtstrtemplate_free(rs_template);
+	rs_template = rs_fmtstrtemplate_new(format.data(), format.size());
+}
+
+bool FmtStrTemplate::uses(char key) const
+{
+	return rs_fmtstrtemplate_uses_key(rs_template, key);
+}
+
 FmtStrFormatter::FmtStrFormatter()
 {
 	rs_fmt = rs_fmtstrformatter_new();
@@ -37,13 +80,24 @@ FmtStrFormatter::~FmtStrFormatter()
 
 void FmtStrFormatter::register_fmt(char f, const std::string& value)
 {
-	rs_fmtstrformatter_register_fmt(rs_fmt, f, value.c_str());
+	rs_fmtstrformatter_register_fmt(rs_fmt, f, value.data(), value.size());
 }
 
 std::string FmtStrFormatter::do_format(const std::string& fmt,
 	unsigned int width)
 {
-	return RustString(rs_fmtstrformatter_do_format(rs_fmt, fmt.c_str(), width));
+	std::string result;
+	rs_fmtstrformatter_do_format(rs_fmt, fmt.data(), fmt.size(), width,
+		&result, assign_to_std_string);
+	return result;
+}
+
+void FmtStrFormatter::do_format(const FmtStrTemplate& tmpl,
+	unsigned int width,
+	std::string& result)
+{
+	rs_fmtstrformatter_do_format_template(rs_fmt, tmpl.rs_template, width,
+		&result, assign_to_std_string);
 }
 
 } // namespace newsboat
@@ -5,9 +5,10 @@
 #include <cstdio>
 #include <cstring>
 #include <iostream>
+#include <iterator>
 #include <libgen.h>
-#include <sstream>
 #include <stdexcept>
+#include <unordered_map>
 
 #include "config.h"
 #include "logger.h"
@@ -17,78 +18,98 @@
 
 namespace newsboat {
 
+namespace {
+
+HtmlTag lookup_tag(const std::string& tagname)
+{
+	static const std::unordered_map<std::string, HtmlTag> tags = {
+		{"a", HtmlTag::A},
+		{"embed", HtmlTag::EMBED},
+		{"br", HtmlTag::BR},
+		{"pre", HtmlTag::PRE},
+		{"ituneshack", HtmlTag::ITUNESHACK},
+		{"img", HtmlTag::IMG},
+		{"blockquote", HtmlTag::BLOCKQUOTE},
+		{"aside", HtmlTag::BLOCKQUOTE},
+		{"p", HtmlTag::P},
+		{"h1", HtmlTag::H1},
+		{"h2", HtmlTag::H2},
+		{"h3", HtmlTag::H3},
+		{"h4", HtmlTag::H4},
+		{"h5", HtmlTag::H5},
+		{"h6", HtmlTag::H6},
+		{"ol", HtmlTag::OL},
+		{"ul", HtmlTag::UL},
+		{"li", HtmlTag::LI},
+		{"dt", HtmlTag::DT},
+		{"dd", HtmlTag::DD},
+		{"dl", HtmlTag::DL},
+		{"sup", HtmlTag::SUP},
+		{"sub", HtmlTag::SUB},
+		{"hr", HtmlTag::HR},
+		{"b", HtmlTag::STRONG},
+		{"strong", HtmlTag::STRONG},
+		{"u", HtmlTag::UNDERLINE},
+		{"q", HtmlTag::QUOTATION},
+		{"script", HtmlTag::SCRIPT},
+		{"style", HtmlTag::STYLE},
+		{"table", HtmlTag::TABLE},
+		{"th", HtmlTag::TH},
+		{"tr", HtmlTag::TR},
+		{"td", HtmlTag::TD},
+		{"video", HtmlTag::VIDEO},
+		{"audio", HtmlTag::AUDIO},
+		{"source", HtmlTag::SOURCE},
+	};
+
+	const auto tag = tags.find(tagname);
+	if (tag == tags.end()) {
+		// Unknown tags are handled by the `default` branches
+		return HtmlTag();
+	}
+	return tag->second;
+}
+
+} // namespace
+
 HtmlRenderer::HtmlRenderer(bool raw)
-	: raw_(raw)
+	: indexed_links(0)
+	, raw_(raw)
 {
-	tags["a"] = HtmlTag::A;
-	tags["embed"] = HtmlTag::EMBED;
-	tags["br"] = HtmlTag::BR;
-	tags["pre"] = HtmlTag::PRE;
-	tags["ituneshack"] = HtmlTag::ITUNESHACK;
-	tags["img"] = HtmlTag::IMG;
-	tags["blockquote"] = HtmlTag::BLOCKQUOTE;
-	tags["aside"] = HtmlTag::BLOCKQUOTE;
-	tags["p"] = HtmlTag::P;
-	tags["h1"] = HtmlTag::H1;
-	tags["h2"] = HtmlTag::H2;
-	tags["h3"] = HtmlTag::H3;
-	tags["h4"] = HtmlTag::H4;
-	tags["h5"] = HtmlTag::H5;
-	tags["h6"] = HtmlTag::H6;
-	tags["ol"] = HtmlTag::OL;
-	tags["ul"] = HtmlTag::UL;
-	tags["li"] = HtmlTag::LI;
-	tags["dt"] = HtmlTag::DT;
-	tags["dd"] = HtmlTag::DD;
-	tags["dl"] = HtmlTag::DL;
-	tags["sup"] = HtmlTag::SUP;
-	tags["sub"] = HtmlTag::SUB;
-	tags["hr"] = HtmlTag::HR;
-	tags["b"] = HtmlTag::STRONG;
-	tags["strong"] = HtmlTag::STRONG;
-	tags["u"] = HtmlTag::UNDERLINE;
-	tags["q"] = HtmlTag::QUOTATION;
-	tags["script"] = HtmlTag::SCRIPT;
-	tags["style"] = HtmlTag::STYLE;
-	tags["table"] = HtmlTag::TABLE;
-	tags["th"] = HtmlTag::TH;
-	tags["tr"] = HtmlTag::TR;
-	tags["td"] = HtmlTag::TD;
-	tags["video"] = HtmlTag::VIDEO;
-	tags["audio"] = HtmlTag::AUDIO;
-	tags["source"] = HtmlTag::SOURCE;
 }
 
-void HtmlRenderer::render(const std::string& source,
+void HtmlRenderer::render(std::istream& input,
 	std::vector<std::pair<LineType, std::string>>& lines,
 	std::vector<LinkPair>& links,
 	const std::string& url)
 {
-	std::istringstream input(source);
-	render(input, lines, links, url);
+	const std::string source((std::istreambuf_iterator<char>(input)),
+		std::istreambuf_iterator<char>());
+	render(source, lines, links, url);
 }
 
 unsigned int HtmlRenderer::add_link(std::vector<LinkPair>& links,
 	const std::string& link,
 	LinkType type)
 {
-	bool found = false;
-	unsigned int i = 1;
-	for (const auto& l : links) {
-		if (l.first == link) {
-			found = true;
-			break;
-		}
-		i++;
+	// Index the links that were added since the last call (including the
+	// ones the caller passed in). The first occurrence of a link wins.
+	for (; indexed_links < links.size(); indexed_links++) {
+		link_numbers.emplace(links[indexed_links].first, indexed_links + 1);
 	}
-	if (!found) {
-		links.push_back(LinkPair(link, type));
+
+	const auto known = link_numbers.find(link);
+	if (known != link_numbers.end()) {
+		return known->second;
 	}
 
-	return i;
+	links.push_back(LinkPair(link, type));
+	indexed_links = links.size();
+	link_numbers.emplace(link, indexed_links);
+	return indexed_links;
 }
 
-void HtmlRenderer::render(std::istream& input,
+void HtmlRenderer::render(const std::string& source,
 	std::vector<std::pair<LineType, std::string>>& lines,
 	std::vector<LinkPair>& links,
 	const std::string& url)
@@ -121,7 +142,10 @@ void HtmlRenderer::render(std::istream& input,
 	 * tag, close tag, text element, ...
 	 */
 	TagSoupPullParser xpp;
-	xpp.set_input(input);
+	xpp.set_input(source);
+
+	link_numbers.clear();
+	indexed_links = 0;
 
 	for (TagSoupPullParser::Event e = xpp.next();
 		e != TagSoupPullParser::Event::END_DOCUMENT;
@@ -134,7 +158,7 @@ void HtmlRenderer::render(std::istream& input,
 				tagname.end(),
 				tagname.begin(),
 				::tolower);
-			current_tag = tags[tagname];
+			current_tag = lookup_tag(tagname);
 
 			switch (current_tag) {
 			case HtmlTag::A: {
@@ -590,7 +614,7 @@ void HtmlRenderer::render(std::istream& input,
 				tagname.end(),
 				tagname.begin(),
 				::tolower);
-			current_tag = tags[tagname];
+			current_tag = lookup_tag(tagname);
 
 			switch (current_tag) {
 			case HtmlTag::BLOCKQUOTE:
@@ -220,35 +220,48 @@ bool InoreaderApi::mark_article_read(const std::string& guid, bool read)
 			"InoreaderApi::mark_article_read: inside thread, marking "
 			"thread as read...");
 
-		std::string postcontent;
-
-		if (read) {
-			postcontent = strprintf::fmt(
-					"i=%s&a=user/-/state/com.google/read&r=user/-/state/"
-					"com.google/kept-unread&ac=edit",
-					guid);
-		} else {
-			postcontent = strprintf::fmt(
-					"i=%s&r=user/-/state/com.google/read&a=user/-/state/"
-					"com.google/kept-unread&a=user/-/state/com.google/"
-					"tracking-kept-unread&ac=edit",
-					guid);
-		}
-
-		std::string result =
-			post_content(INOREADER_API_EDIT_TAG_URL, postcontent);
-
-		LOG(Level::DEBUG,
-			"InoreaderApi::mark_article_read: postcontent = %s result = %s",
-			postcontent,
-			result);
-
-		return result == "OK";
+		this->mark_articles_read({guid}, read);
 	}};
 	t.detach();
 	return true;
 }
 
+bool InoreaderApi::mark_articles_read(const std::vector<std::string>& guids,
+	bool read)
+{
+	if (guids.empty()) {
+		return true;
+	}
+
+	// The edit-tag endpoint accepts any number of `i` parameters, so all
+	// articles are changed with a single request.
+	std::string postcontent;
+	for (const auto& guid : guids) {
+		postcontent.append(strprintf::fmt("i=%s&", guid));
+	}
+
+	if (read) {
+		postcontent.append(
+			"a=user/-/state/com.google/read&r=user/-/state/"
+			"com.google/kept-unread&ac=edit");
+	} else {
+		postcontent.append(
+			"r=user/-/state/com.google/read&a=user/-/state/"
+			"com.google/kept-unread&a=user/-/state/com.google/"
+			"tracking-kept-unread&ac=edit");
+	}
+
+	std::string result =
+		post_content(INOREADER_API_EDIT_TAG_URL, postcontent);
+
+	LOG(Level::DEBUG,
+		"InoreaderApi::mark_articles_read: postcontent = %s result = %s",
+		postcontent,
+		result);
+
+	return result == "OK";
+}
+
 bool InoreaderApi::update_article_flags(const std::string& inoflags,
 	const std::string& newflags,
 	const std::string& guid)
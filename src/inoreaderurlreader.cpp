@@ -69,7 +69,7 @@ void InoreaderUrlReader::reload()
 		}
 	}
 
-	std::vector<TaggedFeedUrl> feedurls = api->get_subscribed_urls();
+	std::vector<TaggedFeedUrl> feedurls = api->get_subscriptions();
 	for (const auto& url : feedurls) {
 		LOG(Level::DEBUG, "added %s to URL list", url.first);
 		urls.push_back(url.first);
@@ -927,6 +927,7 @@ void ItemListFormAction::do_update_visible_items()
 
 void ItemListFormAction::prepare()
 {
+	ScopeMeasure m1("ItemListFormAction::prepare");
 	std::lock_guard<std::mutex> mtx(redraw_mtx);
 
 	const auto sort_strategy = cfg->get_article_sort_strategy();
@@ -943,6 +944,8 @@ void ItemListFormAction::prepare()
 				_("Error: applying the filter failed: %s"), e.what()));
 		return;
 	}
+	m1.stopover("do_update_visible_items");
+	m1.add_counter("items", visible_items.size());
 
 	if (cfg->get_configvalue_as_bool("mark-as-read-on-hover")) {
 		if (!visible_items.empty()) {
@@ -964,41 +967,79 @@ void ItemListFormAction::prepare()
 		old_width = width;
 	}
 
-	if (invalidation_mode == InvalidationMode::NONE) {
-		return;
-	}
-
 	auto datetime_format = cfg->get_configvalue("datetime-format");
 	auto itemlist_format =
 		cfg->get_configvalue("articlelist-format");
 
+	if (itemlist_format != old_itemlist_format ||
+		datetime_format != old_datetime_format) {
+		invalidate_everything();
+		old_itemlist_format = itemlist_format;
+		old_datetime_format = datetime_format;
+		itemlist_template.set_format(itemlist_format);
+	}
+
+	// Formatting a line is expensive, so we only do it for lines that are
+	// on screen or a page away from it; the rest are placeholders until
+	// they scroll into view. Formatted lines stay in `listfmt` until their
+	// item is invalidated.
+	const auto visible_range = items_list.get_visible_range(
+			visible_items.size(),
+			items_list.get_height());
+
+	bool placeholders_in_view = false;
+	if (invalidation_mode != InvalidationMode::COMPLETE) {
+		for (auto i = visible_range.first; i < visible_range.second; ++i) {
+			if (listfmt.is_placeholder(i)) {
+				placeholders_in_view = true;
+				break;
+			}
+		}
+	}
+
+	if (invalidation_mode == InvalidationMode::NONE && !placeholders_in_view) {
+		return;
+	}
+
+	const auto format_line = [&](unsigned int itempos) {
+		const auto& item = visible_items[itempos];
+		m1.add_counter("formatted lines", 1);
+		return item2formatted_line(item, width, datetime_format);
+	};
+
 	switch (invalidation_mode) {
 	case InvalidationMode::COMPLETE:
 		listfmt.clear();
 
-		for (const auto& item : visible_items) {
-			auto line = item2formatted_line(item,
-					width,
-					itemlist_format,
-					datetime_format);
-			listfmt.add_line(line, std::to_string(item.second));
+		for (unsigned int i = 0; i < visible_items.size(); ++i) {
+			const auto id = std::to_string(visible_items[i].second);
+			if (i >= visible_range.first && i < visible_range.second) {
+				listfmt.add_line(format_line(i), id);
+			} else {
+				listfmt.add_placeholder(id);
+			}
 		}
 		break;
 
 	case InvalidationMode::PARTIAL:
 		for (const auto& itempos : invalidated_itempos) {
-			auto item = visible_items[itempos];
-			auto line = item2formatted_line(item,
-					width,
-					itemlist_format,
-					datetime_format);
-			listfmt.set_line(itempos, line, std::to_string(item.second));
+			const auto id = std::to_string(visible_items[itempos].second);
+			listfmt.set_line(itempos, format_line(itempos), id);
 		}
 		break;
 	case InvalidationMode::NONE:
 		break;
 	}
 
+	if (placeholders_in_view) {
+		for (auto i = visible_range.first; i < visible_range.second; ++i) {
+			if (listfmt.is_placeholder(i)) {
+				const auto id = std::to_string(visible_items[i].second);
+				listfmt.set_line(i, format_line(i), id);
+			}
+		}
+	}
+
 	items_list.stfl_replace_lines(listfmt);
 
 	invalidated_itempos.clear();
@@ -1014,38 +1055,59 @@ void ItemListFormAction::prepare()
 
 std::string ItemListFormAction::item2formatted_line(const ItemPtrPosPair& item,
 	const unsigned int width,
-	const std::string& itemlist_format,
 	const std::string& datetime_format)
 {
-	FmtStrFormatter fmt;
-	fmt.register_fmt('i', strprintf::fmt("%u", item.second + 1));
-	fmt.register_fmt('f', gen_flags(item.first));
-	fmt.register_fmt('n', item.first->unread() ? "N" : " ");
-	fmt.register_fmt('d', item.first->deleted() ? "D" : " ");
-	fmt.register_fmt('F', item.first->flags());
-	fmt.register_fmt('D',
-		utils::mt_strf_localtime(
-			datetime_format,
-			item.first->pubDate_timestamp()));
-	if (feed->rssurl() != item.first->feedurl() &&
-		item.first->get_feedptr() != nullptr) {
-		auto feedtitle = item.first->get_feedptr()->title();
-		utils::remove_soft_hyphens(feedtitle);
+	// `line_fmt` is shared by all lines, so every key that the format uses has
+	// to be registered anew, even if it's empty for this item. Keys that the
+	// format doesn't use are skipped altogether.
+	const auto& tmpl = itemlist_template;
+	auto& fmt = line_fmt;
+	if (tmpl.uses('i')) {
+		fmt.register_fmt('i', std::to_string(item.second + 1));
+	}
+	if (tmpl.uses('f')) {
+		fmt.register_fmt('f', gen_flags(item.first));
+	}
+	if (tmpl.uses('n')) {
+		fmt.register_fmt('n', item.first->unread() ? "N" : " ");
+	}
+	if (tmpl.uses('d')) {
+		fmt.register_fmt('d', item.first->deleted() ? "D" : " ");
+	}
+	if (tmpl.uses('F')) {
+		fmt.register_fmt('F', item.first->flags());
+	}
+	if (tmpl.uses('D')) {
+		fmt.register_fmt('D',
+			utils::mt_strf_localtime(
+				datetime_format,
+				item.first->pubDate_timestamp()));
+	}
+	if (tmpl.uses('T')) {
+		std::string feedtitle;
+		if (feed->rssurl() != item.first->feedurl() &&
+			item.first->get_feedptr() != nullptr) {
+			feedtitle = item.first->get_feedptr()->title();
+			utils::remove_soft_hyphens(feedtitle);
+		}
 		fmt.register_fmt('T', feedtitle);
 	}
+	if (tmpl.uses('t')) {
+		auto itemtitle = utils::utf8_to_locale(item.first->title());
+		utils::remove_soft_hyphens(itemtitle);
+		fmt.register_fmt('t', itemtitle);
+	}
+	if (tmpl.uses('a')) {
+		auto itemauthor = utils::utf8_to_locale(item.first->author());
+		utils::remove_soft_hyphens(itemauthor);
+		fmt.register_fmt('a', itemauthor);
+	}
+	if (tmpl.uses('L')) {
+		fmt.register_fmt('L', item.first->length());
+	}
 
-	auto itemtitle = utils::utf8_to_locale(item.first->title());
-	utils::remove_soft_hyphens(itemtitle);
-	fmt.register_fmt('t', itemtitle);
-
-	auto itemauthor = utils::utf8_to_locale(item.first->author());
-	utils::remove_soft_hyphens(itemauthor);
-	fmt.register_fmt('a', itemauthor);
-
-	fmt.register_fmt('L', item.first->length());
-
-	auto formattedLine = fmt.do_format(itemlist_format, width);
-	formattedLine = utils::quote_for_stfl(formattedLine);
+	fmt.do_format(tmpl, width, line_buffer);
+	auto formattedLine = utils::quote_for_stfl(line_buffer);
 
 	const int id = rxman.article_matches(item.first.get());
 	if (id != -1) {
@@ -1229,6 +1291,28 @@ std::string ItemListFormAction::get_guid()
 	return visible_items[itempos].first->guid();
 }
 
+std::vector<std::shared_ptr<RssItem>> ItemListFormAction::get_neighbouring_items(
+		unsigned int count)
+{
+	std::vector<std::shared_ptr<RssItem>> result;
+
+	const unsigned int itempos = items_list.get_position();
+	if (itempos >= visible_items.size()) {
+		return result;
+	}
+
+	for (unsigned int distance = 1; distance <= count; distance++) {
+		if (itempos + distance < visible_items.size()) {
+			result.push_back(visible_items[itempos + distance].first);
+		}
+		if (itempos >= distance) {
+			result.push_back(visible_items[itempos - distance].first);
+		}
+	}
+
+	return result;
+}
+
 KeyMapHintEntry* ItemListFormAction::get_keymap_hint()
 {
 	static KeyMapHintEntry hints[] = {{OP_QUIT, _("Quit")},
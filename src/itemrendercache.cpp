@@ -0,0 +1,140 @@
+#include "itemrendercache.h"
+
+#include <algorithm>
+#include <functional>
+#include <tuple>
+
+#include "configcontainer.h"
+#include "itemrenderer.h"
+#include "logger.h"
+#include "regexmanager.h"
+#include "rssitem.h"
+
+namespace newsboat {
+
+ItemRenderCache::ItemRenderCache(std::size_t capacity)
+	: capacity(capacity)
+{
+}
+
+bool ItemRenderCache::Key::operator==(const Key& other) const
+{
+	return content_hash == other.content_hash
+		&& text_width == other.text_width
+		&& window_width == other.window_width
+		&& rules_version == other.rules_version
+		&& guid == other.guid
+		&& location == other.location
+		&& html_renderer == other.html_renderer
+		&& initial_links == other.initial_links;
+}
+
+ItemRenderCache::Key ItemRenderCache::make_key(ConfigContainer& cfg,
+	const std::shared_ptr<RssItem>& item,
+	unsigned int text_width,
+	unsigned int window_width,
+	const RegexManager& rxman,
+	const std::string& location,
+	const std::vector<LinkPair>& links)
+{
+	// Everything that ends up in the rendered article: the header fields and
+	// the body.
+	std::string content;
+	for (const auto& field : {
+			item_renderer::get_feedtitle(item),
+			item->title(),
+			item->author(),
+			item->pubDate(),
+			item->link(),
+			item->flags(),
+			item->enclosure_url(),
+			item->enclosure_type(),
+			item->get_base(),
+			item->feedurl(),
+			item->description()
+		}) {
+		content.append(field);
+		content.push_back('\0');
+	}
+
+	Key key;
+	key.guid = item->guid();
+	key.content_hash = std::hash<std::string>()(content);
+	key.text_width = text_width;
+	key.window_width = window_width;
+	key.location = location;
+	key.html_renderer = cfg.get_configvalue("html-renderer");
+	key.rules_version = rxman.get_rules_version();
+	key.initial_links = links;
+	return key;
+}
+
+std::pair<std::string, std::size_t> ItemRenderCache::get_stfl_list(
+	ConfigContainer& cfg,
+	std::shared_ptr<RssItem> item,
+	unsigned int text_width,
+	unsigned int window_width,
+	RegexManager& rxman,
+	const std::string& location,
+	std::vector<LinkPair>& links)
+{
+	const auto key = make_key(cfg, item, text_width, window_width, rxman,
+			location, links);
+
+	const auto it = std::find_if(entries.begin(), entries.end(),
+	[&key](const Entry& entry) {
+		return entry.key == key;
+	});
+	if (it != entries.end()) {
+		LOG(Level::DEBUG,
+			"ItemRenderCache::get_stfl_list: cache hit for %s",
+			key.guid);
+		entries.splice(entries.begin(), entries, it);
+	} else {
+		Entry entry;
+		entry.key = key;
+		entry.links = links;
+		std::tie(entry.formatted_text, entry.num_lines) =
+			item_renderer::to_stfl_list(
+				cfg,
+				item,
+				text_width,
+				window_width,
+				&rxman,
+				location,
+				entry.links);
+
+		entries.push_front(std::move(entry));
+		if (entries.size() > capacity) {
+			entries.pop_back();
+		}
+	}
+
+	const auto& entry = entries.front();
+	links = entry.links;
+	return {entry.formatted_text, entry.num_lines};
+}
+
+bool ItemRenderCache::contains(ConfigContainer& cfg,
+	std::shared_ptr<RssItem> item,
+	unsigned int text_width,
+	unsigned int window_width,
+	RegexManager& rxman,
+	const std::string& location,
+	const std::vector<LinkPair>& links) const
+{
+	const auto key = make_key(cfg, item, text_width, window_width, rxman,
+			location, links);
+
+	return std::any_of(entries.cbegin(), entries.cend(),
+	[&key](const Entry& entry) {
+		return entry.key == key;
+	});
+}
+
+void ItemRenderCache::clear()
+{
+	entries.clear();
+}
+
+} // namespace newsboat
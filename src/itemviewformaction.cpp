@@ -8,6 +8,7 @@
 #include "confighandlerexception.h"
 #include "dbexception.h"
 #include "fmtstrformatter.h"
+#include "itemlistformaction.h"
 #include "itemrenderer.h"
 #include "htmlrenderer.h"
 #include "logger.h"
@@ -18,6 +19,29 @@
 #include "utils.h"
 #include "view.h"
 
+namespace {
+
+// How many articles before and after the current one are rendered in advance
+const unsigned int PRERENDER_NEIGHBOURS = 2;
+
+/// The links the article view starts with, before the ones in the article.
+std::vector<newsboat::LinkPair> enclosure_links(
+	const std::shared_ptr<newsboat::RssItem>& item)
+{
+	std::vector<newsboat::LinkPair> links;
+	if (!item->enclosure_url().empty()) {
+		const auto link_type = newsboat::utils::podcast_mime_to_link_type(
+				item->enclosure_type());
+		if (link_type.has_value()) {
+			links.push_back(newsboat::LinkPair(item->enclosure_url(),
+					link_type.value()));
+		}
+	}
+	return links;
+}
+
+} // namespace
+
 namespace newsboat {
 
 ItemViewFormAction::ItemViewFormAction(View* vv,
@@ -25,7 +49,8 @@ ItemViewFormAction::ItemViewFormAction(View* vv,
 	std::string formstr,
 	Cache* cc,
 	ConfigContainer* cfg,
-	RegexManager& r)
+	RegexManager& r,
+	ItemRenderCache& rc)
 	: FormAction(vv, formstr, cfg)
 	, show_source(false)
 	, quit(false)
@@ -35,6 +60,9 @@ ItemViewFormAction::ItemViewFormAction(View* vv,
 	, in_search(false)
 	, rsscache(cc)
 	, textview("article", FormAction::f)
+	, render_cache(rc)
+	, last_text_width(0)
+	, last_window_width(0)
 {
 	valid_cmds.push_back("save");
 	std::sort(valid_cmds.begin(), valid_cmds.end());
@@ -120,23 +148,17 @@ void ItemViewFormAction::prepare()
 					&rxman,
 					"article");
 		} else {
-			links.clear();
-			if (!item->enclosure_url().empty()) {
-				const auto link_type = utils::podcast_mime_to_link_type(item->enclosure_type());
-				if (link_type.has_value()) {
-					links.push_back(LinkPair(item->enclosure_url(), link_type.value()));
-				}
-			}
+			links = enclosure_links(item);
 
 			std::tie(formatted_text, num_lines) =
-				item_renderer::to_stfl_list(
+				render_cache.get_stfl_list(
 					// cfg can't be nullptr because that's a long-lived object
 					// created at the very start of the program.
 					*cfg,
 					item,
 					text_width,
 					window_width,
-					&rxman,
+					rxman,
 					"article",
 					links);
 		}
@@ -149,10 +171,48 @@ void ItemViewFormAction::prepare()
 			in_search = false;
 		}
 
+		// External renderers are spawned as separate processes, so we
+		// only run them for the articles the user actually opens.
+		prerender_queue.clear();
+		if (cfg->get_configvalue("html-renderer") == "internal") {
+			const auto neighbours =
+				itemlist->get_neighbouring_items(PRERENDER_NEIGHBOURS);
+			prerender_queue.assign(neighbours.begin(), neighbours.end());
+		}
+		last_text_width = text_width;
+		last_window_width = window_width;
+
 		do_redraw = false;
 	}
 }
 
+bool ItemViewFormAction::has_idle_work()
+{
+	return !prerender_queue.empty();
+}
+
+void ItemViewFormAction::do_idle_work()
+{
+	if (prerender_queue.empty()) {
+		return;
+	}
+
+	const auto next_item = prerender_queue.front();
+	prerender_queue.pop_front();
+
+	ScopeMeasure m("ItemViewFormAction::do_idle_work: pre-rendering");
+	// Same links as prepare() starts with, or the result won't be reused
+	auto unused_links = enclosure_links(next_item);
+	render_cache.get_stfl_list(
+		*cfg,
+		next_item,
+		last_text_width,
+		last_window_width,
+		rxman,
+		"article",
+		unused_links);
+}
+
 bool ItemViewFormAction::process_operation(Operation op,
 	bool automatic,
 	std::vector<std::string>* args)
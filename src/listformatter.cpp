@@ -2,11 +2,63 @@
 
 #include <assert.h>
 #include <limits.h>
+#include <vector>
+#include <wchar.h>
 
 #include "stflpp.h"
 #include "strprintf.h"
 #include "utils.h"
 
+namespace {
+
+// Returns the length of the longest prefix of `text` that
+// utils::wcswidth_stfl() considers to fit into `width` columns.
+//
+// That's what shrinking the prefix one character at a time and measuring it
+// again would find, but this does it in a single pass over `text`.
+size_t fitting_prefix_length(const std::wstring& text, size_t width)
+{
+	const size_t len = text.length();
+
+	// wcswidth_stfl() subtracts 3 columns for each '<' that isn't followed by
+	// '>', skipping the three characters after it. Which positions match
+	// doesn't depend on the length of the prefix, so we find them once.
+	std::vector<bool> tag_starts(len, false);
+	for (size_t idx = 0; idx + 1 < len; ++idx) {
+		if (text[idx] == L'<' && text[idx + 1] != L'>') {
+			tag_starts[idx] = true;
+			idx += 3;
+		}
+	}
+
+	size_t fitting = 0;
+	int columns = 0;
+	bool printable = true;
+	size_t reduce_count = 0;
+	for (size_t size = 1; size <= len; ++size) {
+		const int w = wcwidth(text[size - 1]);
+		if (w < 0) {
+			printable = false;
+		} else {
+			columns += w;
+		}
+		if (size >= 2 && tag_starts[size - 2]) {
+			reduce_count += 3;
+		}
+
+		const size_t prefix_width = printable
+			? columns - reduce_count
+			: len - reduce_count;
+		if (prefix_width <= width) {
+			fitting = size;
+		}
+	}
+
+	return fitting;
+}
+
+} // namespace
+
 namespace newsboat {
 
 ListFormatter::ListFormatter(RegexManager* r, const std::string& loc)
@@ -36,14 +88,11 @@ void ListFormatter::set_line(const unsigned int itempos,
 				utils::str2wstr(text));
 
 		while (mytext.length() > 0) {
-			size_t size = mytext.length();
-			size_t w = utils::wcswidth_stfl(mytext, size);
-			if (w > width) {
-				while (size &&
-					(w = utils::wcswidth_stfl(
-								mytext, size)) > width) {
-					size--;
-				}
+			size_t size = fitting_prefix_length(mytext, width);
+			if (size == 0) {
+				// Not even a single character fits; take it anyway so
+				// that we make progress
+				size = 1;
 			}
 			formatted_text.push_back(LineIdPair(
 					utils::wstr2str(mytext.substr(0, size)), id));
@@ -60,11 +109,19 @@ void ListFormatter::set_line(const unsigned int itempos,
 		lines.insert(lines.cend(),
 			formatted_text.cbegin(),
 			formatted_text.cend());
+		placeholders.resize(lines.size(), false);
 	} else {
 		lines[itempos] = formatted_text[0];
+		placeholders[itempos] = false;
 	}
 }
 
+void ListFormatter::add_placeholder(const std::string& id)
+{
+	lines.push_back(LineIdPair("", id));
+	placeholders.push_back(true);
+}
+
 void ListFormatter::add_lines(const std::vector<std::string>& thelines,
 	unsigned int width)
 {
@@ -80,7 +137,7 @@ std::string ListFormatter::format_list() const
 	std::string format_cache = "{list";
 	for (const auto& line : lines) {
 		std::string str = line.first;
-		if (rxman) {
+		if (rxman && !str.empty()) {
 			rxman->quote_and_highlight(str, location);
 		}
 		if (line.second.empty()) {
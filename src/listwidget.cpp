@@ -128,4 +128,35 @@ std::uint32_t ListWidget::get_height()
 	return utils::to_u(form.get(list_name + ":h"));
 }
 
+std::pair<std::uint32_t, std::uint32_t> ListWidget::get_visible_range(
+	std::uint32_t line_count,
+	std::uint32_t margin)
+{
+	return visible_range(line_count, get_position(), get_height(), margin);
+}
+
+std::pair<std::uint32_t, std::uint32_t> ListWidget::visible_range(
+	std::uint32_t line_count,
+	std::uint32_t position,
+	std::uint32_t height,
+	std::uint32_t margin)
+{
+	if (height == 0) {
+		// Dimensions aren't known yet, so anything might be visible
+		return {0, line_count};
+	}
+	if (line_count == 0) {
+		return {0, 0};
+	}
+
+	// STFL keeps the selected line on screen, so no line that is further
+	// away from it than the list's height can be visible. The position may
+	// be stale if the list just got shorter; STFL then selects the last line.
+	const std::uint32_t pos = std::min(position, line_count - 1);
+	const std::uint32_t reach = height + margin;
+	const std::uint32_t first = pos > reach ? pos - reach : 0;
+	const std::uint32_t last = std::min(line_count, pos + reach + 1);
+	return {first, last};
+}
+
 } // namespace newsboat
@@ -69,6 +69,9 @@ bool Matcher::matches(Matchable* item)
 	 */
 	bool retval = false;
 	if (item) {
+		// Tallied in the caller's scope too, so that a trace shows how many
+		// items each filtering pass had to look at
+		ScopeMeasure::add_to_current("Matcher::matches calls", 1);
 		ScopeMeasure m1("Matcher::matches");
 		retval = matches_r(p.get_root(), item);
 	}
@@ -1,7 +1,9 @@
 #include "newsblurapi.h"
 
 #include <algorithm>
+#include <memory>
 #include <string.h>
+#include <thread>
 #include <time.h>
 
 #include "json.h"
@@ -217,6 +219,44 @@ bool NewsBlurApi::mark_article_read(const std::string& guid, bool read)
 	return request_successfull(query_result);
 }
 
+bool NewsBlurApi::mark_articles_read(const std::vector<std::string>& guids,
+	bool read)
+{
+	// mark_story_as_unread only takes a single story, so there's nothing to
+	// batch
+	if (!read) {
+		return RemoteApi::mark_articles_read(guids, read);
+	}
+
+	// mark_story_as_read takes any number of `story_id` parameters, but
+	// only one `feed_id`, so make one request per feed.
+	std::map<std::string, std::string> post_data_per_feed;
+	for (const auto& guid : guids) {
+		// handle dummy articles
+		if (guid.empty()) {
+			continue;
+		}
+		int separator = guid.find(ID_SEPARATOR);
+		std::string feed_id = guid.substr(0, separator);
+		std::string article_id =
+			guid.substr(separator + sizeof(ID_SEPARATOR) - 1);
+
+		std::string& post_data = post_data_per_feed[feed_id];
+		if (post_data.empty()) {
+			post_data = "feed_id=" + feed_id;
+		}
+		post_data += "&story_id=" + article_id;
+	}
+
+	bool success = true;
+	for (auto& feed : post_data_per_feed) {
+		json_object* query_result =
+			query_api("/reader/mark_story_as_read", &feed.second);
+		success = request_successfull(query_result) && success;
+	}
+	return success;
+}
+
 bool NewsBlurApi::update_article_flags(const std::string& /* oldflags */,
 	const std::string& /* newflags */,
 	const std::string& /* guid */)
@@ -233,118 +273,213 @@ time_t parse_date(const char* raw)
 	return mktime(&tm);
 }
 
-rsspp::Feed NewsBlurApi::fetch_feed(const std::string& id)
+rsspp::Feed NewsBlurApi::fetch_feed(const std::string& id,
+	std::string& sync_token)
 {
 	rsspp::Feed f = known_feeds[id];
 
+	const time_t since = utils::to_u(sync_token, 0);
+	time_t newest = since;
+
 	LOG(Level::INFO,
 		"NewsBlurApi::fetch_feed: about to fetch %u pages of feed %s",
 		min_pages,
 		id);
 
-	for (unsigned int i = 1; i <= min_pages; i++) {
-		std::string page = std::to_string(i);
-
-		json_object* query_result = query_api(
-				"/reader/feed/" + id + "?page=" + page, nullptr);
-
-		if (!query_result) {
-			return f;
+	bool failed = false;
+	bool caught_up = false;
+	const auto process_page = [&](const std::shared_ptr<json_object>& page) {
+		const auto first_new = f.items.size();
+		if (!parse_stories(page, id, f.items)) {
+			failed = true;
+			return;
 		}
 
-		json_object* stories{};
-		if (json_object_object_get_ex(
-				query_result, "stories", &stories) == FALSE) {
-			LOG(Level::ERROR,
-				"NewsBlurApi::fetch_feed: request returned no "
-				"stories");
-			return f;
+		for (auto it = f.items.begin() + first_new; it != f.items.end(); ++it) {
+			newest = std::max(newest, it->pubDate_ts);
+			if (since != 0 && it->pubDate_ts <= since) {
+				caught_up = true;
+			}
 		}
+	};
+
+	// When syncing incrementally, the first page usually reaches back to
+	// stories we already have, so fetch it alone before fanning out
+	unsigned int next_page = 1;
+	if (since != 0) {
+		process_page(fetch_pages(id, 1, 1).front());
+		next_page = 2;
+	}
 
-		if (json_object_get_type(stories) != json_type_array) {
-			LOG(Level::ERROR,
-				"NewsBlurApi::fetch_feed: content is not an "
-				"array");
-			return f;
+	while (next_page <= min_pages && !failed && !caught_up) {
+		const unsigned int last_page =
+			std::min(min_pages, next_page + MAX_PARALLEL_PAGES - 1);
+		// Pages are processed in order, so we stop at the same page as we
+		// would if they were fetched one by one
+		for (const auto& page : fetch_pages(id, next_page, last_page)) {
+			process_page(page);
+			if (failed || caught_up) {
+				break;
+			}
 		}
+		next_page = last_page + 1;
+	}
 
-		struct array_list* items = json_object_get_array(stories);
-		int items_size = array_list_length(items);
+	if (caught_up) {
 		LOG(Level::DEBUG,
-			"NewsBlurApi::fetch_feed: %d items",
-			items_size);
+			"NewsBlurApi::fetch_feed: reached stories seen during the "
+			"last sync, stopping");
+	}
 
-		for (int i = 0; i < items_size; i++) {
-			json_object* item_obj =
-				(json_object*)array_list_get_idx(items, i);
+	std::sort(f.items.begin(),
+		f.items.end(),
+	[](const rsspp::Item& a, const rsspp::Item& b) {
+		return a.pubDate_ts > b.pubDate_ts;
+	});
 
-			rsspp::Item item;
+	if (failed) {
+		f.rss_version = rsspp::Feed::UNKNOWN;
+	} else if (newest != 0) {
+		sync_token = std::to_string(newest);
+	}
 
-			json_object* node{};
+	return f;
+}
 
-			if (json_object_object_get_ex(
-					item_obj, "story_title", &node) == TRUE) {
-				item.title = json_object_get_string(node);
+std::vector<std::shared_ptr<json_object>> NewsBlurApi::fetch_pages(
+		const std::string& id,
+		unsigned int first,
+		unsigned int last)
+{
+	std::vector<std::shared_ptr<json_object>> pages(last - first + 1);
+
+	const auto fetch = [&](unsigned int page) {
+		json_object* result = query_api(
+				"/reader/feed/" + id + "?page=" + std::to_string(page),
+				nullptr);
+		pages[page - first] =
+			std::shared_ptr<json_object>(result, [](json_object* obj) {
+			if (obj != nullptr) {
+				json_object_put(obj);
 			}
+		});
+	};
 
-			if (json_object_object_get_ex(
-					item_obj, "story_authors", &node) == TRUE) {
-				item.author = json_object_get_string(node);
-			}
+	if (first == last) {
+		fetch(first);
+		return pages;
+	}
 
-			if (json_object_object_get_ex(item_obj,
-					"story_permalink",
-					&node) == TRUE) {
-				item.link = json_object_get_string(node);
-			}
+	LOG(Level::DEBUG,
+		"NewsBlurApi::fetch_pages: fetching pages %u to %u of feed %s",
+		first,
+		last,
+		id);
 
-			if (json_object_object_get_ex(
-					item_obj, "story_content", &node) == TRUE) {
-				item.content_encoded =
-					json_object_get_string(node);
-			}
+	std::vector<std::thread> threads;
+	for (unsigned int page = first; page <= last; page++) {
+		threads.push_back(std::thread(fetch, page));
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
 
-			const char* article_id{};
-			if (json_object_object_get_ex(item_obj, "id", &node) ==
-				TRUE) {
-				article_id = json_object_get_string(node);
-			}
-			item.guid = id + ID_SEPARATOR +
-				(article_id ? article_id : "");
-
-			if (json_object_object_get_ex(
-					item_obj, "read_status", &node) == TRUE) {
-				if (!static_cast<bool>(
-						json_object_get_int(node))) {
-					item.labels.push_back(
-						"newsblur:unread");
-				} else {
-					item.labels.push_back("newsblur:read");
-				}
-			}
+	return pages;
+}
+
+bool NewsBlurApi::parse_stories(const std::shared_ptr<json_object>& page,
+	const std::string& id,
+	std::vector<rsspp::Item>& items)
+{
+	if (!page) {
+		return false;
+	}
+
+	json_object* stories{};
+	if (json_object_object_get_ex(page.get(), "stories", &stories) == FALSE) {
+		LOG(Level::ERROR,
+			"NewsBlurApi::fetch_feed: request returned no "
+			"stories");
+		return false;
+	}
+
+	if (json_object_get_type(stories) != json_type_array) {
+		LOG(Level::ERROR,
+			"NewsBlurApi::fetch_feed: content is not an "
+			"array");
+		return false;
+	}
+
+	struct array_list* stories_list = json_object_get_array(stories);
+	int items_size = array_list_length(stories_list);
+	LOG(Level::DEBUG,
+		"NewsBlurApi::fetch_feed: %d items",
+		items_size);
+
+	for (int i = 0; i < items_size; i++) {
+		json_object* item_obj =
+			(json_object*)array_list_get_idx(stories_list, i);
+
+		rsspp::Item item;
+
+		json_object* node{};
 
-			if (json_object_object_get_ex(
-					item_obj, "story_date", &node) == TRUE) {
-				const char* pub_date =
-					json_object_get_string(node);
-				item.pubDate_ts = parse_date(pub_date);
+		if (json_object_object_get_ex(
+				item_obj, "story_title", &node) == TRUE) {
+			item.title = json_object_get_string(node);
+		}
 
-				item.pubDate = utils::mt_strf_localtime(
-						"%a, %d %b %Y %H:%M:%S %z",
-						item.pubDate_ts);
+		if (json_object_object_get_ex(
+				item_obj, "story_authors", &node) == TRUE) {
+			item.author = json_object_get_string(node);
+		}
+
+		if (json_object_object_get_ex(item_obj,
+				"story_permalink",
+				&node) == TRUE) {
+			item.link = json_object_get_string(node);
+		}
+
+		if (json_object_object_get_ex(
+				item_obj, "story_content", &node) == TRUE) {
+			item.content_encoded =
+				json_object_get_string(node);
+		}
+
+		const char* article_id{};
+		if (json_object_object_get_ex(item_obj, "id", &node) ==
+			TRUE) {
+			article_id = json_object_get_string(node);
+		}
+		item.guid = id + ID_SEPARATOR +
+			(article_id ? article_id : "");
+
+		if (json_object_object_get_ex(
+				item_obj, "read_status", &node) == TRUE) {
+			if (!static_cast<bool>(
+					json_object_get_int(node))) {
+				item.labels.push_back(
+					"newsblur:unread");
+			} else {
+				item.labels.push_back("newsblur:read");
 			}
+		}
 
-			f.items.push_back(item);
+		if (json_object_object_get_ex(
+				item_obj, "story_date", &node) == TRUE) {
+			const char* pub_date =
+				json_object_get_string(node);
+			item.pubDate_ts = parse_date(pub_date);
+
+			item.pubDate = utils::mt_strf_localtime(
+					"%a, %d %b %Y %H:%M:%S %z",
+					item.pubDate_ts);
 		}
-	}
 
-	std::sort(f.items.begin(),
-		f.items.end(),
-	[](const rsspp::Item& a, const rsspp::Item& b) {
-		return a.pubDate_ts > b.pubDate_ts;
-	});
+		items.push_back(item);
+	}
 
-	return f;
+	return true;
 }
 
 json_object* NewsBlurApi::query_api(const std::string& endpoint,
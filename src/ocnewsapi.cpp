@@ -1,6 +1,7 @@
 #include "ocnewsapi.h"
 
 #include <algorithm>
+#include <cinttypes>
 #include <cstdio>
 #include <cstring>
 #include <curl/curl.h>
@@ -168,6 +169,26 @@ bool OcNewsApi::mark_article_read(const std::string& guid, bool read)
 	return this->query(query, nullptr, "{}");
 }
 
+bool OcNewsApi::mark_articles_read(const std::vector<std::string>& guids,
+	bool read)
+{
+	if (guids.empty()) {
+		return true;
+	}
+
+	std::string query = read ? "items/read/multiple" : "items/unread/multiple";
+
+	std::string post;
+	for (const auto& guid : guids) {
+		if (!post.empty()) {
+			post.push_back('&');
+		}
+		post += "items[]=" + guid.substr(0, guid.find_first_of(":"));
+	}
+
+	return this->query(query, nullptr, post);
+}
+
 bool OcNewsApi::update_article_flags(const std::string& oldflags,
 	const std::string& newflags,
 	const std::string& guid)
@@ -190,17 +211,30 @@ bool OcNewsApi::update_article_flags(const std::string& oldflags,
 	;
 }
 
-rsspp::Feed OcNewsApi::fetch_feed(const std::string& feed_id)
+rsspp::Feed OcNewsApi::fetch_feed(const std::string& feed_id,
+	std::string& sync_token)
 {
 	rsspp::Feed feed = known_feeds[feed_id].first;
+	const long id = known_feeds[feed_id].second;
 
-	std::string query = "items?";
-	query += "type=" +
-		std::to_string(known_feeds[feed_id].second != 0 ? 0 : 2);
-	query += "&id=" + std::to_string(known_feeds[feed_id].second);
+	// The bulk fetch only covers real feeds, not "Starred"
+	if (!sync_token.empty() && id != 0 &&
+		take_prefetched(feed_id, feed.items, sync_token)) {
+		return feed;
+	}
+
+	std::string query;
+	if (sync_token.empty()) {
+		query = "items?";
+	} else {
+		query = "items/updated?lastModified=" + sync_token + "&";
+	}
+	query += "type=" + std::to_string(id != 0 ? 0 : 2);
+	query += "&id=" + std::to_string(id);
 
 	json_object* response;
 	if (!this->query(query, &response)) {
+		feed.rss_version = rsspp::Feed::UNKNOWN;
 		return feed;
 	}
 	JsonUptr response_uptr(response, json_object_put);
@@ -210,6 +244,7 @@ rsspp::Feed OcNewsApi::fetch_feed(const std::string& feed_id)
 	if (json_object_get_type(items) != json_type_array) {
 		LOG(Level::ERROR,
 			"OcNewsApi::fetch_feed: items is not an array");
+		feed.rss_version = rsspp::Feed::UNKNOWN;
 		return feed;
 	}
 
@@ -218,73 +253,138 @@ rsspp::Feed OcNewsApi::fetch_feed(const std::string& feed_id)
 
 	feed.items.clear();
 
+	int64_t newest = 0;
 	for (int i = 0; i < array_length; i++) {
 		json_object* item_j = static_cast<json_object*>(list->array[i]);
-		json_object* node;
-		rsspp::Item item;
+		long item_feed_id;
+		feed.items.push_back(item_from_json(item_j, item_feed_id, newest));
+	}
+
+	if (newest != 0) {
+		sync_token = std::to_string(newest);
+	}
+	if (id != 0) {
+		skip_prefetched(sync_token);
+	}
+
+	return feed;
+}
 
-		json_object_object_get_ex(item_j, "title", &node);
-		item.title = json_object_get_string(node);
+bool OcNewsApi::prefetch_feeds(const std::string& since)
+{
+	// type=3 means "all items"; items/updated isn't paged
+	json_object* response;
+	if (!query("items/updated?lastModified=" + since + "&type=3&id=0",
+			&response)) {
+		return false;
+	}
+	JsonUptr response_uptr(response, json_object_put);
 
-		json_object_object_get_ex(item_j, "url", &node);
-		if (node) {
-			item.link = json_object_get_string(node);
+	json_object* items;
+	json_object_object_get_ex(response, "items", &items);
+	if (json_object_get_type(items) != json_type_array) {
+		LOG(Level::ERROR,
+			"OcNewsApi::prefetch_feeds: items is not an array");
+		return false;
+	}
+
+	// Items refer to feeds by ID, but Newsboat knows them by title
+	std::map<long, std::string> titles;
+	for (const auto& known_feed : known_feeds) {
+		titles[known_feed.second.second] = known_feed.first;
+	}
+
+	std::map<std::string, std::vector<rsspp::Item>> prefetched;
+	int64_t newest = utils::to_u(since, 0);
+
+	array_list* list = json_object_get_array(items);
+	int array_length = list->length;
+	for (int i = 0; i < array_length; i++) {
+		json_object* item_j = static_cast<json_object*>(list->array[i]);
+		long item_feed_id;
+		rsspp::Item item = item_from_json(item_j, item_feed_id, newest);
+
+		const auto title = titles.find(item_feed_id);
+		if (title != titles.end()) {
+			prefetched[title->second].push_back(std::move(item));
 		}
+	}
 
-		json_object_object_get_ex(item_j, "author", &node);
-		item.author = json_object_get_string(node);
+	LOG(Level::DEBUG,
+		"OcNewsApi::prefetch_feeds: %d items in %" PRIu64 " feeds",
+		array_length,
+		static_cast<uint64_t>(prefetched.size()));
 
-		json_object_object_get_ex(item_j, "body", &node);
-		item.content_encoded = json_object_get_string(node);
+	store_prefetched(std::move(prefetched), std::to_string(newest));
+	return true;
+}
+
+rsspp::Item OcNewsApi::item_from_json(json_object* item_j,
+	long& feed_id,
+	int64_t& newest)
+{
+	json_object* node;
+	rsspp::Item item;
+
+	json_object_object_get_ex(item_j, "title", &node);
+	item.title = json_object_get_string(node);
+
+	json_object_object_get_ex(item_j, "url", &node);
+	if (node) {
+		item.link = json_object_get_string(node);
+	}
 
-		{
-			json_object* type_obj;
+	json_object_object_get_ex(item_j, "author", &node);
+	item.author = json_object_get_string(node);
 
-			json_object_object_get_ex(
-				item_j, "enclosureMime", &type_obj);
-			json_object_object_get_ex(
-				item_j, "enclosureLink", &node);
+	json_object_object_get_ex(item_j, "body", &node);
+	item.content_encoded = json_object_get_string(node);
 
-			if (type_obj && node) {
-				const std::string type =
-					json_object_get_string(type_obj);
-				if (utils::is_valid_podcast_type(type)) {
-					item.enclosure_url =
-						json_object_get_string(node);
-					item.enclosure_type = std::move(type);
-				}
+	{
+		json_object* type_obj;
+
+		json_object_object_get_ex(item_j, "enclosureMime", &type_obj);
+		json_object_object_get_ex(item_j, "enclosureLink", &node);
+
+		if (type_obj && node) {
+			const std::string type = json_object_get_string(type_obj);
+			if (utils::is_valid_podcast_type(type)) {
+				item.enclosure_url = json_object_get_string(node);
+				item.enclosure_type = std::move(type);
 			}
 		}
+	}
 
-		json_object_object_get_ex(item_j, "id", &node);
-		long id = json_object_get_int(node);
+	json_object_object_get_ex(item_j, "id", &node);
+	long id = json_object_get_int(node);
 
-		json_object_object_get_ex(item_j, "feedId", &node);
-		long f_id = json_object_get_int(node);
+	json_object_object_get_ex(item_j, "feedId", &node);
+	feed_id = json_object_get_int(node);
 
-		json_object_object_get_ex(item_j, "guid", &node);
-		item.guid = std::to_string(id) + ":" + std::to_string(f_id) +
-			"/" + json_object_get_string(node);
+	json_object_object_get_ex(item_j, "guid", &node);
+	item.guid = std::to_string(id) + ":" + std::to_string(feed_id) +
+		"/" + json_object_get_string(node);
 
-		json_object_object_get_ex(item_j, "unread", &node);
-		bool unread = json_object_get_boolean(node);
-		if (unread) {
-			item.labels.push_back("ocnews:unread");
-		} else {
-			item.labels.push_back("ocnews:read");
-		}
+	json_object_object_get_ex(item_j, "unread", &node);
+	bool unread = json_object_get_boolean(node);
+	if (unread) {
+		item.labels.push_back("ocnews:unread");
+	} else {
+		item.labels.push_back("ocnews:read");
+	}
 
-		json_object_object_get_ex(item_j, "pubDate", &node);
-		time_t updated = (time_t)json_object_get_int(node);
+	json_object_object_get_ex(item_j, "pubDate", &node);
+	time_t updated = (time_t)json_object_get_int(node);
 
-		item.pubDate = utils::mt_strf_localtime(
-				"%a, %d %b %Y %H:%M:%S %z",
-				updated);
+	item.pubDate = utils::mt_strf_localtime(
+			"%a, %d %b %Y %H:%M:%S %z",
+			updated);
 
-		feed.items.push_back(item);
+	if (json_object_object_get_ex(item_j, "lastModified", &node)) {
+		newest = std::max<int64_t>(newest, json_object_get_int64(node));
 	}
 
-	return feed;
+	return item;
 }
 
 void OcNewsApi::add_custom_headers(curl_slist** /* custom_headers */)
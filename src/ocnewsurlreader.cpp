@@ -31,7 +31,7 @@ void OcNewsUrlReader::reload()
 		}
 	}
 
-	std::vector<TaggedFeedUrl> feedurls = api->get_subscribed_urls();
+	std::vector<TaggedFeedUrl> feedurls = api->get_subscriptions();
 
 	for (const auto& url : feedurls) {
 		LOG(Level::INFO, "added %s to URL list", url.first);
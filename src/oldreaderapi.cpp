@@ -230,35 +230,49 @@ bool OldReaderApi::mark_all_read(const std::string& feedurl)
 bool OldReaderApi::mark_article_read(const std::string& guid, bool read)
 {
 	std::string token = get_new_token();
-	return mark_article_read_with_token(guid, read, token);
+	return mark_articles_read_with_token({guid}, read, token);
 }
 
-bool OldReaderApi::mark_article_read_with_token(const std::string& guid,
+bool OldReaderApi::mark_articles_read(const std::vector<std::string>& guids,
+	bool read)
+{
+	if (guids.empty()) {
+		return true;
+	}
+	std::string token = get_new_token();
+	return mark_articles_read_with_token(guids, read, token);
+}
+
+bool OldReaderApi::mark_articles_read_with_token(
+	const std::vector<std::string>& guids,
 	bool read,
 	const std::string& token)
 {
+	// The edit-tag endpoint accepts any number of `i` parameters, so all
+	// articles are changed with a single request.
 	std::string postcontent;
+	for (const auto& guid : guids) {
+		postcontent.append(strprintf::fmt("i=%s&", guid));
+	}
 
 	if (read) {
-		postcontent = strprintf::fmt(
-				"i=%s&a=user/-/state/com.google/read&r=user/-/state/"
+		postcontent.append(strprintf::fmt(
+				"a=user/-/state/com.google/read&r=user/-/state/"
 				"com.google/kept-unread&ac=edit&T=%s",
-				guid,
-				token);
+				token));
 	} else {
-		postcontent = strprintf::fmt(
-				"i=%s&r=user/-/state/com.google/read&a=user/-/state/"
+		postcontent.append(strprintf::fmt(
+				"r=user/-/state/com.google/read&a=user/-/state/"
 				"com.google/kept-unread&a=user/-/state/com.google/"
 				"tracking-kept-unread&ac=edit&T=%s",
-				guid,
-				token);
+				token));
 	}
 
 	std::string result =
 		post_content(OLDREADER_API_EDIT_TAG_URL, postcontent);
 
 	LOG(Level::DEBUG,
-		"OldReaderApi::mark_article_read_with_token: postcontent = %s "
+		"OldReaderApi::mark_articles_read_with_token: postcontent = %s "
 		"result = %s",
 		postcontent,
 		result);
@@ -9,7 +9,6 @@
 #include <signal.h>
 #include <sys/stat.h>
 #include <sys/types.h>
-#include <thread>
 #include <unistd.h>
 
 #include "colormanager.h"
@@ -22,7 +21,6 @@
 #include "matcherexception.h"
 #include "nullconfigactionhandler.h"
 #include "pbview.h"
-#include "poddlthread.h"
 #include "queueloader.h"
 #include "strprintf.h"
 #include "utils.h"
@@ -183,6 +181,8 @@ PbController::PbController()
 
 PbController::~PbController()
 {
+	// The scheduler's thread uses the config
+	scheduler.reset();
 	delete cfg;
 }
 
@@ -297,6 +297,8 @@ int PbController::run(int argc, char* argv[])
 	delete colorman;
 
 	max_dls = cfg->get_configvalue_as_int("max-downloads");
+	scheduler.reset(new DownloadScheduler(cfg));
+	scheduler->set_max_parallel(max_dls);
 
 	std::cout << _("done.") << std::endl;
 
@@ -313,6 +315,7 @@ int PbController::run(int argc, char* argv[])
 	std::cout << _("Cleaning up queue...");
 	std::cout.flush();
 
+	scheduler->stop();
 	ql->reload(downloads_);
 	delete ql;
 
@@ -405,6 +408,9 @@ unsigned int PbController::get_maxdownloads()
 void PbController::purge_queue()
 {
 	if (ql) {
+		// Reloading the queue moves the downloads around, so the scheduler
+		// mustn't hold on to them
+		scheduler->stop();
 		ql->reload(downloads_, true);
 	}
 }
@@ -422,29 +428,29 @@ double PbController::get_total_kbps()
 
 void PbController::start_downloads()
 {
-	int dl2start = get_maxdownloads() - downloads_in_progress();
 	for (auto& download : downloads_) {
-		if (dl2start == 0) {
-			break;
-		}
-
 		if (download.status() == DlStatus::QUEUED) {
-			std::thread t{PodDlThread(&download, cfg)};
-			--dl2start;
-			t.detach();
+			scheduler->enqueue(&download, DlPriority::NORMAL);
 		}
 	}
 }
 
+void PbController::start_download(Download& dl)
+{
+	scheduler->enqueue(&dl, DlPriority::HIGH);
+}
+
 void PbController::increase_parallel_downloads()
 {
 	++max_dls;
+	scheduler->set_max_parallel(max_dls);
 }
 
 void PbController::decrease_parallel_downloads()
 {
 	if (max_dls > 1) {
 		--max_dls;
+		scheduler->set_max_parallel(max_dls);
 	}
 }
 
@@ -16,7 +16,6 @@
 #include "listformatter.h"
 #include "logger.h"
 #include "pbcontroller.h"
-#include "poddlthread.h"
 #include "strprintf.h"
 #include "utils.h"
 
@@ -174,10 +173,7 @@ void PbView::run(bool auto_download, bool wrap_scroll)
 			if (idx != -1) {
 				if (ctrl->downloads()[idx].status() !=
 					DlStatus::DOWNLOADING) {
-					std::thread t{PodDlThread(
-							&ctrl->downloads()[idx],
-							ctrl->get_cfgcont())};
-					t.detach();
+					ctrl->start_download(ctrl->downloads()[idx]);
 				}
 			}
 		}
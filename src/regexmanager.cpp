@@ -10,9 +10,18 @@
 #include "strprintf.h"
 #include "utils.h"
 
+namespace {
+
+// Upper bound on the number of lines cached per location, so that browsing
+// through lots of articles doesn't grow the cache indefinitely
+const std::size_t HIGHLIGHT_CACHE_MAX_SIZE = 10000;
+
+} // namespace
+
 namespace newsboat {
 
 RegexManager::RegexManager()
+	: rules_version(0)
 {
 	// this creates the entries in the map. we need them there to have the
 	// "all" location work.
@@ -39,6 +48,15 @@ void RegexManager::handle_action(const std::string& action,
 		throw ConfigHandlerException(
 			ActionHandlerStatus::INVALID_COMMAND);
 	}
+	rules_changed();
+}
+
+void RegexManager::rules_changed()
+{
+	rules_version++;
+
+	std::lock_guard<std::mutex> guard(highlight_cache_mutex);
+	highlight_cache.clear();
 }
 
 int RegexManager::article_matches(Matchable* item)
@@ -59,6 +77,7 @@ void RegexManager::remove_last_regex(const std::string& location)
 	}
 
 	regexes.pop_back();
+	rules_changed();
 }
 
 std::map<size_t, std::string> RegexManager::extract_style_tags(std::string& str)
@@ -156,6 +175,17 @@ void RegexManager::merge_style_tag(std::map<size_t, std::string>& tags,
 void RegexManager::quote_and_highlight(std::string& str,
 	const std::string& location)
 {
+	{
+		std::lock_guard<std::mutex> guard(highlight_cache_mutex);
+		const auto& cache = highlight_cache[location];
+		const auto cached = cache.find(str);
+		if (cached != cache.end()) {
+			str = cached->second;
+			return;
+		}
+	}
+	const std::string input = str;
+
 	auto& regexes = locations[location];
 
 	auto tag_locations = extract_style_tags(str);
@@ -168,7 +198,7 @@ void RegexManager::quote_and_highlight(std::string& str,
 		unsigned int offset = 0;
 		int eflags = 0;
 		while (offset < str.length()) {
-			const auto matches = regex->matches(str.substr(offset), 1, eflags);
+			const auto matches = regex->matches(str.c_str() + offset, 1, eflags);
 			eflags |= REG_NOTBOL; // Don't match beginning-of-line operator (^) in following checks
 			if (matches.empty()) {
 				break;
@@ -187,6 +217,13 @@ void RegexManager::quote_and_highlight(std::string& str,
 	}
 
 	insert_style_tags(str, tag_locations);
+
+	std::lock_guard<std::mutex> guard(highlight_cache_mutex);
+	auto& cache = highlight_cache[location];
+	if (cache.size() >= HIGHLIGHT_CACHE_MAX_SIZE) {
+		cache.clear();
+	}
+	cache.emplace(input, str);
 }
 
 void RegexManager::handle_highlight_action(const std::vector<std::string>&
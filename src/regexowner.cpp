@@ -30,11 +30,17 @@ std::unique_ptr<Regex> Regex::compile(std::string reg_expression,
 	return std::unique_ptr<Regex>(new Regex(regex));
 }
 
-std::vector<std::pair<int, int>> Regex::matches(std::string input,
+std::vector<std::pair<int, int>> Regex::matches(const std::string& input,
+		int max_matches, int flags) const
+{
+	return matches(input.c_str(), max_matches, flags);
+}
+
+std::vector<std::pair<int, int>> Regex::matches(const char* input,
 		int max_matches, int flags) const
 {
 	std::vector<regmatch_t> regMatches(max_matches);
-	if (regexec(&regex, input.c_str(), max_matches,
+	if (regexec(&regex, input, max_matches,
 			regMatches.data(), flags) == 0) {
 		std::vector<std::pair<int, int>>  matches;
 		for (const auto& regMatch : regMatches) {
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cinttypes>
+#include <cstdlib>
 #include <iostream>
 #include <ncurses.h>
 #include <thread>
@@ -11,6 +12,7 @@
 #include "dbexception.h"
 #include "downloadthread.h"
 #include "fmtstrformatter.h"
+#include "remoteapi.h"
 #include "reloadrangethread.h"
 #include "reloadthread.h"
 #include "rss/exception.h"
@@ -57,7 +59,9 @@ void Reloader::reload(unsigned int pos,
 	bool unattended,
 	CurlHandle* easyhandle)
 {
+	ScopeMeasure m1("Reloader::reload");
 	LOG(Level::DEBUG, "Reloader::reload: pos = %u max = %u", pos, max);
+	ctrl->wait_for_subscriptions(false);
 	if (pos < ctrl->get_feedcontainer()->feeds.size()) {
 		std::shared_ptr<RssFeed> oldfeed =
 			ctrl->get_feedcontainer()->feeds[pos];
@@ -90,7 +94,9 @@ void Reloader::reload(unsigned int pos,
 		try {
 			oldfeed->set_status(DlStatus::DURING_DOWNLOAD);
 			std::shared_ptr<RssFeed> newfeed = parser.parse();
+			m1.stopover("parse");
 			if (newfeed != nullptr) {
+				m1.add_counter("items", newfeed->total_item_count());
 				ctrl->replace_feed(
 					oldfeed, newfeed, pos, unattended);
 				if (newfeed->total_item_count() == 0) {
@@ -138,6 +144,8 @@ void Reloader::reload_all(bool unattended)
 {
 	ScopeMeasure sm("Reloader::reload_all");
 
+	ctrl->wait_for_subscriptions(true);
+
 	const auto unread_feeds =
 		ctrl->get_feedcontainer()->unread_feed_count();
 	const auto unread_articles =
@@ -152,6 +160,8 @@ void Reloader::reload_all(bool unattended)
 	const int max_threads = num_feeds;
 	num_threads = std::max(min_threads, std::min(num_threads, max_threads));
 
+	prefetch_remote_feeds(unattended);
+
 	LOG(Level::DEBUG, "Reloader::reload_all: starting with reload all...");
 	if (num_threads == 1) {
 		reload_range(0, num_feeds - 1, num_feeds, unattended);
@@ -181,9 +191,13 @@ void Reloader::reload_all(bool unattended)
 		}
 	}
 
+	if (ctrl->get_api() != nullptr) {
+		ctrl->get_api()->drop_prefetched();
+	}
+
 	// refresh query feeds (update and sort)
 	LOG(Level::DEBUG, "Reloader::reload_all: refresh query feeds");
-	for (const auto& feed : ctrl->get_feedcontainer()->feeds) {
+	for (const auto& feed : ctrl->get_feedcontainer()->get_all_feeds()) {
 		if (feed->is_query_feed()) {
 			ctrl->get_view()->prepare_query_feed(feed);
 			feed->set_status(DlStatus::SUCCESS);
@@ -254,6 +268,50 @@ void Reloader::reload_range(unsigned int start,
 	}
 }
 
+void Reloader::prefetch_remote_feeds(bool unattended)
+{
+	RemoteApi* api = ctrl->get_api();
+	if (api == nullptr) {
+		return;
+	}
+
+	// Feeds that are due for a full sync will be fetched on their own
+	// anyway, so the bulk fetch only has to go back as far as the
+	// least recently synced of the rest
+	std::string since;
+	for (const auto& feed : ctrl->get_feedcontainer()->get_all_feeds()) {
+		if (feed->is_query_feed()) {
+			continue;
+		}
+		time_t last_full_sync = 0;
+		const std::string token = RssParser::get_sync_token(
+				feed->rssurl(), rsscache, cfg, last_full_sync);
+		if (!token.empty() && (since.empty() ||
+				std::strtoull(token.c_str(), nullptr, 10) <
+				std::strtoull(since.c_str(), nullptr, 10))) {
+			since = token;
+		}
+	}
+
+	if (since.empty()) {
+		LOG(Level::DEBUG,
+			"Reloader::prefetch_remote_feeds: no feed can be synced "
+			"incrementally");
+		return;
+	}
+
+	if (!unattended) {
+		ctrl->get_view()->set_status(_("Fetching new articles..."));
+	}
+
+	ScopeMeasure m("Reloader::prefetch_remote_feeds");
+	if (!api->prefetch_feeds(since)) {
+		LOG(Level::DEBUG,
+			"Reloader::prefetch_remote_feeds: not supported or failed, "
+			"fetching feeds one by one");
+	}
+}
+
 void Reloader::notify(const std::string& msg)
 {
 	if (cfg->get_configvalue_as_bool("notify-screen")) {
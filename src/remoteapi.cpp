@@ -1,5 +1,7 @@
 #include "remoteapi.h"
 
+#include <cinttypes>
+#include <cstdlib>
 #include <fstream>
 #include <glob.h>
 #include <iostream>
@@ -7,6 +9,19 @@
 
 #include "utils.h"
 
+namespace {
+
+/// Sync tokens of the backends that support bulk fetches are numbers that
+/// only ever grow (article IDs or timestamps).
+std::string newest_sync_token(const std::string& a, const std::string& b)
+{
+	const auto a_value = std::strtoull(a.c_str(), nullptr, 10);
+	const auto b_value = std::strtoull(b.c_str(), nullptr, 10);
+	return (a_value >= b_value) ? a : b;
+}
+
+} // namespace
+
 namespace newsboat {
 
 const std::string RemoteApi::read_password(const std::string& file)
@@ -42,6 +57,88 @@ const std::string RemoteApi::eval_password(const std::string& cmd)
 	return pass;
 }
 
+bool RemoteApi::mark_articles_read(const std::vector<std::string>& guids,
+	bool read)
+{
+	bool success = true;
+	for (const auto& guid : guids) {
+		success = mark_article_read(guid, read) && success;
+	}
+	return success;
+}
+
+void RemoteApi::set_subscriptions(std::vector<TaggedFeedUrl> urls)
+{
+	std::lock_guard<std::mutex> guard(subscriptions_mtx);
+	has_subscriptions = true;
+	subscriptions = std::move(urls);
+}
+
+std::vector<TaggedFeedUrl> RemoteApi::get_subscriptions()
+{
+	{
+		std::lock_guard<std::mutex> guard(subscriptions_mtx);
+		if (has_subscriptions) {
+			has_subscriptions = false;
+			std::vector<TaggedFeedUrl> result;
+			result.swap(subscriptions);
+			return result;
+		}
+	}
+	return get_subscribed_urls();
+}
+
+void RemoteApi::drop_prefetched()
+{
+	std::lock_guard<std::mutex> guard(prefetch_mtx);
+	has_prefetched = false;
+	prefetched.clear();
+	prefetched_token.clear();
+}
+
+void RemoteApi::store_prefetched(
+	std::map<std::string, std::vector<rsspp::Item>> items,
+	const std::string& sync_token)
+{
+	std::lock_guard<std::mutex> guard(prefetch_mtx);
+	has_prefetched = true;
+	prefetched = std::move(items);
+	prefetched_token = sync_token;
+}
+
+bool RemoteApi::take_prefetched(const std::string& feed_id,
+	std::vector<rsspp::Item>& items,
+	std::string& sync_token)
+{
+	std::lock_guard<std::mutex> guard(prefetch_mtx);
+	if (!has_prefetched) {
+		return false;
+	}
+
+	const auto it = prefetched.find(feed_id);
+	if (it != prefetched.end()) {
+		items = std::move(it->second);
+		prefetched.erase(it);
+	} else {
+		items.clear();
+	}
+	sync_token = newest_sync_token(sync_token, prefetched_token);
+
+	LOG(Level::DEBUG,
+		"RemoteApi::take_prefetched: %" PRIu64 " articles for feed %s",
+		static_cast<uint64_t>(items.size()),
+		feed_id);
+	return true;
+}
+
+void RemoteApi::skip_prefetched(std::string& sync_token)
+{
+	std::lock_guard<std::mutex> guard(prefetch_mtx);
+	if (has_prefetched) {
+		sync_token = newest_sync_token(sync_token, prefetched_token);
+	}
+}
+
 Credentials RemoteApi::get_credentials(const std::string& scope,
 	const std::string& name)
 {
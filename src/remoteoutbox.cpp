@@ -0,0 +1,270 @@
+#include "remoteoutbox.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <exception>
+#include <map>
+#include <vector>
+
+#include "cache.h"
+#include "logger.h"
+#include "remoteapi.h"
+
+namespace {
+
+/// Changes are sent once none were queued for this long, so that marking a
+/// bunch of articles in a row results in one request.
+const std::chrono::seconds COALESCE_DELAY(2);
+
+const std::chrono::seconds MIN_BACKOFF(30);
+const std::chrono::seconds MAX_BACKOFF(60 * 60);
+
+} // namespace
+
+namespace newsboat {
+
+const std::size_t RemoteOutbox::MAX_BATCH_SIZE;
+
+RemoteOutbox::RemoteOutbox(Cache* cache,
+	RemoteApi* api,
+	const std::string& backend)
+	: cache(cache)
+	, api(api)
+	, backend(backend)
+	, changes_queued(false)
+	, stopping(false)
+{
+}
+
+RemoteOutbox::~RemoteOutbox()
+{
+	stop();
+}
+
+void RemoteOutbox::start()
+{
+	if (thread.joinable()) {
+		return;
+	}
+
+	stopping = false;
+	thread = std::thread(&RemoteOutbox::run, this);
+}
+
+void RemoteOutbox::stop()
+{
+	{
+		std::lock_guard<std::mutex> guard(mtx);
+		stopping = true;
+	}
+	changes_cv.notify_all();
+
+	if (thread.joinable()) {
+		thread.join();
+	}
+}
+
+void RemoteOutbox::mark_article_read(const std::string& guid, bool read)
+{
+	cache->outbox_add_read_state(backend, guid, read);
+
+	{
+		std::lock_guard<std::mutex> guard(mtx);
+		changes_queued = true;
+	}
+	changes_cv.notify_all();
+}
+
+void RemoteOutbox::update_article_flags(const std::string& oldflags,
+	const std::string& newflags,
+	const std::string& guid)
+{
+	cache->outbox_add_flags(backend, guid, oldflags, newflags);
+
+	{
+		std::lock_guard<std::mutex> guard(mtx);
+		changes_queued = true;
+	}
+	changes_cv.notify_all();
+}
+
+bool RemoteOutbox::mark_all_read(const std::string& feedurl)
+{
+	std::lock_guard<std::mutex> guard(send_mtx);
+	cache->outbox_remove_read_state(backend, feedurl);
+	return api->mark_all_read(feedurl);
+}
+
+std::chrono::seconds RemoteOutbox::backoff(unsigned int attempts)
+{
+	auto result = MIN_BACKOFF;
+	for (unsigned int i = 0; i < attempts && result < MAX_BACKOFF; i++) {
+		result *= 2;
+	}
+	return std::min(result, MAX_BACKOFF);
+}
+
+bool RemoteOutbox::flush(time_t now)
+{
+	std::lock_guard<std::mutex> guard(send_mtx);
+
+	const auto entries = cache->outbox_get_due(backend, now);
+	if (entries.empty()) {
+		return true;
+	}
+
+	LOG(Level::DEBUG,
+		"RemoteOutbox::flush: sending %" PRIu64 " changes to %s",
+		static_cast<uint64_t>(entries.size()),
+		backend);
+
+	std::vector<int64_t> sent;
+	std::vector<int64_t> failed;
+	unsigned int failed_attempts = 0;
+
+	const auto record = [&](const std::vector<const OutboxEntry*>& batch,
+	bool success) {
+		for (const auto entry : batch) {
+			if (success) {
+				sent.push_back(entry->id);
+			} else {
+				failed.push_back(entry->id);
+				failed_attempts = std::max(failed_attempts, entry->attempts);
+			}
+		}
+	};
+
+	const auto send_read_state = [&](bool read) {
+		const auto action =
+			read ? OutboxAction::MARK_READ : OutboxAction::MARK_UNREAD;
+
+		std::vector<const OutboxEntry*> matching;
+		for (const auto& entry : entries) {
+			if (entry.action == action) {
+				matching.push_back(&entry);
+			}
+		}
+
+		for (std::size_t start = 0; start < matching.size();
+			start += MAX_BATCH_SIZE) {
+			const auto end = std::min(start + MAX_BATCH_SIZE, matching.size());
+			const std::vector<const OutboxEntry*> batch(
+				matching.begin() + start, matching.begin() + end);
+
+			std::vector<std::string> guids;
+			for (const auto entry : batch) {
+				guids.push_back(entry->guid);
+			}
+
+			bool success = false;
+			try {
+				success = api->mark_articles_read(guids, read);
+			} catch (const std::exception& e) {
+				LOG(Level::ERROR,
+					"RemoteOutbox::flush: marking articles %s failed: %s",
+					read ? "read" : "unread",
+					e.what());
+			}
+			record(batch, success);
+		}
+	};
+	send_read_state(true);
+	send_read_state(false);
+
+	// Consecutive flag changes of an article are sent as one, from the
+	// flags the server has to the ones we ended up with
+	std::vector<std::vector<const OutboxEntry*>> flag_changes;
+	std::map<std::string, std::size_t> flag_changes_by_guid;
+	for (const auto& entry : entries) {
+		if (entry.action != OutboxAction::UPDATE_FLAGS) {
+			continue;
+		}
+
+		const auto it = flag_changes_by_guid.find(entry.guid);
+		if (it == flag_changes_by_guid.end()) {
+			flag_changes_by_guid[entry.guid] = flag_changes.size();
+			flag_changes.push_back({&entry});
+		} else {
+			flag_changes[it->second].push_back(&entry);
+		}
+	}
+
+	for (const auto& changes : flag_changes) {
+		const auto& guid = changes.front()->guid;
+		const auto& oldflags = changes.front()->oldflags;
+		const auto& newflags = changes.back()->newflags;
+		if (oldflags == newflags) {
+			record(changes, true);
+			continue;
+		}
+
+		bool success = false;
+		try {
+			success = api->update_article_flags(oldflags, newflags, guid);
+		} catch (const std::exception& e) {
+			LOG(Level::ERROR,
+				"RemoteOutbox::flush: updating flags of %s failed: %s",
+				guid,
+				e.what());
+		}
+		record(changes, success);
+	}
+
+	cache->outbox_remove(sent);
+	if (!failed.empty()) {
+		const auto delay = backoff(failed_attempts);
+		LOG(Level::WARN,
+			"RemoteOutbox::flush: %" PRIu64 " changes failed, retrying "
+			"in %" PRIi64 " seconds",
+			static_cast<uint64_t>(failed.size()),
+			static_cast<int64_t>(delay.count()));
+		cache->outbox_postpone(failed, now + delay.count());
+	}
+
+	return failed.empty();
+}
+
+void RemoteOutbox::run()
+{
+	std::unique_lock<std::mutex> lock(mtx);
+	while (!stopping) {
+		changes_queued = false;
+		lock.unlock();
+
+		const time_t now = time(nullptr);
+		nonstd::optional<time_t> next_due;
+		try {
+			flush(now);
+			next_due = cache->outbox_next_due(backend);
+		} catch (const std::exception& e) {
+			LOG(Level::ERROR, "RemoteOutbox::run: %s", e.what());
+			next_due = now + MIN_BACKOFF.count();
+		}
+
+		lock.lock();
+		const auto woken_up = [this]() {
+			return stopping || changes_queued;
+		};
+		if (next_due.has_value()) {
+			const auto wake_up_at = std::chrono::system_clock::from_time_t(
+					std::max(next_due.value(), now + 1));
+			changes_cv.wait_until(lock, wake_up_at, woken_up);
+		} else {
+			changes_cv.wait(lock, woken_up);
+		}
+
+		while (changes_queued && !stopping) {
+			changes_queued = false;
+			changes_cv.wait_for(lock, COALESCE_DELAY, woken_up);
+		}
+	}
+	lock.unlock();
+
+	try {
+		flush(time(nullptr));
+	} catch (const std::exception& e) {
+		LOG(Level::ERROR, "RemoteOutbox::run: %s", e.what());
+	}
+}
+
+} // namespace newsboat
@@ -0,0 +1,153 @@
+#include "remotesubscriptions.h"
+
+#include <cinttypes>
+#include <exception>
+
+#include "cache.h"
+#include "logger.h"
+
+namespace newsboat {
+
+RemoteSubscriptions::RemoteSubscriptions(Cache* cache,
+	RemoteApi* api,
+	const std::string& backend)
+	: cache(cache)
+	, api(api)
+	, backend(backend)
+	, revalidating(false)
+	, changed(false)
+	, auth_failed(false)
+{
+}
+
+RemoteSubscriptions::~RemoteSubscriptions()
+{
+	if (thread.joinable()) {
+		thread.join();
+	}
+}
+
+bool RemoteSubscriptions::use_cached()
+{
+	if (!api->supports_cached_subscriptions()) {
+		return false;
+	}
+
+	try {
+		cached = cache->get_remote_subscriptions(backend);
+	} catch (const std::exception& e) {
+		LOG(Level::ERROR,
+			"RemoteSubscriptions::use_cached: reading subscriptions "
+			"failed: %s",
+			e.what());
+		cached.clear();
+	}
+	if (cached.empty()) {
+		return false;
+	}
+
+	LOG(Level::DEBUG,
+		"RemoteSubscriptions::use_cached: using %" PRIu64
+		" cached subscriptions",
+		static_cast<uint64_t>(cached.size()));
+	api->set_subscriptions(cached);
+	return true;
+}
+
+bool RemoteSubscriptions::revalidate()
+{
+	if (!api->authenticate()) {
+		LOG(Level::ERROR, "RemoteSubscriptions::revalidate: authentication "
+			"failed");
+		return false;
+	}
+
+	auto urls = api->get_subscribed_urls();
+
+	// An empty list is more likely to be a failed request than an account
+	// without feeds, so it doesn't replace a good one
+	if (urls.empty() && !cached.empty()) {
+		LOG(Level::WARN, "RemoteSubscriptions::revalidate: got no "
+			"subscriptions, keeping the cached ones");
+		return true;
+	}
+
+	if (api->supports_cached_subscriptions()) {
+		try {
+			cache->set_remote_subscriptions(backend, urls);
+		} catch (const std::exception& e) {
+			LOG(Level::ERROR,
+				"RemoteSubscriptions::revalidate: saving subscriptions "
+				"failed: %s",
+				e.what());
+		}
+	}
+
+	if (cached.empty() || urls != cached) {
+		LOG(Level::DEBUG, "RemoteSubscriptions::revalidate: subscriptions "
+			"changed");
+		std::lock_guard<std::mutex> guard(mtx);
+		changed = !cached.empty();
+		api->set_subscriptions(std::move(urls));
+	}
+	return true;
+}
+
+void RemoteSubscriptions::start_revalidation(std::function<void()> then)
+{
+	if (thread.joinable()) {
+		return;
+	}
+
+	revalidating = true;
+	thread = std::thread([this, then]() {
+		bool authenticated = true;
+		try {
+			if (!revalidate()) {
+				LOG(Level::USERERROR, "Authentication failed.");
+				authenticated = false;
+			}
+		} catch (const std::exception& e) {
+			LOG(Level::ERROR,
+				"RemoteSubscriptions::start_revalidation: %s",
+				e.what());
+		}
+
+		{
+			std::lock_guard<std::mutex> guard(mtx);
+			revalidating = false;
+			auth_failed = !authenticated;
+		}
+		done_cv.notify_all();
+
+		if (then) {
+			then();
+		}
+	});
+}
+
+void RemoteSubscriptions::wait_for_revalidation()
+{
+	std::unique_lock<std::mutex> lock(mtx);
+	done_cv.wait(lock, [this]() {
+		return !revalidating;
+	});
+}
+
+bool RemoteSubscriptions::subscriptions_changed()
+{
+	std::lock_guard<std::mutex> guard(mtx);
+	const bool result = changed;
+	changed = false;
+	return result;
+}
+
+bool RemoteSubscriptions::authentication_failed()
+{
+	std::lock_guard<std::mutex> guard(mtx);
+	const bool result = auth_failed;
+	auth_failed = false;
+	return result;
+}
+
+} // namespace newsboat
@@ -12,6 +12,7 @@
 #include <sys/utsname.h>
 #include <string.h>
 #include <time.h>
+#include <type_traits>
 
 #include "cache.h"
 #include "config.h"
@@ -25,6 +26,41 @@
 #include "tagsouppullparser.h"
 #include "utils.h"
 
+namespace {
+
+using ItemPtr = std::shared_ptr<newsboat::RssItem>;
+
+/// Stable-sorts items by a key that is computed just once per item, instead
+/// of on both sides of every comparison.
+template<typename KeyFunc, typename Compare>
+void sort_by_key(std::vector<ItemPtr>& items, KeyFunc get_key, Compare less)
+{
+	using Key = typename std::decay<decltype(get_key(*items.front()))>::type;
+	using Decorated = std::pair<Key, ItemPtr>;
+
+	std::vector<Decorated> decorated;
+	decorated.reserve(items.size());
+	for (auto& item : items) {
+		decorated.emplace_back(get_key(*item), std::move(item));
+	}
+
+	std::stable_sort(decorated.begin(),
+		decorated.end(),
+	[&](const Decorated& a, const Decorated& b) {
+		return less(a.first, b.first);
+	});
+
+	for (std::size_t i = 0; i < decorated.size(); ++i) {
+		items[i] = std::move(decorated[i].second);
+	}
+}
+
+/// Stored in RssFeed::counted_generation_ while unread_item_count() counts.
+/// RssItem::unread_generation() never gets this high.
+const std::uint64_t COUNTING = UINT64_MAX;
+
+} // namespace
+
 namespace newsboat {
 
 RssFeed::RssFeed(Cache* c)
@@ -34,6 +70,12 @@ RssFeed::RssFeed(Cache* c)
 	, is_rtl_(false)
 	, idx(0)
 	, order(0)
+	, tracked_items_(0)
+	, unread_count_(0)
+	, item_count_(0)
+	, counted_unread_(0)
+	, counted_generation_(0)
+	, newest_item_pubdate_(0)
 	, status_(DlStatus::SUCCESS)
 {
 }
@@ -45,12 +87,86 @@ RssFeed::~RssFeed()
 
 unsigned int RssFeed::unread_item_count()
 {
+	// items_ may be changing under item_mutex, so use the atomic copy of
+	// its size
+	if (tracked_items_ == item_count_) {
+		return unread_count_;
+	}
+
+	// Some of our items are tracked by other feeds, so we have to count.
+	// Skip that if no item changed its unread status since the last count.
 	std::lock_guard<std::mutex> lock(item_mutex);
-	return std::count_if(items_.begin(),
-			items_.end(),
-	[](const std::shared_ptr<RssItem>& item) {
-		return item->unread();
-	});
+	const auto generation = RssItem::unread_generation();
+	if (generation != counted_generation_) {
+		// track_item() and untrack_item() don't take item_mutex; if they
+		// reset counted_generation_ while we count, the result is already
+		// outdated, so we leave it marked as such.
+		counted_generation_ = COUNTING;
+		counted_unread_ = std::count_if(items_.begin(),
+				items_.end(),
+		[](const std::shared_ptr<RssItem>& item) {
+			return item->unread();
+		});
+		auto expected = COUNTING;
+		counted_generation_.compare_exchange_strong(expected, generation);
+	}
+	return counted_unread_;
+}
+
+void RssFeed::item_unread_changed(bool unread)
+{
+	if (unread) {
+		++unread_count_;
+	} else {
+		--unread_count_;
+	}
+}
+
+void RssFeed::item_pubdate_changed(time_t pubdate)
+{
+	time_t newest = newest_item_pubdate_;
+	while (pubdate > newest &&
+		!newest_item_pubdate_.compare_exchange_weak(newest, pubdate)) {
+	}
+}
+
+void RssFeed::track_item(const std::shared_ptr<RssItem>& item)
+{
+	counted_generation_ = 0;
+
+	std::lock_guard<std::mutex> lock(RssItem::tracking_mutex_);
+	if (item->tracking_feed_ == nullptr) {
+		item->tracking_feed_ = this;
+		++tracked_items_;
+		if (item->unread()) {
+			++unread_count_;
+		}
+	}
+
+	item_pubdate_changed(item->pubDate_timestamp());
+}
+
+void RssFeed::untrack_item(const std::shared_ptr<RssItem>& item)
+{
+	counted_generation_ = 0;
+
+	std::lock_guard<std::mutex> lock(RssItem::tracking_mutex_);
+	if (item->tracking_feed_ == this) {
+		item->tracking_feed_ = nullptr;
+		--tracked_items_;
+		if (item->unread()) {
+			--unread_count_;
+		}
+	}
+}
+
+void RssFeed::update_newest_item_pubdate()
+{
+	time_t newest = 0;
+	for (const auto& item : items_) {
+		newest = std::max(newest, item->pubDate_timestamp());
+	}
+	newest_item_pubdate_ = newest;
 }
 
 bool RssFeed::matches_tag(const std::string& tag)
@@ -169,8 +285,7 @@ void RssFeed::update_items(std::vector<std::shared_ptr<RssFeed>> feeds)
 
 	Matcher m(query);
 
-	items_.clear();
-	items_guid_map.clear();
+	clear_items();
 
 	for (const auto& feed : feeds) {
 		if (feed->is_query_feed()) {
@@ -181,8 +296,7 @@ void RssFeed::update_items(std::vector<std::shared_ptr<RssFeed>> feeds)
 			if (!item->deleted() && m.matches(item.get())) {
 				LOG(Level::DEBUG, "RssFeed::update_items: Matcher matches!");
 				item->set_feedptr(feed);
-				items_.push_back(item);
-				items_guid_map[item->guid()] = item;
+				add_item(item);
 			}
 		}
 	}
@@ -246,12 +360,12 @@ void RssFeed::sort_unlocked(const ArticleSortStrategy& sort_strategy)
 {
 	switch (sort_strategy.sm) {
 	case ArtSortMethod::TITLE:
-		std::stable_sort(items_.begin(),
-			items_.end(),
-			[&](const std::shared_ptr<RssItem>& a,
-		const std::shared_ptr<RssItem>& b) {
-			const auto cmp = utils::strnaturalcmp(utils::utf8_to_locale(a->title()),
-					utils::utf8_to_locale(b->title()));
+		sort_by_key(items_,
+		[](const RssItem& item) {
+			return item.title_sort_key();
+		},
+		[&](const std::string& a, const std::string& b) {
+			const auto cmp = utils::strnaturalcmp(a, b);
 			return sort_strategy.sd == SortDirection::DESC ? (cmp > 0) : (cmp < 0);
 		});
 		break;
@@ -269,13 +383,12 @@ void RssFeed::sort_unlocked(const ArticleSortStrategy& sort_strategy)
 		});
 		break;
 	case ArtSortMethod::AUTHOR:
-		std::stable_sort(items_.begin(),
-			items_.end(),
-			[&](const std::shared_ptr<RssItem>& a,
-		const std::shared_ptr<RssItem>& b) {
-			const auto author_a = utils::utf8_to_locale(a->author());
-			const auto author_b = utils::utf8_to_locale(b->author());
-			const auto cmp = strcmp(author_a.c_str(), author_b.c_str());
+		sort_by_key(items_,
+		[](const RssItem& item) {
+			return item.author_sort_key();
+		},
+		[&](const std::string& a, const std::string& b) {
+			const auto cmp = strcmp(a.c_str(), b.c_str());
 			return sort_strategy.sd == SortDirection::DESC ? (cmp > 0) : (cmp < 0);
 		});
 		break;
@@ -334,6 +447,7 @@ void RssFeed::purge_deleted_items()
 		std::lock_guard<std::mutex> lock2(items_guid_map_mutex);
 		for (const auto& item : items_) {
 			if (item->deleted()) {
+				untrack_item(item);
 				items_guid_map.erase(item->guid());
 			}
 		}
@@ -345,6 +459,8 @@ void RssFeed::purge_deleted_items()
 		return item->deleted();
 	}),
 	items_.end());
+	item_count_ = items_.size();
+	update_newest_item_pubdate();
 }
 
 void RssFeed::set_feedptrs(std::shared_ptr<RssFeed> self)
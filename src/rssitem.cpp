@@ -12,6 +12,9 @@
 
 namespace newsboat {
 
+std::atomic<std::uint64_t> RssItem::unread_generation_(1);
+std::mutex RssItem::tracking_mutex_;
+
 RssItem::RssItem(Cache* c)
 	: ch(c)
 	, idx(0)
@@ -21,6 +24,7 @@ RssItem::RssItem(Cache* c)
 	, enqueued_(false)
 	, deleted_(0)
 	, override_unread_(false)
+	, tracking_feed_(nullptr)
 {
 }
 
@@ -32,6 +36,9 @@ void RssItem::set_title(const std::string& t)
 {
 	title_ = t;
 	utils::trim(title_);
+
+	std::lock_guard<std::mutex> guard(sort_keys_mutex_);
+	title_sort_key_ = nonstd::nullopt;
 }
 
 void RssItem::set_link(const std::string& l)
@@ -43,6 +50,27 @@ void RssItem::set_link(const std::string& l)
 void RssItem::set_author(const std::string& a)
 {
 	author_ = a;
+
+	std::lock_guard<std::mutex> guard(sort_keys_mutex_);
+	author_sort_key_ = nonstd::nullopt;
+}
+
+std::string RssItem::title_sort_key() const
+{
+	std::lock_guard<std::mutex> guard(sort_keys_mutex_);
+	if (!title_sort_key_) {
+		title_sort_key_ = utils::utf8_to_locale(title_);
+	}
+	return *title_sort_key_;
+}
+
+std::string RssItem::author_sort_key() const
+{
+	std::lock_guard<std::mutex> guard(sort_keys_mutex_);
+	if (!author_sort_key_) {
+		author_sort_key_ = utils::utf8_to_locale(author_);
+	}
+	return *author_sort_key_;
 }
 
 void RssItem::set_description(const std::string& d)
@@ -73,7 +101,11 @@ std::string RssItem::length() const
 
 void RssItem::set_pubDate(time_t t)
 {
+	std::lock_guard<std::mutex> lock(tracking_mutex_);
 	pubDate_ = t;
+	if (tracking_feed_) {
+		tracking_feed_->item_pubdate_changed(pubDate_);
+	}
 }
 
 void RssItem::set_guid(const std::string& g)
@@ -81,14 +113,27 @@ void RssItem::set_guid(const std::string& g)
 	guid_ = g;
 }
 
-void RssItem::set_unread_nowrite(bool u)
+void RssItem::set_unread_and_notify_tracking_feed(bool u)
 {
+	std::lock_guard<std::mutex> lock(tracking_mutex_);
+	if (unread_ == u) {
+		return;
+	}
 	unread_ = u;
+	++unread_generation_;
+	if (tracking_feed_) {
+		tracking_feed_->item_unread_changed(unread_);
+	}
+}
+
+void RssItem::set_unread_nowrite(bool u)
+{
+	set_unread_and_notify_tracking_feed(u);
 }
 
 void RssItem::set_unread_nowrite_notify(bool u, bool notify)
 {
-	unread_ = u;
+	set_unread_and_notify_tracking_feed(u);
 	std::shared_ptr<RssFeed> feedptr = feedptr_.lock();
 	if (feedptr && notify) {
 		feedptr->get_item_by_guid(guid_)->set_unread_nowrite(
@@ -100,7 +145,7 @@ void RssItem::set_unread(bool u)
 {
 	if (unread_ != u) {
 		bool old_u = unread_;
-		unread_ = u;
+		set_unread_and_notify_tracking_feed(u);
 		std::shared_ptr<RssFeed> feedptr = feedptr_.lock();
 		if (feedptr)
 			feedptr->get_item_by_guid(guid_)->set_unread_nowrite(
@@ -113,7 +158,7 @@ void RssItem::set_unread(bool u)
 		} catch (const DbException& e) {
 			// if the update failed, restore the old unread flag and
 			// rethrow the exception
-			unread_ = old_u;
+			set_unread_and_notify_tracking_feed(old_u);
 			throw;
 		}
 	}
@@ -20,6 +20,7 @@
 #include "rss/rssparser.h"
 #include "rssfeed.h"
 #include "rssignores.h"
+#include "scopemeasure.h"
 #include "strprintf.h"
 #include "ttrssapi.h"
 #include "utils.h"
@@ -36,17 +37,23 @@ RssParser::RssParser(const std::string& uri,
 	, cfgcont(cfg)
 	, ign(ii)
 	, api(a)
+	, last_full_sync(0)
+	, incremental_sync(false)
 	, easyhandle(0)
 {
-	is_ttrss = cfgcont->get_configvalue("urls-source") == "ttrss";
-	is_newsblur = cfgcont->get_configvalue("urls-source") == "newsblur";
-	is_ocnews = cfgcont->get_configvalue("urls-source") == "ocnews";
+	const std::string urls_source = cfgcont->get_configvalue("urls-source");
+	is_ttrss = urls_source == "ttrss";
+	is_newsblur = urls_source == "newsblur";
+	is_ocnews = urls_source == "ocnews";
+	is_greader = urls_source == "oldreader" || urls_source == "feedhq" ||
+		urls_source == "inoreader";
 }
 
 RssParser::~RssParser() {}
 
 std::shared_ptr<RssFeed> RssParser::parse()
 {
+	ScopeMeasure m1("RssParser::parse");
 	retrieve_uri(my_uri);
 
 	if (f.rss_version == rsspp::Feed::Version::UNKNOWN) {
@@ -69,7 +76,11 @@ std::shared_ptr<RssFeed> RssParser::parse()
 	fill_feed_fields(feed);
 	fill_feed_items(feed);
 
-	ch->remove_old_deleted_items(feed.get());
+	// An incremental sync only returns articles that changed, so the ones
+	// missing from it may well still be on the server
+	if (!incremental_sync) {
+		ch->remove_old_deleted_items(feed.get());
+	}
 
 	return feed;
 }
@@ -191,6 +202,19 @@ void RssParser::download_http(const std::string& uri)
 		proxy_type = cfgcont->get_configvalue("proxy-type");
 	}
 
+	// Google Reader-style APIs accept the time of the previous fetch as
+	// "ot", and then only return articles newer than that
+	std::string url = uri;
+	std::string sync_token;
+	const time_t fetch_start = ::time(nullptr);
+	if (is_greader && api) {
+		sync_token = load_sync_token();
+		if (!sync_token.empty()) {
+			url += (url.find('?') == std::string::npos ? "?" : "&");
+			url += "ot=" + sync_token;
+		}
+	}
+
 	for (unsigned int i = 0; i < retrycount
 		&& f.rss_version == rsspp::Feed::Version::UNKNOWN; i++) {
 		std::string useragent = utils::get_useragent(cfgcont);
@@ -210,7 +234,7 @@ void RssParser::download_http(const std::string& uri)
 		if (!ign || !ign->matches_lastmodified(uri)) {
 			ch->fetch_lastmodified(uri, lm, etag);
 		}
-		f = p.parse_url(uri,
+		f = p.parse_url(url,
 				lm,
 				etag,
 				api,
@@ -254,6 +278,10 @@ void RssParser::download_http(const std::string& uri)
 		"RssParser::parse: http URL %s, valid: %s",
 		uri,
 		(f.rss_version != rsspp::Feed::Version::UNKNOWN) ? "true" : "false");
+
+	if (is_greader && api) {
+		store_sync_token(sync_token, std::to_string(fetch_start));
+	}
 }
 
 void RssParser::get_execplugin(const std::string& plugin)
@@ -604,12 +632,71 @@ bool RssParser::is_html_type(const std::string& type)
 			type == "application/xhtml+xml");
 }
 
+std::string RssParser::get_sync_token(const std::string& uri,
+	Cache* c,
+	ConfigContainer* cfg,
+	time_t& last_full_sync)
+{
+	std::string token;
+	c->fetch_sync_state(uri, token, last_full_sync);
+
+	const time_t interval =
+		60 * cfg->get_configvalue_as_int("remote-full-sync-interval");
+	if (token.empty() || interval == 0 ||
+		::time(nullptr) - last_full_sync >= interval) {
+		return "";
+	}
+	return token;
+}
+
+std::string RssParser::load_sync_token()
+{
+	const std::string token =
+		get_sync_token(my_uri, ch, cfgcont, last_full_sync);
+	incremental_sync = !token.empty();
+	if (token.empty()) {
+		LOG(Level::DEBUG,
+			"RssParser::load_sync_token: doing a full sync of %s",
+			my_uri);
+	} else {
+		LOG(Level::DEBUG,
+			"RssParser::load_sync_token: syncing %s since %s",
+			my_uri,
+			token);
+	}
+	return token;
+}
+
+void RssParser::store_sync_token(const std::string& old_token,
+	const std::string& new_token)
+{
+	// Failed fetches leave the sync state alone, so that the next one
+	// starts from the same point
+	if (f.rss_version == rsspp::Feed::Version::UNKNOWN) {
+		return;
+	}
+
+	// A full sync also picks up changes made to old articles (e.g. through
+	// the web interface), so remember when we last did one
+	const bool full_sync = old_token.empty();
+	if (full_sync) {
+		last_full_sync = ::time(nullptr);
+	} else if (new_token == old_token) {
+		return;
+	}
+	ch->update_sync_state(my_uri, new_token, last_full_sync);
+}
+
 void RssParser::fetch_ttrss(const std::string& feed_id)
 {
 	TtRssApi* tapi = dynamic_cast<TtRssApi*>(api);
 	if (tapi) {
-		f = tapi->fetch_feed(
-				feed_id, easyhandle ? easyhandle->ptr() : nullptr);
+		const std::string old_token = load_sync_token();
+		std::string new_token = old_token;
+		f = tapi->fetch_feed(feed_id,
+				new_token,
+				easyhandle ? easyhandle->ptr() : nullptr);
+		store_sync_token(old_token, new_token);
 	}
 	LOG(Level::DEBUG,
 		"RssParser::fetch_ttrss: f.items.size = %" PRIu64,
@@ -620,7 +707,10 @@ void RssParser::fetch_newsblur(const std::string& feed_id)
 {
 	NewsBlurApi* napi = dynamic_cast<NewsBlurApi*>(api);
 	if (napi) {
-		f = napi->fetch_feed(feed_id);
+		const std::string old_token = load_sync_token();
+		std::string new_token = old_token;
+		f = napi->fetch_feed(feed_id, new_token);
+		store_sync_token(old_token, new_token);
 	}
 	LOG(Level::INFO,
 		"RssParser::fetch_newsblur: f.items.size = %" PRIu64,
@@ -631,7 +721,10 @@ void RssParser::fetch_ocnews(const std::string& feed_id)
 {
 	OcNewsApi* napi = dynamic_cast<OcNewsApi*>(api);
 	if (napi) {
-		f = napi->fetch_feed(feed_id);
+		const std::string old_token = load_sync_token();
+		std::string new_token = old_token;
+		f = napi->fetch_feed(feed_id, new_token);
+		store_sync_token(old_token, new_token);
 	}
 	LOG(Level::INFO,
 		"RssParser::fetch_ocnews: f.items.size = %" PRIu64,
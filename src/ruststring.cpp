@@ -1,5 +1,20 @@
 #include "ruststring.h"
 
+#include <cstdlib>
+
+extern "C" void assign_to_std_string(void* out, const char* data,
+	std::size_t len) noexcept
+{
+	// This is called from Rust, and unwinding into Rust code is undefined
+	// behaviour. Rust aborts on panics at the FFI boundary (see
+	// abort_on_panic()), so do the same here.
+	try {
+		static_cast<std::string*>(out)->assign(data, len);
+	} catch (...) {
+		std::abort();
+	}
+}
+
 namespace newsboat {
 
 extern "C" void rs_cstring_free(char* str);
@@ -1,15 +1,230 @@
 #include "scopemeasure.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <mutex>
 
 using fpseconds = std::chrono::duration<double>;
 
 namespace newsboat {
 
+namespace {
+
+/// Once the trace has this many events, new ones are dropped. An event is
+/// roughly a hundred bytes, so this caps the trace at about a hundred
+/// megabytes.
+const std::size_t MAX_TRACE_EVENTS = 1000000;
+
+using TraceEvent = ScopeMeasure::TraceEvent;
+
+/// Events of one thread. Each thread records into its own buffer, so that
+/// threads don't contend for a lock on every scope; the buffer's mutex is
+/// only ever contended while the trace is being taken or written.
+struct ThreadBuffer {
+	ThreadBuffer();
+	~ThreadBuffer();
+
+	std::mutex mtx;
+	std::vector<TraceEvent> events;
+};
+
+struct Trace {
+	/// Guards everything but `recorded` and `dropped`.
+	std::mutex mtx;
+	std::string filename;
+	bool write_at_exit_registered = false;
+	std::chrono::time_point<std::chrono::steady_clock> start_time;
+	std::vector<ThreadBuffer*> buffers;
+	/// Events of threads that have already exited.
+	std::vector<TraceEvent> events;
+	std::atomic<std::size_t> recorded{0};
+	std::atomic<std::uint64_t> dropped{0};
+};
+
+std::atomic<bool> tracing(false);
+
+Trace& get_trace()
+{
+	static Trace trace;
+	return trace;
+}
+
+ThreadBuffer::ThreadBuffer()
+{
+	auto& trace = get_trace();
+	std::lock_guard<std::mutex> guard(trace.mtx);
+	trace.buffers.push_back(this);
+}
+
+ThreadBuffer::~ThreadBuffer()
+{
+	auto& trace = get_trace();
+	std::lock_guard<std::mutex> guard(trace.mtx);
+	trace.buffers.erase(
+		std::find(trace.buffers.begin(), trace.buffers.end(), this));
+	std::move(events.begin(), events.end(), std::back_inserter(trace.events));
+}
+
+thread_local ScopeMeasure* current_scope = nullptr;
+
+unsigned int get_thread_id()
+{
+	static std::atomic<unsigned int> next_id(1);
+	thread_local unsigned int id = next_id++;
+	return id;
+}
+
+void record_event(TraceEvent event)
+{
+	auto& trace = get_trace();
+	if (trace.recorded++ >= MAX_TRACE_EVENTS) {
+		trace.dropped++;
+		return;
+	}
+
+	thread_local ThreadBuffer buffer;
+	std::lock_guard<std::mutex> guard(buffer.mtx);
+	buffer.events.push_back(std::move(event));
+}
+
+/// Moves the events of all threads into `trace.events`. The caller must hold
+/// `trace.mtx`.
+void gather_events(Trace& trace)
+{
+	for (const auto buffer : trace.buffers) {
+		std::lock_guard<std::mutex> guard(buffer->mtx);
+		std::move(buffer->events.begin(),
+			buffer->events.end(),
+			std::back_inserter(trace.events));
+		buffer->events.clear();
+	}
+}
+
+/// Forgets all events. The caller must hold `trace.mtx`.
+void clear_events(Trace& trace)
+{
+	gather_events(trace);
+	trace.events.clear();
+	trace.recorded = 0;
+	trace.dropped = 0;
+}
+
+std::int64_t thread_cpu_ns()
+{
+	struct timespec ts;
+	if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+		return 0;
+	}
+	return static_cast<std::int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+std::int64_t ns_since_trace_start(
+	const std::chrono::time_point<std::chrono::steady_clock>& tp)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			tp - get_trace().start_time).count();
+}
+
+void append_json_string(std::string& out, const std::string& s)
+{
+	out.push_back('"');
+	for (const char c : s) {
+		switch (c) {
+		case '"':
+			out.append("\\\"");
+			break;
+		case '\\':
+			out.append("\\\\");
+			break;
+		case '\n':
+			out.append("\\n");
+			break;
+		case '\t':
+			out.append("\\t");
+			break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20) {
+				char buf[8];
+				snprintf(buf, sizeof(buf), "\\u%04x",
+					static_cast<unsigned int>(c));
+				out.append(buf);
+			} else {
+				out.push_back(c);
+			}
+		}
+	}
+	out.push_back('"');
+}
+
+/// Trace Event Format wants microseconds; we keep nanosecond precision by
+/// printing the fractional part.
+void append_microseconds(std::string& out, std::int64_t ns)
+{
+	// Division rounds towards zero, so both parts would carry the sign
+	const std::uint64_t magnitude = ns < 0
+		? -static_cast<std::uint64_t>(ns)
+		: static_cast<std::uint64_t>(ns);
+	char buf[32];
+	snprintf(buf, sizeof(buf), "%s%" PRIu64 ".%03" PRIu64,
+		ns < 0 ? "-" : "",
+		magnitude / 1000,
+		magnitude % 1000);
+	out.append(buf);
+}
+
+void append_event(std::string& out, const TraceEvent& event)
+{
+	out.append("{\"name\":");
+	append_json_string(out, event.name);
+	out.append(",\"cat\":\"newsboat\",\"ph\":\"");
+	out.push_back(event.phase);
+	out.append("\",\"pid\":1,\"tid\":");
+	out.append(std::to_string(event.tid));
+	out.append(",\"ts\":");
+	append_microseconds(out, event.start_ns);
+	if (event.phase == 'X') {
+		out.append(",\"dur\":");
+		append_microseconds(out, event.duration_ns);
+		out.append(",\"tdur\":");
+		append_microseconds(out, event.thread_duration_ns);
+	} else {
+		out.append(",\"s\":\"t\"");
+	}
+	if (!event.args.empty()) {
+		out.append(",\"args\":{");
+		bool first = true;
+		for (const auto& arg : event.args) {
+			if (!first) {
+				out.push_back(',');
+			}
+			first = false;
+			append_json_string(out, arg.first);
+			out.push_back(':');
+			out.append(std::to_string(arg.second));
+		}
+		out.push_back('}');
+	}
+	out.push_back('}');
+}
+
+} // namespace
+
 ScopeMeasure::ScopeMeasure(const std::string& func, Level ll)
 	: funcname(func)
 	, lvl(ll)
+	, parent(current_scope)
 {
+	current_scope = this;
+	if (tracing) {
+		start_thread_cpu_ns = thread_cpu_ns();
+	}
 	start_time = std::chrono::steady_clock::now();
 }
 
@@ -24,6 +239,50 @@ void ScopeMeasure::stopover(const std::string& son)
 		funcname,
 		son,
 		diff);
+
+	if (tracing) {
+		TraceEvent event;
+		event.name = funcname + ": " + son;
+		event.phase = 'i';
+		event.tid = get_thread_id();
+		event.start_ns = ns_since_trace_start(now);
+		event.duration_ns = 0;
+		event.thread_duration_ns = 0;
+		record_event(std::move(event));
+	}
+}
+
+void ScopeMeasure::add_counter(const std::string& name, std::int64_t amount)
+{
+	const auto it = std::find_if(counters.begin(), counters.end(),
+	[&name](const std::pair<std::string, std::int64_t>& counter) {
+		return counter.first == name;
+	});
+	if (it != counters.end()) {
+		it->second += amount;
+	} else {
+		counters.emplace_back(name, amount);
+	}
+}
+
+void ScopeMeasure::add_to_current(const char* name, std::int64_t amount)
+{
+	if (current_scope == nullptr) {
+		return;
+	}
+
+	// Unlike add_counter(), this doesn't build a std::string unless the
+	// counter is new, as it's called from hot code
+	auto& counters = current_scope->counters;
+	const auto it = std::find_if(counters.begin(), counters.end(),
+	[name](const std::pair<std::string, std::int64_t>& counter) {
+		return std::strcmp(counter.first.c_str(), name) == 0;
+	});
+	if (it != counters.end()) {
+		it->second += amount;
+	} else {
+		counters.emplace_back(name, amount);
+	}
 }
 
 ScopeMeasure::~ScopeMeasure()
@@ -31,11 +290,148 @@ ScopeMeasure::~ScopeMeasure()
 	using namespace std::chrono;
 
 	const auto now = steady_clock::now();
+	const auto now_thread_cpu_ns = tracing ? thread_cpu_ns() : 0;
+	current_scope = parent;
+
 	const auto diff = duration_cast<fpseconds>(now - start_time).count();
-	LOG(lvl,
-		"ScopeMeasure: function `%s' took %.6f s",
-		funcname,
-		diff);
+	if (counters.empty()) {
+		LOG(lvl,
+			"ScopeMeasure: function `%s' took %.6f s",
+			funcname,
+			diff);
+	} else {
+		std::string counters_str;
+		for (const auto& counter : counters) {
+			if (!counters_str.empty()) {
+				counters_str.append(", ");
+			}
+			counters_str.append(counter.first + ": " +
+				std::to_string(counter.second));
+		}
+		LOG(lvl,
+			"ScopeMeasure: function `%s' took %.6f s (%s)",
+			funcname,
+			diff,
+			counters_str);
+	}
+
+	if (tracing) {
+		TraceEvent event;
+		event.name = funcname;
+		event.phase = 'X';
+		event.tid = get_thread_id();
+		// Tracing might have started while this scope was already running;
+		// the trace only covers the part since then.
+		event.start_ns = std::max<std::int64_t>(
+				ns_since_trace_start(start_time), 0);
+		event.duration_ns = ns_since_trace_start(now) - event.start_ns;
+		event.thread_duration_ns = start_thread_cpu_ns != 0
+			? now_thread_cpu_ns - start_thread_cpu_ns
+			: 0;
+		event.args = std::move(counters);
+		record_event(std::move(event));
+	}
+}
+
+void ScopeMeasure::start_tracing(const std::string& filename)
+{
+	auto& trace = get_trace();
+	bool register_write_at_exit = false;
+	{
+		std::lock_guard<std::mutex> guard(trace.mtx);
+		if (tracing) {
+			return;
+		}
+		trace.filename = filename;
+		trace.start_time = std::chrono::steady_clock::now();
+		clear_events(trace);
+		if (!filename.empty() && !trace.write_at_exit_registered) {
+			trace.write_at_exit_registered = true;
+			register_write_at_exit = true;
+		}
+	}
+	tracing = true;
+
+	if (!filename.empty()) {
+		LOG(Level::INFO,
+			"ScopeMeasure::start_tracing: trace will be written to `%s'",
+			filename);
+	}
+	if (register_write_at_exit) {
+		// The trace object above is constructed before the handler is
+		// registered, so it's still alive when the handler runs.
+		std::atexit(&ScopeMeasure::write_trace);
+	}
+}
+
+void ScopeMeasure::stop_tracing()
+{
+	auto& trace = get_trace();
+	std::lock_guard<std::mutex> guard(trace.mtx);
+	tracing = false;
+	trace.filename.clear();
+	clear_events(trace);
+}
+
+bool ScopeMeasure::is_tracing()
+{
+	return tracing;
+}
+
+std::vector<ScopeMeasure::TraceEvent> ScopeMeasure::take_trace_events()
+{
+	auto& trace = get_trace();
+	std::lock_guard<std::mutex> guard(trace.mtx);
+	gather_events(trace);
+	std::vector<TraceEvent> events;
+	events.swap(trace.events);
+	trace.recorded = 0;
+	return events;
+}
+
+void ScopeMeasure::write_trace()
+{
+	if (!tracing) {
+		return;
+	}
+
+	auto& trace = get_trace();
+	std::lock_guard<std::mutex> guard(trace.mtx);
+	if (trace.filename.empty()) {
+		return;
+	}
+	gather_events(trace);
+
+	std::string out = "{\"traceEvents\":[";
+	bool first = true;
+	for (const auto& event : trace.events) {
+		if (!first) {
+			out.append(",\n");
+		}
+		first = false;
+		append_event(out, event);
+	}
+	out.append("],\"displayTimeUnit\":\"ns\"}\n");
+
+	std::ofstream f(trace.filename);
+	f << out;
+	if (!f) {
+		LOG(Level::ERROR,
+			"ScopeMeasure::write_trace: couldn't write trace to `%s'",
+			trace.filename);
+		return;
+	}
+
+	LOG(Level::INFO,
+		"ScopeMeasure::write_trace: wrote %" PRIu64 " events to `%s'",
+		static_cast<std::uint64_t>(trace.events.size()),
+		trace.filename);
+	if (trace.dropped > 0) {
+		LOG(Level::WARN,
+			"ScopeMeasure::write_trace: dropped %" PRIu64
+			" events because the trace was full",
+			trace.dropped.load());
+	}
 }
 
 } // namespace newsboat
@@ -154,18 +154,22 @@ void SelectFormAction::prepare()
 		const auto width = tags_list.get_width();
 
 		switch (type) {
-		case SelectionType::TAG:
+		case SelectionType::TAG: {
+			const auto counts =
+				v->get_ctrl()->get_feedcontainer()->get_counts_per_tag(tags);
 			for (const auto& tag : tags) {
 				listfmt.add_line(
 					utils::quote_for_stfl(
 						format_line(selecttag_format,
 							tag,
+							counts[i],
 							i + 1,
 							width)),
 					std::to_string(i));
 				i++;
 			}
-			break;
+		}
+		break;
 		case SelectionType::FILTER:
 			for (const auto& filter : filters) {
 				std::string tagstr = strprintf::fmt(
@@ -218,24 +222,17 @@ void SelectFormAction::init()
 
 std::string SelectFormAction::format_line(const std::string& selecttag_format,
 	const std::string& tag,
+	const TagCounts& counts,
 	unsigned int pos,
 	unsigned int width)
 {
 	FmtStrFormatter fmt;
 
-	const auto feedcontainer = v->get_ctrl()->get_feedcontainer();
-
-	const auto total_feeds = feedcontainer->get_feed_count_per_tag(tag);
-	const auto unread_feeds =
-		feedcontainer->get_unread_feed_count_per_tag(tag);
-	const auto unread_articles =
-		feedcontainer->get_unread_item_count_per_tag(tag);
-
 	fmt.register_fmt('i', strprintf::fmt("%u", pos));
 	fmt.register_fmt('T', tag);
-	fmt.register_fmt('f', std::to_string(unread_feeds));
-	fmt.register_fmt('n', std::to_string(unread_articles));
-	fmt.register_fmt('u', std::to_string(total_feeds));
+	fmt.register_fmt('f', std::to_string(counts.unread_feed_count));
+	fmt.register_fmt('n', std::to_string(counts.unread_item_count));
+	fmt.register_fmt('u', std::to_string(counts.feed_count));
 
 	auto formattedLine = fmt.do_format(selecttag_format, width);
 
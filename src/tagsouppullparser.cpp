@@ -3,15 +3,15 @@
 #include <algorithm>
 #include <cinttypes>
 #include <cstdlib>
-#include <iostream>
+#include <cstring>
 #include <istream>
-#include <sstream>
+#include <iterator>
 #include <stdexcept>
+#include <unordered_map>
 
 #include "config.h"
 #include "logger.h"
 #include "utils.h"
-#include "xmlexception.h"
 
 namespace newsboat {
 
@@ -19,10 +19,14 @@ namespace newsboat {
  * This method implements an "XML" pull parser. In reality, it's more liberal
  * than any XML pull parser, as it basically accepts everything that even only
  * remotely looks like XML. We use this parser for the HTML renderer.
+ *
+ * The input is scanned in place: text and tags are located with memchr()
+ * rather than by reading the input character by character.
  */
 
 TagSoupPullParser::TagSoupPullParser()
-	: inputstream(0)
+	: input_pos(nullptr)
+	, input_end(nullptr)
 	, current_event(Event::START_DOCUMENT)
 {
 }
@@ -31,7 +35,18 @@ TagSoupPullParser::~TagSoupPullParser() {}
 
 void TagSoupPullParser::set_input(std::istream& is)
 {
-	inputstream = &is;
+	input_buffer.assign(std::istreambuf_iterator<char>(is),
+		std::istreambuf_iterator<char>());
+	input_pos = input_buffer.data();
+	input_end = input_pos + input_buffer.length();
+	current_event = Event::START_DOCUMENT;
+}
+
+void TagSoupPullParser::set_input(const std::string& input)
+{
+	input_buffer.clear();
+	input_pos = input.data();
+	input_end = input_pos + input.length();
 	current_event = Event::START_DOCUMENT;
 }
 
@@ -51,7 +66,7 @@ TagSoupPullParser::Event TagSoupPullParser::get_event_type() const
 	return current_event;
 }
 
-std::string TagSoupPullParser::get_text() const
+const std::string& TagSoupPullParser::get_text() const
 {
 	return text;
 }
@@ -64,28 +79,25 @@ TagSoupPullParser::Event TagSoupPullParser::next()
 	 * event.
 	 */
 	attributes.clear();
-	text = "";
+	text.clear();
 
-	if (inputstream->eof()) {
+	if (input_pos == input_end) {
 		current_event = Event::END_DOCUMENT;
 	}
 
 	switch (current_event) {
 	case Event::START_DOCUMENT:
 	case Event::START_TAG:
-	case Event::END_TAG: {
-		char c = 0;
-		inputstream->read(&c, 1);
-		if (inputstream->eof()) {
-			current_event = Event::END_DOCUMENT;
-		} else if (c == '<') {
+	case Event::END_TAG:
+		if (*input_pos == '<') {
+			input_pos++;
 			handle_tag();
 		} else {
-			handle_text(c);
+			handle_text();
 		}
 		break;
-	}
 	case Event::TEXT:
+		// handle_text() already consumed the opening '<'
 		handle_tag();
 		break;
 	case Event::END_DOCUMENT:
@@ -120,18 +132,6 @@ void TagSoupPullParser::add_attribute(std::string s)
 	attributes.push_back(Attribute(attribname, attribvalue));
 }
 
-std::string TagSoupPullParser::read_tag()
-{
-	std::string s;
-	getline(*inputstream, s, '>');
-	if (inputstream->eof()) {
-		// TODO: test whether this works reliably
-		throw XmlException(
-			_("EOF found while reading XML tag"));
-	}
-	return s;
-}
-
 TagSoupPullParser::Event TagSoupPullParser::determine_tag_type()
 {
 	if (text.length() > 0 && text[0] == '/') {
@@ -158,20 +158,27 @@ std::string TagSoupPullParser::decode_attribute(const std::string& s)
 
 std::string TagSoupPullParser::decode_entities(const std::string& s)
 {
+	std::string::size_type amp = s.find('&');
+	if (amp == std::string::npos) {
+		return s;
+	}
+
 	std::string result;
-	std::istringstream sbuf(s);
-	std::string tmp;
-	getline(sbuf, tmp, '&');
-	while (!sbuf.eof()) {
-		result.append(tmp);
-		getline(sbuf, tmp, ';');
-		if (sbuf.eof()) {
+	result.reserve(s.length());
+	std::string::size_type pos = 0;
+	while (amp != std::string::npos) {
+		result.append(s, pos, amp - pos);
+		const auto semicolon = s.find(';', amp + 1);
+		if (semicolon == std::string::npos) {
+			// An ampersand without a matching semicolon is dropped
+			pos = amp + 1;
 			break;
 		}
-		result.append(decode_entity(tmp));
-		getline(sbuf, tmp, '&');
+		result.append(decode_entity(s.substr(amp + 1, semicolon - amp - 1)));
+		pos = semicolon + 1;
+		amp = s.find('&', pos);
 	}
-	result.append(tmp);
+	result.append(s, pos, std::string::npos);
 	return result;
 }
 
@@ -440,6 +447,18 @@ static struct {
 	{0, 0}
 };
 
+static const std::unordered_map<std::string, unsigned int>& entity_map()
+{
+	static const std::unordered_map<std::string, unsigned int> entities = []() {
+		std::unordered_map<std::string, unsigned int> result;
+		for (unsigned int i = 0; entity_table[i].entity; ++i) {
+			result.emplace(entity_table[i].entity, entity_table[i].value);
+		}
+		return result;
+	}();
+	return entities;
+}
+
 std::string TagSoupPullParser::decode_entity(std::string s)
 {
 	LOG(Level::DEBUG,
@@ -451,9 +470,7 @@ std::string TagSoupPullParser::decode_entity(std::string s)
 		char mbc[MB_CUR_MAX];
 		mbc[0] = '\0';
 		if (s[1] == 'x') {
-			s.erase(0, 2);
-			std::istringstream is(s);
-			is >> std::hex >> wc;
+			wc = std::strtoul(s.c_str() + 2, nullptr, 16);
 		} else {
 			s.erase(0, 1);
 			wc = utils::to_u(s);
@@ -503,15 +520,15 @@ std::string TagSoupPullParser::decode_entity(std::string s)
 			mbc);
 		return result;
 	} else {
-		for (unsigned int i = 0; entity_table[i].entity; ++i) {
-			if (s == entity_table[i].entity) {
-				char mbc[MB_CUR_MAX];
-				int pos = wctomb(mbc, entity_table[i].value);
-				if (pos == -1) {
-					return std::string();
-				} else {
-					return std::string(mbc, pos);
-				}
+		const auto& entities = entity_map();
+		const auto entity = entities.find(s);
+		if (entity != entities.end()) {
+			char mbc[MB_CUR_MAX];
+			int pos = wctomb(mbc, entity->second);
+			if (pos == -1) {
+				return std::string();
+			} else {
+				return std::string(mbc, pos);
 			}
 		}
 	}
@@ -594,23 +611,33 @@ void TagSoupPullParser::parse_tag(const std::string& tagstr)
 
 void TagSoupPullParser::handle_tag()
 {
-	std::string s;
-	try {
-		s = read_tag();
-	} catch (const XmlException&) {
+	const char* tag_end = static_cast<const char*>(
+			std::memchr(input_pos, '>', input_end - input_pos));
+	if (tag_end == nullptr) {
+		// Unterminated tag at the end of input
+		input_pos = input_end;
 		current_event = Event::END_DOCUMENT;
 		return;
 	}
-	parse_tag(s);
+
+	parse_tag(std::string(input_pos, tag_end));
+	input_pos = tag_end + 1;
 	current_event = determine_tag_type();
 }
 
-void TagSoupPullParser::handle_text(char c)
+void TagSoupPullParser::handle_text()
 {
-	text.push_back(c);
-	std::string tmp;
-	getline(*inputstream, tmp, '<');
-	text.append(tmp);
+	const char* text_end = static_cast<const char*>(
+			std::memchr(input_pos, '<', input_end - input_pos));
+	if (text_end == nullptr) {
+		text.assign(input_pos, input_end);
+		input_pos = input_end;
+	} else {
+		text.assign(input_pos, text_end);
+		// Skip the '<' as well, next() continues with the tag
+		input_pos = text_end + 1;
+	}
+
 	text = decode_entities(text);
 	utils::remove_soft_hyphens(text);
 	current_event = Event::TEXT;
@@ -77,11 +77,40 @@ std::vector<std::string> wrap_line(const std::string& line, const size_t width,
 		words.erase(words.cbegin());
 	}
 
+	// The width of `curline` is kept up to date as words are appended,
+	// rather than measuring the whole line for every word. That only works
+	// as long as widths add up, which isn't the case for STFL text with an
+	// unterminated tag: everything after its '<' is ignored until a '>'
+	// shows up. Such lines are measured in full.
 	std::string curline = prefix;
+	size_t curline_width = prefix_width;
+	bool inside_tag = false;
+	auto start_new_line = [&]() {
+		curline = prefix;
+		curline_width = prefix_width;
+		inside_tag = false;
+	};
+	auto append = [&](const std::string& text, size_t text_width) {
+		const bool was_inside_tag = inside_tag;
+		if (!raw) {
+			for (const char c : text) {
+				if (c == '<') {
+					inside_tag = true;
+				} else if (c == '>') {
+					inside_tag = false;
+				}
+			}
+		}
+		curline.append(text);
+		if (was_inside_tag || inside_tag) {
+			curline_width = strwidth(curline);
+		} else {
+			curline_width += text_width;
+		}
+	};
 
 	for (auto& word : words) {
 		size_t word_width = strwidth(word);
-		size_t curline_width = strwidth(curline);
 
 		// for languages (e.g., CJK) don't use a space as a word
 		// boundary
@@ -92,25 +121,23 @@ std::vector<std::string> wrap_line(const std::string& line, const size_t width,
 			curline.append(part);
 			word.erase(0, part.length());
 			result.push_back(curline);
-			curline = prefix;
+			start_new_line();
 			if (part.empty()) {
 				// discard the current word
 				word.clear();
 			}
 
 			word_width = strwidth(word);
-			curline_width = strwidth(curline);
 		}
 
 		if ((curline_width + word_width) > width) {
 			result.push_back(curline);
-			if (iswhitespace(word)) {
-				curline = prefix;
-			} else {
-				curline = prefix + word;
+			start_new_line();
+			if (!iswhitespace(word)) {
+				append(word, word_width);
 			}
 		} else {
-			curline.append(word);
+			append(word, word_width);
 		}
 	}
 
@@ -126,6 +126,23 @@ json TtRssApi::run_op(const std::string& op,
 	const std::map<std::string, std::string>& args,
 	bool try_login, /* = true */
 	CURL* cached_handle /* = nullptr */)
+{
+	return perform_op(op, args, nullptr, try_login, cached_handle);
+}
+
+json TtRssApi::run_op_streaming(const std::string& op,
+	const std::map<std::string, std::string>& args,
+	const std::function<void(json&)>& handle_element,
+	CURL* cached_handle /* = nullptr */)
+{
+	return perform_op(op, args, &handle_element, true, cached_handle);
+}
+
+json TtRssApi::perform_op(const std::string& op,
+	const std::map<std::string, std::string>& args,
+	const std::function<void(json&)>* handle_element,
+	bool try_login,
+	CURL* cached_handle)
 {
 	std::string url =
 		strprintf::fmt("%s/api/", cfg->get_configvalue("ttrss-url"));
@@ -154,19 +171,29 @@ json TtRssApi::run_op(const std::string& op,
 	std::string result = utils::retrieve_url(
 			url, cfg, auth_info, &req_data, cached_handle);
 
-	LOG(Level::DEBUG,
-		"TtRssApi::run_op(%s,...): post=%s reply = %s",
-		op,
-		req_data,
-		result);
+	if (handle_element == nullptr) {
+		LOG(Level::DEBUG,
+			"TtRssApi::run_op(%s,...): post=%s reply = %s",
+			op,
+			req_data,
+			result);
+	} else {
+		// Streamed replies are large (e.g. headlines with content), so
+		// don't copy them into the log
+		LOG(Level::DEBUG,
+			"TtRssApi::run_op(%s,...): post=%s reply = %" PRIu64 " bytes",
+			op,
+			req_data,
+			static_cast<uint64_t>(result.length()));
+	}
 
 	json reply;
 	try {
-		reply = json::parse(result);
+		reply = parse_reply(result, handle_element);
 	} catch (json::parse_error& e) {
 		LOG(Level::ERROR,
 			"TtRssApi::run_op: reply failed to parse: %s",
-			result);
+			handle_element == nullptr ? result : e.what());
 		return json(nullptr);
 	}
 
@@ -193,7 +220,8 @@ json TtRssApi::run_op(const std::string& op,
 	if (status != 0) {
 		if (content["error"] == "NOT_LOGGED_IN" && try_login) {
 			if (authenticate()) {
-				return run_op(op, args, false, cached_handle);
+				return perform_op(op, args, handle_element, false,
+						cached_handle);
 			} else {
 				return json(nullptr);
 			}
@@ -209,6 +237,55 @@ json TtRssApi::run_op(const std::string& op,
 	return content;
 }
 
+json TtRssApi::parse_reply(const std::string& reply,
+	const std::function<void(json&)>* handle_element)
+{
+	if (handle_element == nullptr) {
+		return json::parse(reply);
+	}
+
+	// The reply looks like {"seq": 0, "status": 0, "content": [...]}. Each
+	// object in the "content" array is handed over as soon as it's parsed
+	// and then dropped, so the whole array is never held in memory at once.
+	// Objects nested deeper, or inside a "content" that isn't an array
+	// (e.g. an error), are left alone.
+	std::string current_key;
+	bool in_content = false;
+	const json::parser_callback_t callback =
+		[&](int depth, json::parse_event_t event, json& parsed) {
+		if (depth == 1) {
+			if (event == json::parse_event_t::key) {
+				current_key = parsed.get<std::string>();
+			} else if (event == json::parse_event_t::array_start) {
+				in_content = current_key == "content";
+			} else if (event == json::parse_event_t::array_end) {
+				in_content = false;
+			}
+		} else if (depth == 2 && in_content &&
+			event == json::parse_event_t::object_end) {
+			(*handle_element)(parsed);
+			return false;
+		}
+		return true;
+	};
+
+	json parsed = json::parse(reply, callback);
+
+	// The parser leaves a placeholder for each object that was dropped
+	const auto content = parsed.find("content");
+	if (content != parsed.end() && content->is_array()) {
+		json kept = json::array();
+		for (auto& element : *content) {
+			if (!element.is_discarded()) {
+				kept.push_back(std::move(element));
+			}
+		}
+		*content = std::move(kept);
+	}
+
+	return parsed;
+}
+
 TaggedFeedUrl TtRssApi::feed_from_json(const json& jfeed,
 	const std::vector<std::string>& addtags)
 {
@@ -225,7 +302,6 @@ TaggedFeedUrl TtRssApi::feed_from_json(const json& jfeed,
 
 	auto url = strprintf::fmt("%s#%d", feed_url, feed_id);
 	return TaggedFeedUrl(url, tags);
-	// TODO: cache feed_id -> feed_url (or feed_url -> feed_id ?)
 }
 
 int TtRssApi::parse_category_id(const json& jcatid)
@@ -336,6 +412,25 @@ bool TtRssApi::mark_article_read(const std::string& guid, bool read)
 	return true;
 }
 
+bool TtRssApi::mark_articles_read(const std::vector<std::string>& guids,
+	bool read)
+{
+	if (guids.empty()) {
+		return true;
+	}
+
+	// updateArticle takes a comma-separated list of article IDs
+	std::string article_ids;
+	for (const auto& guid : guids) {
+		if (!article_ids.empty()) {
+			article_ids.push_back(',');
+		}
+		article_ids.append(guid);
+	}
+
+	return update_article(article_ids, 2, read ? 0 : 1);
+}
+
 bool TtRssApi::update_article_flags(const std::string& oldflags,
 	const std::string& newflags,
 	const std::string& guid)
@@ -368,100 +463,201 @@ bool TtRssApi::update_article_flags(const std::string& oldflags,
 	return success;
 }
 
-rsspp::Feed TtRssApi::fetch_feed(const std::string& id, CURL* cached_handle)
+rsspp::Feed TtRssApi::fetch_feed(const std::string& id,
+	std::string& sync_token,
+	CURL* cached_handle)
 {
 	rsspp::Feed f;
 
 	f.rss_version = rsspp::Feed::TTRSS_JSON;
 
+	if (!sync_token.empty() && take_prefetched(id, f.items, sync_token)) {
+		sort_items(f);
+		return f;
+	}
+
 	std::map<std::string, std::string> args;
 	args["feed_id"] = id;
 	args["show_content"] = "1";
 	args["include_attachments"] = "1";
-	json content = run_op("getHeadlines", args, true, cached_handle);
-
-	if (content.is_null()) {
-		return f;
+	if (!sync_token.empty()) {
+		args["since_id"] = sync_token;
 	}
 
-	if (!content.is_array()) {
+	int newest_id = 0;
+	const auto add_headline = [&](json& item_obj) {
+		int item_id = 0;
+		f.items.push_back(headline_to_item(item_obj, item_id));
+		newest_id = std::max(newest_id, item_id);
+	};
+
+	try {
+		const json content = run_op_streaming(
+				"getHeadlines", args, add_headline, cached_handle);
+
+		// Headlines are handed out while the reply is parsed, so a reply
+		// that turns out to be truncated or an error leaves some behind
+		if (content.is_null()) {
+			f.items.clear();
+			f.rss_version = rsspp::Feed::UNKNOWN;
+			return f;
+		}
+
+		if (!content.is_array()) {
+			LOG(Level::ERROR,
+				"TtRssApi::fetch_feed: content is not an array");
+			f.items.clear();
+			f.rss_version = rsspp::Feed::UNKNOWN;
+			return f;
+		}
+
+		LOG(Level::DEBUG,
+			"TtRssApi::fetch_feed: %" PRIu64 " items",
+			static_cast<uint64_t>(f.items.size()));
+
+		if (newest_id != 0) {
+			sync_token = std::to_string(newest_id);
+		}
+		skip_prefetched(sync_token);
+	} catch (json::exception& e) {
 		LOG(Level::ERROR,
-			"TtRssApi::fetch_feed: content is not an array");
+			"Exception occurred while parsing feeed: ",
+			e.what());
+		f.items.clear();
+		f.rss_version = rsspp::Feed::UNKNOWN;
 		return f;
 	}
 
-	LOG(Level::DEBUG,
-		"TtRssApi::fetch_feed: %" PRIu64 " items",
-		static_cast<uint64_t>(content.size()));
+	sort_items(f);
 
-	try {
-		for (const auto& item_obj : content) {
-			rsspp::Item item;
+	return f;
+}
 
-			if (!item_obj["title"].is_null()) {
-				item.title = item_obj["title"];
-			}
+bool TtRssApi::prefetch_feeds(const std::string& since)
+{
+	std::map<std::string, std::vector<rsspp::Item>> items;
+	int newest_id = utils::to_u(since, 0);
+	unsigned int skip = 0;
 
-			if (!item_obj["link"].is_null()) {
-				item.link = item_obj["link"];
-			}
+	// The server caps the page size (at 200 in recent versions), so keep
+	// asking until it runs out of articles rather than relying on the limit
+	while (true) {
+		std::map<std::string, std::string> args;
+		// -4 is the "All articles" virtual feed
+		args["feed_id"] = "-4";
+		args["show_content"] = "1";
+		args["include_attachments"] = "1";
+		args["since_id"] = since;
+		args["limit"] = std::to_string(PREFETCH_PAGE_SIZE);
+		args["skip"] = std::to_string(skip);
+		unsigned int page_size = 0;
+		const auto add_headline = [&](json& item_obj) {
+			// feed_id is a string in some versions of Tiny Tiny RSS and an
+			// integer in others
+			const json& feed_id = item_obj["feed_id"];
+			const std::string id = feed_id.is_string()
+				? feed_id.get<std::string>()
+				: std::to_string(feed_id.get<int>());
+
+			int item_id = 0;
+			items[id].push_back(headline_to_item(item_obj, item_id));
+			newest_id = std::max(newest_id, item_id);
+			page_size++;
+		};
+
+		json content;
+		try {
+			content = run_op_streaming("getHeadlines", args, add_headline);
+		} catch (json::exception& e) {
+			LOG(Level::ERROR,
+				"TtRssApi::prefetch_feeds: failed to parse articles: %s",
+				e.what());
+			return false;
+		}
 
-			if (!item_obj["author"].is_null()) {
-				item.author = item_obj["author"];
-			}
+		if (content.is_null() || !content.is_array()) {
+			LOG(Level::ERROR,
+				"TtRssApi::prefetch_feeds: request failed, falling "
+				"back to fetching feeds one by one");
+			return false;
+		}
 
-			if (!item_obj["content"].is_null()) {
-				item.content_encoded = item_obj["content"];
-			}
+		if (page_size == 0) {
+			break;
+		}
 
-			if (!item_obj["attachments"].is_null()) {
-				if (item_obj["attachments"].size() >= 1) {
-					json a =
-						item_obj["attachments"].front();
-					if (!a["content_url"].is_null()) {
-						item.enclosure_url =
-							a["content_url"];
-					}
-					if (!a["content_type"].is_null()) {
-						item.enclosure_type =
-							a["content_type"];
-					}
-				}
-			}
+		skip += page_size;
+	}
 
-			int id = item_obj["id"];
-			item.guid = strprintf::fmt("%d", id);
+	LOG(Level::DEBUG,
+		"TtRssApi::prefetch_feeds: %u articles in %" PRIu64 " feeds",
+		skip,
+		static_cast<uint64_t>(items.size()));
 
-			bool unread = item_obj["unread"];
-			if (unread) {
-				item.labels.push_back("ttrss:unread");
-			} else {
-				item.labels.push_back("ttrss:read");
-			}
+	store_prefetched(std::move(items), std::to_string(newest_id));
+	return true;
+}
+
+rsspp::Item TtRssApi::headline_to_item(const json& item_obj, int& item_id)
+{
+	rsspp::Item item;
 
-			int updated_time = item_obj["updated"];
-			time_t updated = static_cast<time_t>(updated_time);
+	if (!item_obj["title"].is_null()) {
+		item.title = item_obj["title"];
+	}
 
-			item.pubDate = utils::mt_strf_localtime(
-					"%a, %d %b %Y %H:%M:%S %z",
-					updated);
-			item.pubDate_ts = updated;
+	if (!item_obj["link"].is_null()) {
+		item.link = item_obj["link"];
+	}
+
+	if (!item_obj["author"].is_null()) {
+		item.author = item_obj["author"];
+	}
 
-			f.items.push_back(item);
+	if (!item_obj["content"].is_null()) {
+		item.content_encoded = item_obj["content"];
+	}
+
+	if (!item_obj["attachments"].is_null()) {
+		if (item_obj["attachments"].size() >= 1) {
+			json a = item_obj["attachments"].front();
+			if (!a["content_url"].is_null()) {
+				item.enclosure_url = a["content_url"];
+			}
+			if (!a["content_type"].is_null()) {
+				item.enclosure_type = a["content_type"];
+			}
 		}
-	} catch (json::exception& e) {
-		LOG(Level::ERROR,
-			"Exception occurred while parsing feeed: ",
-			e.what());
 	}
 
+	item_id = item_obj["id"];
+	item.guid = strprintf::fmt("%d", item_id);
+
+	bool unread = item_obj["unread"];
+	if (unread) {
+		item.labels.push_back("ttrss:unread");
+	} else {
+		item.labels.push_back("ttrss:read");
+	}
+
+	int updated_time = item_obj["updated"];
+	time_t updated = static_cast<time_t>(updated_time);
+
+	item.pubDate = utils::mt_strf_localtime(
+			"%a, %d %b %Y %H:%M:%S %z",
+			updated);
+	item.pubDate_ts = updated;
+
+	return item;
+}
+
+void TtRssApi::sort_items(rsspp::Feed& f)
+{
 	std::sort(f.items.begin(),
 		f.items.end(),
 	[](const rsspp::Item& a, const rsspp::Item& b) {
 		return a.pubDate_ts > b.pubDate_ts;
 	});
-
-	return f;
 }
 
 void TtRssApi::fetch_feeds_per_category(const json& cat,
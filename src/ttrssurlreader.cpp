@@ -36,7 +36,7 @@ void TtRssUrlReader::reload()
 		}
 	}
 
-	auto feedurls = api->get_subscribed_urls();
+	auto feedurls = api->get_subscriptions();
 
 	for (const auto& url : feedurls) {
 		LOG(Level::DEBUG, "added %s to URL list", url.first);
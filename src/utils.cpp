@@ -15,6 +15,7 @@
 #include <langinfo.h>
 #include <libxml/uri.h>
 #include <locale>
+#include <map>
 #include <mutex>
 #include <pwd.h>
 #include <regex>
@@ -25,6 +26,7 @@
 #include <sys/utsname.h>
 #include <unistd.h>
 #include <unordered_set>
+#include <utility>
 
 #include "config.h"
 #include "htmlrenderer.h"
@@ -315,26 +317,59 @@ std::string utils::translit(const std::string& tocode,
 			: (tocode));
 }
 
+namespace {
+
+/// Conversion descriptors opened by the current thread, keyed by (tocode,
+/// fromcode). Opening a descriptor is much more expensive than the
+/// conversion of a typical title, so we keep them around.
+class IconvCache {
+public:
+	~IconvCache()
+	{
+		for (const auto& entry : descriptors) {
+			::iconv_close(entry.second);
+		}
+	}
+
+	iconv_t get(const std::string& tocode, const std::string& fromcode)
+	{
+		auto key = std::make_pair(tocode, fromcode);
+		const auto it = descriptors.find(key);
+		if (it != descriptors.end()) {
+			// Reset the shift state left over from the previous conversion
+			::iconv(it->second, nullptr, nullptr, nullptr, nullptr);
+			return it->second;
+		}
+
+		iconv_t cd = ::iconv_open(tocode.c_str(), fromcode.c_str());
+		if (cd != reinterpret_cast<iconv_t>(-1)) {
+			descriptors.emplace(std::move(key), cd);
+		}
+		return cd;
+	}
+
+private:
+	std::map<std::pair<std::string, std::string>, iconv_t> descriptors;
+};
+
+thread_local IconvCache iconv_cache;
+
+} // namespace
+
 std::string utils::convert_text(const std::string& text,
 	const std::string& tocode,
 	const std::string& fromcode)
 {
-	std::string result;
-
 	if (strcasecmp(tocode.c_str(), fromcode.c_str()) == 0) {
 		return text;
 	}
 
-	iconv_t cd = ::iconv_open(
-			translit(tocode, fromcode).c_str(), fromcode.c_str());
+	iconv_t cd = iconv_cache.get(translit(tocode, fromcode), fromcode);
 
 	if (cd == reinterpret_cast<iconv_t>(-1)) {
-		return result;
+		return {};
 	}
 
-	size_t inbytesleft;
-	size_t outbytesleft;
-
 	/*
 	 * of all the Unix-like systems around there, only Linux/glibc seems to
 	 * come with a SuSv3-conforming iconv implementation.
@@ -346,46 +381,45 @@ std::string utils::convert_text(const std::string& text,
 #else
 	char* inbufp;
 #endif
-	char outbuf[16];
-	char* outbufp = outbuf;
-
-	outbytesleft = sizeof(outbuf);
 	inbufp = const_cast<char*>(
 			text.c_str()); // evil, but spares us some trouble
-	inbytesleft = strlen(inbufp);
-
-	do {
-		char* old_outbufp = outbufp;
-		int rc = ::iconv(
+	size_t inbytesleft = strlen(inbufp);
+
+	// Conversions rarely change the length by much, so we start with an
+	// output buffer the size of the input and grow it when iconv asks for
+	// more room.
+	std::string result(std::max<size_t>(inbytesleft, 16), '\0');
+	size_t produced = 0;
+
+	while (inbytesleft > 0) {
+		char* outbufp = &result[produced];
+		size_t outbytesleft = result.length() - produced;
+		const size_t rc = ::iconv(
 				cd, &inbufp, &inbytesleft, &outbufp, &outbytesleft);
-		if (-1 == rc) {
+		produced = outbufp - &result[0];
+		if (rc == static_cast<size_t>(-1)) {
 			switch (errno) {
 			case E2BIG:
-				result.append(
-					old_outbufp, outbufp - old_outbufp);
-				outbufp = outbuf;
-				outbytesleft = sizeof(outbuf);
-				inbufp += strlen(inbufp) - inbytesleft;
-				inbytesleft = strlen(inbufp);
+				result.resize(result.length() * 2);
 				break;
 			case EILSEQ:
 			case EINVAL:
-				result.append(
-					old_outbufp, outbufp - old_outbufp);
-				result.append("?");
-				inbufp += strlen(inbufp) - inbytesleft + 1;
-				inbytesleft = strlen(inbufp);
+				// replace the offending byte and carry on
+				if (produced == result.length()) {
+					result.resize(result.length() * 2);
+				}
+				result[produced++] = '?';
+				inbufp++;
+				inbytesleft--;
 				break;
 			default:
+				inbytesleft = 0;
 				break;
 			}
-		} else {
-			result.append(old_outbufp, outbufp - old_outbufp);
 		}
-	} while (inbytesleft > 0);
-
-	iconv_close(cd);
+	}
 
+	result.resize(produced);
 	return result;
 }
 
@@ -395,7 +429,12 @@ std::string utils::utf8_to_locale(const std::string& text)
 		return {};
 	}
 
-	return utils::convert_text(text, nl_langinfo(CODESET), "utf-8");
+	const char* codeset = nl_langinfo(CODESET);
+	if (strcasecmp(codeset, "utf-8") == 0 || strcasecmp(codeset, "utf8") == 0) {
+		return text;
+	}
+
+	return utils::convert_text(text, codeset, "utf-8");
 }
 
 std::string utils::get_command_output(const std::string& cmd)
@@ -497,7 +536,10 @@ std::string utils::replace_all(std::string str,
 	const std::string& from,
 	const std::string& to)
 {
-	return RustString( rs_replace_all(str.c_str(), from.c_str(), to.c_str()) );
+	std::string result;
+	rs_replace_all(str.data(), str.size(), from.data(), from.size(),
+		to.data(), to.size(), &result, assign_to_std_string);
+	return result;
 }
 
 std::wstring utils::str2wstr(const std::string& str)
@@ -587,14 +629,33 @@ std::vector<std::pair<unsigned int, unsigned int>> utils::partition_indexes(
 	return partitions;
 }
 
+namespace {
+
+bool is_printable_ascii(const std::string& str)
+{
+	return std::all_of(str.cbegin(), str.cend(), [](char c) {
+		return c >= 0x20 && c < 0x7f;
+	});
+}
+
+} // namespace
+
 size_t utils::strwidth(const std::string& str)
 {
-	return rs_strwidth(str.c_str());
+	// Every printable ASCII character is one column wide, so we don't need to
+	// cross into Rust for the most common case
+	if (is_printable_ascii(str)) {
+		return str.length();
+	}
+	return rs_strwidth(str.data(), str.size());
 }
 
 size_t utils::strwidth_stfl(const std::string& str)
 {
-	return rs_strwidth_stfl(str.c_str());
+	if (str.find('<') == std::string::npos && is_printable_ascii(str)) {
+		return str.length();
+	}
+	return rs_strwidth_stfl(str.data(), str.size());
 }
 
 size_t utils::wcswidth_stfl(const std::wstring& str, size_t size)
@@ -622,13 +683,25 @@ size_t utils::wcswidth_stfl(const std::wstring& str, size_t size)
 std::string utils::substr_with_width(const std::string& str,
 	const size_t max_width)
 {
-	return RustString(rs_substr_with_width(str.c_str(), max_width));
+	if (is_printable_ascii(str)) {
+		return str.substr(0, max_width);
+	}
+	std::string result;
+	rs_substr_with_width(str.data(), str.size(), max_width, &result,
+		assign_to_std_string);
+	return result;
 }
 
 std::string utils::substr_with_width_stfl(const std::string& str,
 	const size_t max_width)
 {
-	return RustString(rs_substr_with_width_stfl(str.c_str(), max_width));
+	if (str.find('<') == std::string::npos && is_printable_ascii(str)) {
+		return str.substr(0, max_width);
+	}
+	std::string result;
+	rs_substr_with_width_stfl(str.data(), str.size(), max_width, &result,
+		assign_to_std_string);
+	return result;
 }
 
 std::string utils::join(const std::vector<std::string>& strings,
@@ -675,22 +748,28 @@ bool utils::is_exec_url(const std::string& url)
 
 std::string utils::censor_url(const std::string& url)
 {
-	return RustString(rs_censor_url(url.c_str()));
+	std::string result;
+	rs_censor_url(url.data(), url.size(), &result, assign_to_std_string);
+	return result;
 }
 
 std::string utils::quote_for_stfl(std::string str)
 {
-	return RustString(rs_quote_for_stfl(str.c_str()));
+	std::string result;
+	rs_quote_for_stfl(str.data(), str.size(), &result, assign_to_std_string);
+	return result;
 }
 
 void utils::trim(std::string& str)
 {
-	str = RustString(rs_trim(str.c_str()));
+	// The result is a substring of the input, so it's safe to write it back
+	// into the same string
+	rs_trim(str.data(), str.size(), &str, assign_to_std_string);
 }
 
 void utils::trim_end(std::string& str)
 {
-	str = RustString(rs_trim_end(str.c_str()));
+	rs_trim_end(str.data(), str.size(), &str, assign_to_std_string);
 }
 
 std::string utils::quote(const std::string& str)
@@ -885,7 +964,7 @@ std::string utils::getcwd()
 
 int utils::strnaturalcmp(const std::string& a, const std::string& b)
 {
-	return rs_strnaturalcmp(a.c_str(), b.c_str());
+	return rs_strnaturalcmp(a.data(), a.size(), b.data(), b.size());
 }
 
 void utils::remove_soft_hyphens(std::string& text)
@@ -55,6 +55,10 @@ extern "C" {
 
 namespace {
 bool ctrl_c_hit = false;
+
+// Enough for the current article, the ones pre-rendered around it, and a few
+// that were recently looked at
+const std::size_t ITEM_RENDER_CACHE_SIZE = 16;
 }
 
 namespace newsboat {
@@ -65,6 +69,7 @@ View::View(Controller* c)
 	, keys(0)
 	, current_formaction(0)
 	, rxman(c->get_regexmanager())
+	, item_render_cache(ITEM_RENDER_CACHE_SIZE)
 	, is_inside_qna(false)
 	, is_inside_cmdline(false)
 	, tab_count(0)
@@ -162,8 +167,11 @@ int View::run()
 				macrocmds.erase(macrocmds.begin());
 			}
 		} else {
-			// we then receive the event and ignore timeouts.
-			const char* event = fa->get_form().run(60000);
+			// we then receive the event and ignore timeouts. If the
+			// formaction has something to do in the meantime, we only
+			// wait for a moment and then let it do a bit of that work.
+			const bool idle_work = fa->has_idle_work();
+			const char* event = fa->get_form().run(idle_work ? 1 : 60000);
 
 			if (ctrl_c_hit) {
 				ctrl_c_hit = false;
@@ -179,6 +187,9 @@ int View::run()
 			}
 
 			if (!event || strcmp(event, "TIMEOUT") == 0) {
+				if (idle_work) {
+					fa->do_idle_work();
+				}
 				continue;
 			}
 
@@ -399,6 +410,7 @@ void View::set_feedlist(std::vector<std::shared_ptr<RssFeed>> feeds)
 
 void View::set_tags(const std::vector<std::string>& t)
 {
+	std::lock_guard<std::mutex> lock(mtx);
 	tags = t;
 }
 
@@ -480,7 +492,8 @@ void View::push_itemview(std::shared_ptr<RssFeed> f,
 		assert(itemlist != nullptr);
 		std::shared_ptr<ItemViewFormAction> itemview(
 			new ItemViewFormAction(
-				this, itemlist, itemview_str, rsscache, cfg, rxman));
+				this, itemlist, itemview_str, rsscache, cfg, rxman,
+				item_render_cache));
 		itemview->set_feed(f);
 		itemview->set_guid(guid);
 		itemview->set_parent_formaction(fa);
@@ -576,6 +589,11 @@ std::string View::run_dirbrowser(const std::string& dir)
 
 std::string View::select_tag()
 {
+	std::vector<std::string> tags;
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		tags = this->tags;
+	}
 	if (tags.size() == 0) {
 		show_error(_("No tags defined."));
 		return "";
@@ -123,6 +123,82 @@ TEST_CASE("Last-Modified and ETag values are persisted to DB", "[Cache]")
 	}
 }
 
+TEST_CASE("Remote API sync state is persisted to DB", "[Cache]")
+{
+	std::unique_ptr<ConfigContainer> cfg(new ConfigContainer());
+	TestHelpers::TempFile dbfile;
+	std::unique_ptr<Cache> rsscache(new Cache(dbfile.get_path(), cfg.get()));
+	const auto feedurl = "file://data/rss.xml";
+	RssParser parser(feedurl, rsscache.get(), cfg.get(), nullptr);
+	std::shared_ptr<RssFeed> feed = parser.parse();
+	rsscache->externalize_rssfeed(feed, false);
+
+	std::string token = "42";
+	time_t last_full_sync = 42;
+	rsscache->fetch_sync_state(feedurl, token, last_full_sync);
+	REQUIRE(token == "");
+	REQUIRE(last_full_sync == 0);
+
+	REQUIRE_NOTHROW(rsscache->update_sync_state(feedurl, "1234", 1476382350));
+
+	cfg.reset(new ConfigContainer());
+	rsscache.reset(new Cache(dbfile.get_path(), cfg.get()));
+
+	rsscache->fetch_sync_state(feedurl, token, last_full_sync);
+	REQUIRE(token == "1234");
+	REQUIRE(last_full_sync == 1476382350);
+
+	SECTION("Re-fetching a feed doesn't reset its sync state") {
+		RssParser parser(feedurl, rsscache.get(), cfg.get(), nullptr);
+		rsscache->externalize_rssfeed(parser.parse(), false);
+
+		rsscache->fetch_sync_state(feedurl, token, last_full_sync);
+		REQUIRE(token == "1234");
+		REQUIRE(last_full_sync == 1476382350);
+	}
+}
+
+TEST_CASE("Remote subscriptions are persisted to DB, separately for each "
+	"backend",
+	"[Cache]")
+{
+	using Subscriptions =
+		std::vector<std::pair<std::string, std::vector<std::string>>>;
+
+	ConfigContainer cfg;
+	TestHelpers::TempFile dbfile;
+
+	const Subscriptions ttrss = {
+		{"https://example.com/b.xml", {"news", "Some Feed"}},
+		{"https://example.com/a.xml", {}},
+	};
+	const Subscriptions oldreader = {
+		{"https://example.org/feed", {"tech"}},
+	};
+
+	{
+		Cache rsscache(dbfile.get_path(), &cfg);
+		REQUIRE(rsscache.get_remote_subscriptions("ttrss").empty());
+
+		rsscache.set_remote_subscriptions("ttrss", ttrss);
+		rsscache.set_remote_subscriptions("oldreader", oldreader);
+	}
+
+	Cache rsscache(dbfile.get_path(), &cfg);
+	REQUIRE(rsscache.get_remote_subscriptions("ttrss") == ttrss);
+	REQUIRE(rsscache.get_remote_subscriptions("oldreader") == oldreader);
+
+	SECTION("Saving subscriptions replaces the previous ones") {
+		const Subscriptions updated = {
+			{"https://example.com/a.xml", {"news"}},
+		};
+		rsscache.set_remote_subscriptions("ttrss", updated);
+
+		REQUIRE(rsscache.get_remote_subscriptions("ttrss") == updated);
+		REQUIRE(rsscache.get_remote_subscriptions("oldreader") == oldreader);
+	}
+}
+
 TEST_CASE("mark_all_read marks all items in the feed read", "[Cache]")
 {
 	std::shared_ptr<RssFeed> feed, test_feed;
@@ -860,6 +936,16 @@ TEST_CASE(
 		feed = rsscache->internalize_rssfeed(feedurl, nullptr);
 		REQUIRE(feed->items()[0]->unread());
 	}
+
+	SECTION("override_unread is set, but the read state change hasn't been "
+		"sent to the server yet; item remains read") {
+		rsscache->outbox_add_read_state("ttrss", item->guid(), true);
+		item->set_override_unread(true);
+		rsscache->externalize_rssfeed(feed, false);
+		rsscache.reset(new Cache(dbfile.get_path(), &cfg));
+		feed = rsscache->internalize_rssfeed(feedurl, nullptr);
+		REQUIRE_FALSE(feed->items()[0]->unread());
+	}
 }
 
 TEST_CASE(
@@ -627,6 +627,95 @@ TEST_CASE("Resolves tilde to homedir in -d/--log-file", "[CliArgsParser]")
 	}
 }
 
+TEST_CASE("Sets `trace_file` if --trace-file is provided", "[CliArgsParser]")
+{
+	const std::string filename("trace.json");
+
+	auto check = [&filename](TestHelpers::Opts opts) {
+		CliArgsParser args(opts.argc(), opts.argv());
+
+		REQUIRE(args.trace_file() == filename);
+	};
+
+	SECTION("--trace-file=") {
+		check({"newsboat", "--trace-file=" + filename});
+	}
+
+	SECTION("--trace-file") {
+		check({"newsboat", "--trace-file", filename});
+	}
+}
+
+TEST_CASE("Doesn't set `trace_file` if --trace-file is not provided",
+	"[CliArgsParser]")
+{
+	TestHelpers::Opts opts = {"newsboat"};
+	CliArgsParser args(opts.argc(), opts.argv());
+
+	REQUIRE_FALSE(args.trace_file().has_value());
+}
+
+TEST_CASE("Sets `record_http` if --record-http is provided", "[CliArgsParser]")
+{
+	const std::string filename("responses.archive");
+
+	auto check = [&filename](TestHelpers::Opts opts) {
+		CliArgsParser args(opts.argc(), opts.argv());
+
+		REQUIRE(args.record_http() == filename);
+		REQUIRE_FALSE(args.replay_http().has_value());
+	};
+
+	SECTION("--record-http=") {
+		check({"newsboat", "--record-http=" + filename});
+	}
+
+	SECTION("--record-http") {
+		check({"newsboat", "--record-http", filename});
+	}
+}
+
+TEST_CASE("Sets `replay_http` if --replay-http is provided", "[CliArgsParser]")
+{
+	const std::string filename("responses.archive");
+
+	SECTION("Without --replay-http-timing") {
+		TestHelpers::Opts opts = {"newsboat", "--replay-http", filename};
+		CliArgsParser args(opts.argc(), opts.argv());
+
+		REQUIRE(args.replay_http() == filename);
+		REQUIRE_FALSE(args.replay_http_timing());
+		REQUIRE_FALSE(args.record_http().has_value());
+	}
+
+	SECTION("With --replay-http-timing") {
+		TestHelpers::Opts opts = {
+			"newsboat",
+			"--replay-http=" + filename,
+			"--replay-http-timing"
+		};
+		CliArgsParser args(opts.argc(), opts.argv());
+
+		REQUIRE(args.replay_http() == filename);
+		REQUIRE(args.replay_http_timing());
+	}
+}
+
+TEST_CASE("Asks to print usage and exit with failure if both --record-http "
+	"and --replay-http are provided",
+	"[CliArgsParser]")
+{
+	TestHelpers::Opts opts = {
+		"newsboat",
+		"--record-http=a.archive",
+		"--replay-http=b.archive"
+	};
+	CliArgsParser args(opts.argc(), opts.argv());
+
+	REQUIRE(args.should_print_usage());
+	REQUIRE(args.return_code() == EXIT_FAILURE);
+}
+
 TEST_CASE(
 	"Sets `log_level` if argument to -l/--log-level is in range of [1; 6]",
 	"[CliArgsParser]")
@@ -0,0 +1,372 @@
+#include "downloadscheduler.h"
+
+#include <arpa/inet.h>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <netinet/in.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+#include "3rd-party/catch.hpp"
+#include "configcontainer.h"
+#include "test-helpers/tempdir.h"
+
+using namespace podboat;
+
+namespace {
+
+/// Writes \a size bytes to \a path, and returns a URL for it.
+std::string make_source(const std::string& path, std::size_t size)
+{
+	std::ofstream out(path);
+	out << std::string(size, 'x');
+	out.close();
+	return "file://" + path;
+}
+
+std::string read_file(const std::string& path)
+{
+	std::ifstream in(path);
+	return std::string(std::istreambuf_iterator<char>(in),
+			std::istreambuf_iterator<char>());
+}
+
+bool wait_for(std::function<bool()> condition)
+{
+	const auto deadline =
+		std::chrono::steady_clock::now() + std::chrono::seconds(10);
+	while (!condition()) {
+		if (std::chrono::steady_clock::now() > deadline) {
+			return false;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	return true;
+}
+
+/// A local HTTP server that answers every request with \a body_size bytes,
+/// or, if \a respond is false, accepts connections but never answers.
+class LocalServer {
+public:
+	LocalServer(std::size_t body_size, bool respond)
+	{
+		listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+		sockaddr_in addr{};
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = 0;
+		socklen_t len = sizeof(addr);
+		if (listen_fd == -1
+			|| ::bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), len) != 0
+			|| ::listen(listen_fd, 16) != 0
+			|| ::getsockname(listen_fd,
+				reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+			throw std::runtime_error("LocalServer: can't listen");
+		}
+		port = ntohs(addr.sin_port);
+
+		if (respond) {
+			acceptor = std::thread([this, body_size]() {
+				int fd;
+				while ((fd = ::accept(listen_fd, nullptr, nullptr)) != -1) {
+					connections.emplace_back([fd, body_size]() {
+						serve(fd, body_size);
+					});
+				}
+			});
+		}
+	}
+
+	~LocalServer()
+	{
+		::shutdown(listen_fd, SHUT_RDWR);
+		::close(listen_fd);
+		if (acceptor.joinable()) {
+			acceptor.join();
+		}
+		for (auto& connection : connections) {
+			connection.join();
+		}
+	}
+
+	std::string url(const std::string& path) const
+	{
+		return "http://127.0.0.1:" + std::to_string(port) + "/" + path;
+	}
+
+private:
+	static void serve(int fd, std::size_t body_size)
+	{
+		std::string request;
+		char buf[1024];
+		while (request.find("\r\n\r\n") == std::string::npos) {
+			const auto received = ::recv(fd, buf, sizeof(buf), 0);
+			if (received <= 0) {
+				::close(fd);
+				return;
+			}
+			request.append(buf, received);
+		}
+
+		const std::string response = "HTTP/1.1 200 OK\r\n"
+			"Content-Length: " + std::to_string(body_size) + "\r\n"
+			"Connection: close\r\n\r\n" + std::string(body_size, 'x');
+		std::size_t sent = 0;
+		while (sent < response.size()) {
+			const auto result = ::send(fd, response.data() + sent,
+					response.size() - sent, MSG_NOSIGNAL);
+			if (result <= 0) {
+				break;
+			}
+			sent += result;
+		}
+		::close(fd);
+	}
+
+	int listen_fd;
+	uint16_t port;
+	std::thread acceptor;
+	std::vector<std::thread> connections;
+};
+
+} // namespace
+
+TEST_CASE("share_bandwidth() splits the budget evenly, up to the cap",
+	"[DownloadScheduler]")
+{
+	SECTION("Everyone gets an equal share") {
+		std::vector<double> tokens = {0, 0, 0};
+		REQUIRE(DownloadScheduler::share_bandwidth(tokens, 300, 1000) == 0);
+		REQUIRE(tokens == std::vector<double>({100, 100, 100}));
+	}
+
+	SECTION("What doesn't fit under the cap goes to the others") {
+		std::vector<double> tokens = {90, 0, -50};
+		REQUIRE(DownloadScheduler::share_bandwidth(tokens, 210, 100) == 0);
+		REQUIRE(tokens == std::vector<double>({100, 100, 50}));
+	}
+
+	SECTION("Transfers already at the cap get nothing") {
+		std::vector<double> tokens = {100, 0};
+		REQUIRE(DownloadScheduler::share_bandwidth(tokens, 50, 100) == 0);
+		REQUIRE(tokens == std::vector<double>({100, 50}));
+	}
+
+	SECTION("What doesn't fit anywhere is returned") {
+		std::vector<double> tokens = {50, 80};
+		REQUIRE(DownloadScheduler::share_bandwidth(tokens, 100, 100) == 30);
+		REQUIRE(tokens == std::vector<double>({100, 100}));
+	}
+}
+
+TEST_CASE("refill() limits the total speed of all transfers, and splits it "
+	"evenly",
+	"[DownloadScheduler]")
+{
+	const double bytes_per_second = 100 * 1024;
+	const double tick = std::chrono::duration<double>(
+			DownloadScheduler::TICK).count();
+	// Like curl, hand over data in chunks, and take the whole chunk even if
+	// it's more than what's left of the allowance
+	const double chunk = 16 * 1024;
+
+	std::vector<double> tokens(2, 0);
+	std::vector<double> received(2, 0);
+	const unsigned int ticks = 50;
+	for (unsigned int t = 0; t < ticks; t++) {
+		DownloadScheduler::refill(tokens, bytes_per_second, tick);
+		for (std::size_t i = 0; i < tokens.size(); i++) {
+			while (tokens[i] > 0) {
+				tokens[i] -= chunk;
+				received[i] += chunk;
+			}
+		}
+	}
+
+	const double limit = bytes_per_second * tick * ticks;
+	const double total = received[0] + received[1];
+	// At most one chunk per transfer more than the limit allows
+	REQUIRE(total <= limit + 2 * chunk);
+	REQUIRE(total >= limit - 2 * chunk);
+	REQUIRE(std::abs(received[0] - received[1]) <= chunk);
+
+	SECTION("Idle transfers don't save up for a burst") {
+		std::vector<double> idle(2, 0);
+		DownloadScheduler::refill(idle, bytes_per_second, 60);
+		REQUIRE(idle[0] + idle[1] <= bytes_per_second);
+	}
+}
+
+TEST_CASE("DownloadScheduler downloads files and renames them once they're "
+	"complete",
+	"[DownloadScheduler]")
+{
+	TestHelpers::TempDir tmp;
+	newsboat::ConfigContainer cfg;
+
+	const auto callback = []() {};
+	std::vector<Download> downloads(3, Download(callback));
+	DownloadScheduler scheduler(&cfg);
+	scheduler.set_max_parallel(2);
+
+	for (std::size_t i = 0; i < downloads.size(); i++) {
+		const auto name = std::to_string(i);
+		downloads[i].set_url(make_source(tmp.get_path() + "source" + name,
+				10000 * (i + 1)));
+		downloads[i].set_filename(tmp.get_path() + "dir/" + name + ".mp3");
+		scheduler.enqueue(&downloads[i], DlPriority::NORMAL);
+	}
+
+	for (std::size_t i = 0; i < downloads.size(); i++) {
+		REQUIRE(wait_for([&]() {
+			return downloads[i].status() == DlStatus::READY;
+		}));
+		REQUIRE(read_file(downloads[i].filename()) ==
+			std::string(10000 * (i + 1), 'x'));
+		REQUIRE(::access((downloads[i].filename() + ".part").c_str(), F_OK)
+			!= 0);
+	}
+}
+
+TEST_CASE("DownloadScheduler marks downloads that can't be fetched as failed",
+	"[DownloadScheduler]")
+{
+	TestHelpers::TempDir tmp;
+	newsboat::ConfigContainer cfg;
+
+	Download dl([]() {});
+	dl.set_url("file://" + tmp.get_path() + "missing");
+	dl.set_filename(tmp.get_path() + "missing.mp3");
+	DownloadScheduler scheduler(&cfg);
+	scheduler.enqueue(&dl, DlPriority::NORMAL);
+
+	REQUIRE(wait_for([&]() {
+		return dl.status() == DlStatus::FAILED;
+	}));
+	REQUIRE(::access((dl.filename() + ".part").c_str(), F_OK) != 0);
+}
+
+TEST_CASE("DownloadScheduler completes downloads that are speed-limited",
+	"[DownloadScheduler]")
+{
+	TestHelpers::TempDir tmp;
+	LocalServer server(50 * 1024, true);
+	newsboat::ConfigContainer cfg;
+	cfg.set_configvalue("max-download-speed", "100");
+
+	Download first([]() {});
+	first.set_url(server.url("first"));
+	first.set_filename(tmp.get_path() + "first.mp3");
+	Download second([]() {});
+	second.set_url(server.url("second"));
+	second.set_filename(tmp.get_path() + "second.mp3");
+
+	DownloadScheduler scheduler(&cfg);
+	scheduler.set_max_parallel(2);
+
+	scheduler.enqueue(&first, DlPriority::NORMAL);
+	scheduler.enqueue(&second, DlPriority::NORMAL);
+
+	// How fast that happens is covered by the refill() test above; timing a
+	// real transfer would make this test flaky
+	REQUIRE(wait_for([&]() {
+		return first.status() == DlStatus::READY &&
+			second.status() == DlStatus::READY;
+	}));
+	REQUIRE(read_file(first.filename()).size() == 50 * 1024);
+	REQUIRE(read_file(second.filename()).size() == 50 * 1024);
+}
+
+TEST_CASE("DownloadScheduler starts high-priority downloads right away, and "
+	"cancels running ones when stopped",
+	"[DownloadScheduler]")
+{
+	TestHelpers::TempDir tmp;
+	// Never answers, so the downloads are still running when we stop
+	LocalServer server(0, false);
+	newsboat::ConfigContainer cfg;
+
+	std::vector<Download> downloads(3, Download([]() {}));
+	for (std::size_t i = 0; i < downloads.size(); i++) {
+		const auto name = std::to_string(i);
+		downloads[i].set_url(server.url(name));
+		downloads[i].set_filename(tmp.get_path() + name + ".mp3");
+	}
+
+	// Declared after the downloads, so that it's destroyed first
+	DownloadScheduler scheduler(&cfg);
+	scheduler.set_max_parallel(1);
+
+	scheduler.enqueue(&downloads[0], DlPriority::NORMAL);
+	REQUIRE(wait_for([&]() {
+		return downloads[0].status() == DlStatus::DOWNLOADING;
+	}));
+
+	scheduler.enqueue(&downloads[1], DlPriority::NORMAL);
+	scheduler.enqueue(&downloads[2], DlPriority::HIGH);
+	REQUIRE(wait_for([&]() {
+		return downloads[2].status() == DlStatus::DOWNLOADING;
+	}));
+	REQUIRE(downloads[1].status() == DlStatus::QUEUED);
+
+	scheduler.stop();
+	REQUIRE(downloads[0].status() == DlStatus::CANCELLED);
+	REQUIRE(downloads[1].status() == DlStatus::QUEUED);
+	REQUIRE(downloads[2].status() == DlStatus::CANCELLED);
+	// Partial downloads are kept, so they can be resumed
+	REQUIRE(::access((downloads[0].filename() + ".part").c_str(), F_OK) == 0);
+
+	SECTION("Queueing a download again starts the scheduler again") {
+		scheduler.enqueue(&downloads[1], DlPriority::NORMAL);
+		REQUIRE(wait_for([&]() {
+			return downloads[1].status() == DlStatus::DOWNLOADING;
+		}));
+	}
+
+	SECTION("A download deleted while it was queued can be queued again") {
+		scheduler.enqueue(&downloads[0], DlPriority::NORMAL);
+		scheduler.enqueue(&downloads[1], DlPriority::NORMAL);
+		REQUIRE(wait_for([&]() {
+			return downloads[0].status() == DlStatus::DOWNLOADING;
+		}));
+		REQUIRE(downloads[1].status() == DlStatus::QUEUED);
+
+		downloads[1].set_status(DlStatus::DELETED);
+		scheduler.enqueue(&downloads[1], DlPriority::NORMAL);
+		REQUIRE(downloads[1].status() == DlStatus::QUEUED);
+
+		// Make room for it
+		downloads[0].set_status(DlStatus::CANCELLED);
+		REQUIRE(wait_for([&]() {
+			return downloads[1].status() == DlStatus::DOWNLOADING;
+		}));
+	}
+
+	SECTION("A download can be queued again right after it was cancelled") {
+		scheduler.enqueue(&downloads[0], DlPriority::NORMAL);
+		REQUIRE(wait_for([&]() {
+			return downloads[0].status() == DlStatus::DOWNLOADING;
+		}));
+
+		// The transfer is most likely still running at this point
+		downloads[0].set_status(DlStatus::CANCELLED);
+		scheduler.enqueue(&downloads[0], DlPriority::NORMAL);
+		REQUIRE(wait_for([&]() {
+			return downloads[0].status() == DlStatus::DOWNLOADING;
+		}));
+	}
+
+	SECTION("A cancelled download can be resumed") {
+		downloads[0].set_url(make_source(tmp.get_path() + "source", 1000));
+		scheduler.enqueue(&downloads[0], DlPriority::NORMAL);
+
+		REQUIRE(wait_for([&]() {
+			return downloads[0].status() == DlStatus::READY;
+		}));
+		REQUIRE(read_file(downloads[0].filename()) == std::string(1000, 'x'));
+	}
+}
@@ -927,3 +927,44 @@ TEST_CASE("get_unread_item_count_per_tag returns the number of unread items "
 			== 24);
 	}
 }
+
+TEST_CASE("get_counts_per_tag returns counts for each of the given tags",
+	"[FeedContainer]")
+{
+	FeedContainer feedcontainer;
+
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+
+	const auto add_feed = [&](const std::vector<std::string>& tags,
+	unsigned int unread_items) {
+		auto feed = std::make_shared<RssFeed>(&rsscache);
+		feed->set_tags(tags);
+		for (unsigned int i = 0; i < unread_items; ++i) {
+			auto item = std::make_shared<RssItem>(&rsscache);
+			item->set_guid(std::to_string(i));
+			feed->add_item(item);
+		}
+		feedcontainer.add_feed(feed);
+	};
+
+	add_feed({"news", "daily"}, 3);
+	add_feed({"news"}, 0);
+	add_feed({"daily"}, 2);
+
+	const auto counts =
+		feedcontainer.get_counts_per_tag({"news", "daily", "unknown"});
+	REQUIRE(counts.size() == 3);
+
+	REQUIRE(counts[0].feed_count == 2);
+	REQUIRE(counts[0].unread_feed_count == 1);
+	REQUIRE(counts[0].unread_item_count == 3);
+
+	REQUIRE(counts[1].feed_count == 2);
+	REQUIRE(counts[1].unread_feed_count == 2);
+	REQUIRE(counts[1].unread_item_count == 5);
+
+	REQUIRE(counts[2].feed_count == 0);
+	REQUIRE(counts[2].unread_feed_count == 0);
+	REQUIRE(counts[2].unread_item_count == 0);
+}
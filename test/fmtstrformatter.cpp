@@ -1,5 +1,8 @@
 #include "fmtstrformatter.h"
 
+#include <string>
+#include <vector>
+
 #include "3rd-party/catch.hpp"
 
 using namespace newsboat;
@@ -393,3 +396,81 @@ TEST_CASE("Question mark is treated literally outside of conditionals",
 
 	REQUIRE(fmt.do_format("%x? %y") == "What's the ultimate answer? 42");
 }
+
+TEST_CASE("FmtStrTemplate knows which keys the format uses",
+	"[FmtStrTemplate]")
+{
+	FmtStrTemplate tmpl;
+	REQUIRE_FALSE(tmpl.uses('a'));
+
+	tmpl.set_format("%a %-4b %%c %>d %?e?%f&%g?");
+	for (const char key : std::string("abefg")) {
+		INFO("key: " << key);
+		REQUIRE(tmpl.uses(key));
+	}
+	for (const char key : std::string("cdh")) {
+		INFO("key: " << key);
+		REQUIRE_FALSE(tmpl.uses(key));
+	}
+
+	tmpl.set_format("%h");
+	REQUIRE_FALSE(tmpl.uses('a'));
+	REQUIRE(tmpl.uses('h'));
+}
+
+TEST_CASE("do_format with a template gives the same result as with a string",
+	"[FmtStrFormatter]")
+{
+	FmtStrFormatter fmt;
+	fmt.register_fmt('a', "AAA");
+	fmt.register_fmt('b', "BBB");
+
+	FmtStrTemplate tmpl;
+	std::string result = "left over from the previous line";
+
+	const std::vector<std::string> formats = {
+		"",
+		"<%a> <%5b> | %-5c%%",
+		"asdf | %a | %?c?%a%b&%b%a? | qwert",
+		"%a%> %b",
+	};
+	const std::vector<unsigned int> widths = {0, 5, 30};
+
+	for (const auto& format : formats) {
+		tmpl.set_format(format);
+		for (const auto width : widths) {
+			INFO("format: " << format << ", width: " << width);
+			fmt.do_format(tmpl, width, result);
+			REQUIRE(result == fmt.do_format(format, width));
+		}
+	}
+}
+
+TEST_CASE("Benchmark: formatting an article list line",
+	"[.][benchmark][FmtStrFormatter]")
+{
+	FmtStrFormatter fmt;
+	fmt.register_fmt('i', "42");
+	fmt.register_fmt('f', "N");
+	fmt.register_fmt('D', "Oct 19");
+	fmt.register_fmt('a', "Jane Doe");
+	fmt.register_fmt('L', "12KB");
+	fmt.register_fmt('t', "Fran\xC3\xA7ois's caf\xC3\xA9 gets an article title "
+		"of typical length");
+
+	BENCHMARK("register_fmt()") {
+		fmt.register_fmt('t', "An article title of typical length");
+	};
+
+	BENCHMARK("do_format(), default articlelist-format") {
+		return fmt.do_format("%4i %f %D %6L  %?T?|%-17T|  &?%t", 120);
+	};
+
+	FmtStrTemplate tmpl;
+	tmpl.set_format("%4i %f %D %6L  %?T?|%-17T|  &?%t");
+	std::string result;
+	BENCHMARK("do_format(), default articlelist-format as a template") {
+		fmt.do_format(tmpl, 120, result);
+		return result.size();
+	};
+}
@@ -231,6 +231,37 @@ TEST_CASE("links with different URLs have different numbers", "[HtmlRenderer]")
 	REQUIRE(links[1].second == LinkType::HREF);
 }
 
+TEST_CASE("links that were passed in keep their numbers", "[HtmlRenderer]")
+{
+	HtmlRenderer r;
+
+	const std::string input =
+		"<a href='http://example.com/two'>Two</a>"
+		"<a href='http://example.com/one'>One</a>";
+	std::vector<std::pair<LineType, std::string>> lines;
+	std::vector<LinkPair> links;
+	links.push_back(LinkPair("http://example.com/one", LinkType::AUDIO));
+
+	REQUIRE_NOTHROW(r.render(input, lines, links, url));
+	REQUIRE(links.size() == 2);
+	REQUIRE(links[0].first == "http://example.com/one");
+	REQUIRE(links[0].second == LinkType::AUDIO);
+	REQUIRE(links[1].first == "http://example.com/two");
+	REQUIRE(lines[0] == p(LineType::wrappable, "<u>Two</>[2]<u>One</>[1]"));
+
+	SECTION("renderer can be reused with another list of links") {
+		std::vector<std::pair<LineType, std::string>> other_lines;
+		std::vector<LinkPair> other_links;
+
+		REQUIRE_NOTHROW(r.render(input, other_lines, other_links, url));
+		REQUIRE(other_links.size() == 2);
+		REQUIRE(other_links[0].first == "http://example.com/two");
+		REQUIRE(other_links[1].first == "http://example.com/one");
+		REQUIRE(other_lines[0] ==
+			p(LineType::wrappable, "<u>Two</>[1]<u>One</>[2]"));
+	}
+}
+
 TEST_CASE("link without `href' is neither highlighted nor added to links list",
 	"[HtmlRenderer]")
 {
@@ -0,0 +1,206 @@
+#include "rss/httparchive.h"
+
+#include <fstream>
+
+#include "3rd-party/catch.hpp"
+#include "rss/exception.h"
+#include "rss/feed.h"
+#include "rss/parser.h"
+#include "test-helpers/tempfile.h"
+
+using namespace rsspp;
+
+namespace {
+
+HttpResponse make_response(const std::string& body)
+{
+	HttpResponse response;
+	response.curl_code = 0;
+	response.status = 200;
+	response.headers = "HTTP/1.1 200 OK\r\nETag: \"abc\"\r\n\r\n";
+	response.body = body;
+	response.elapsed = std::chrono::microseconds(1500);
+	return response;
+}
+
+} // namespace
+
+TEST_CASE("HttpArchive replays what was recorded", "[HttpArchive]")
+{
+	TestHelpers::TempFile archive;
+
+	HttpArchive::start_recording(archive.get_path());
+	REQUIRE(HttpArchive::is_recording());
+	// The body contains newlines and a fake record to check that it's stored
+	// verbatim
+	const auto first = make_response("<rss>\nrecord\nurl 3\n</rss>");
+	HttpArchive::record("https://example.com/feed.xml", first);
+	HttpResponse error;
+	error.curl_code = 22;
+	error.status = 404;
+	HttpArchive::record("https://example.com/missing.xml", error);
+	HttpArchive::stop();
+	REQUIRE_FALSE(HttpArchive::is_recording());
+
+	HttpArchive::start_replaying(archive.get_path(), false);
+	REQUIRE(HttpArchive::is_replaying());
+
+	const auto replayed = HttpArchive::replay("https://example.com/feed.xml");
+	REQUIRE(replayed.curl_code == first.curl_code);
+	REQUIRE(replayed.status == first.status);
+	REQUIRE(replayed.headers == first.headers);
+	REQUIRE(replayed.body == first.body);
+	REQUIRE(replayed.elapsed == first.elapsed);
+
+	const auto replayed_error =
+		HttpArchive::replay("https://example.com/missing.xml");
+	REQUIRE(replayed_error.curl_code == 22);
+	REQUIRE(replayed_error.status == 404);
+	REQUIRE(replayed_error.body.empty());
+
+	HttpArchive::stop();
+	REQUIRE_FALSE(HttpArchive::is_replaying());
+}
+
+TEST_CASE("HttpArchive serves responses for the same URL in order, "
+	"repeating the last one",
+	"[HttpArchive]")
+{
+	TestHelpers::TempFile archive;
+	const std::string url("https://example.com/feed.xml");
+
+	HttpArchive::start_recording(archive.get_path());
+	HttpArchive::record(url, make_response("first"));
+	HttpArchive::record(url, make_response("second"));
+	HttpArchive::stop();
+
+	HttpArchive::start_replaying(archive.get_path(), false);
+	REQUIRE(HttpArchive::replay(url).body == "first");
+	REQUIRE(HttpArchive::replay(url).body == "second");
+	REQUIRE(HttpArchive::replay(url).body == "second");
+	HttpArchive::stop();
+}
+
+TEST_CASE("HttpArchive::replay() throws if there is no response for the URL",
+	"[HttpArchive]")
+{
+	TestHelpers::TempFile archive;
+
+	HttpArchive::start_recording(archive.get_path());
+	HttpArchive::record("https://example.com/feed.xml", make_response(""));
+	HttpArchive::stop();
+
+	HttpArchive::start_replaying(archive.get_path(), false);
+	REQUIRE_THROWS_AS(HttpArchive::replay("https://example.com/other.xml"),
+		rsspp::Exception);
+	HttpArchive::stop();
+}
+
+TEST_CASE("HttpArchive::record() does nothing unless recording",
+	"[HttpArchive]")
+{
+	TestHelpers::TempFile archive;
+
+	HttpArchive::start_recording(archive.get_path());
+	HttpArchive::stop();
+	HttpArchive::record("https://example.com/feed.xml", make_response("x"));
+
+	HttpArchive::start_replaying(archive.get_path(), false);
+	REQUIRE_THROWS_AS(HttpArchive::replay("https://example.com/feed.xml"),
+		rsspp::Exception);
+	HttpArchive::stop();
+}
+
+TEST_CASE("HttpArchive::start_replaying() throws on a missing or malformed "
+	"archive",
+	"[HttpArchive]")
+{
+	TestHelpers::TempFile archive;
+
+	SECTION("Missing file") {
+		REQUIRE_THROWS_AS(
+			HttpArchive::start_replaying(archive.get_path(), false),
+			rsspp::Exception);
+	}
+
+	SECTION("Not an archive") {
+		std::ofstream out(archive.get_path());
+		out << "<rss></rss>\n";
+		out.close();
+
+		REQUIRE_THROWS_AS(
+			HttpArchive::start_replaying(archive.get_path(), false),
+			rsspp::Exception);
+	}
+
+	SECTION("Truncated record") {
+		std::ofstream out(archive.get_path());
+		out << "newsboat-http-archive 1\n"
+			<< "record\n"
+			<< "url 28\nhttps://example.com/feed.xml\n"
+			<< "curl-code 0\n"
+			<< "status 200\n"
+			<< "elapsed-us 10\n"
+			<< "headers 0\n\n"
+			<< "body 100\nshort\n";
+		out.close();
+
+		REQUIRE_THROWS_AS(
+			HttpArchive::start_replaying(archive.get_path(), false),
+			rsspp::Exception);
+	}
+
+	SECTION("Length that goes past the end of the file") {
+		std::ofstream out(archive.get_path());
+		out << "newsboat-http-archive 1\n"
+			<< "record\n"
+			<< "url 18446744073709551615\nhttps://example.com/feed.xml\n";
+		out.close();
+
+		REQUIRE_THROWS_AS(
+			HttpArchive::start_replaying(archive.get_path(), false),
+			rsspp::Exception);
+	}
+
+	REQUIRE_FALSE(HttpArchive::is_replaying());
+}
+
+TEST_CASE("Parser::parse_url() parses replayed responses instead of going "
+	"to the network",
+	"[HttpArchive]")
+{
+	TestHelpers::TempFile archive;
+	// Nothing listens there, so a real request would fail
+	const std::string url("http://127.0.0.1:9/feed.xml");
+
+	HttpArchive::start_recording(archive.get_path());
+	HttpResponse response = make_response(
+			"<?xml version=\"1.0\"?>"
+			"<rss version=\"2.0\"><channel><title>Replayed</title>"
+			"<item><title>First item</title><guid>1</guid></item>"
+			"</channel></rss>");
+	response.headers = "HTTP/1.1 200 OK\r\n"
+		"Last-Modified: Wed, 21 Oct 2015 07:28:00 GMT\r\n"
+		"ETag: \"abc\"\r\n\r\n";
+	HttpArchive::record(url, response);
+	HttpResponse error;
+	error.curl_code = 22; // CURLE_HTTP_RETURNED_ERROR
+	error.status = 404;
+	HttpArchive::record(url + "?missing", error);
+	HttpArchive::stop();
+
+	HttpArchive::start_replaying(archive.get_path(), false);
+
+	Parser p;
+	const Feed f = p.parse_url(url);
+	REQUIRE(f.rss_version == Feed::RSS_2_0);
+	REQUIRE(f.title == "Replayed");
+	REQUIRE(f.items.size() == 1);
+	REQUIRE(f.items[0].title == "First item");
+	REQUIRE(p.get_last_modified() == 1445412480);
+	REQUIRE(p.get_etag() == "\"abc\"");
+
+	REQUIRE_THROWS_AS(p.parse_url(url + "?missing"), rsspp::Exception);
+
+	HttpArchive::stop();
+}
@@ -0,0 +1,186 @@
+#include "itemrendercache.h"
+
+#include "3rd-party/catch.hpp"
+
+#include "cache.h"
+#include "configcontainer.h"
+#include "itemrenderer.h"
+#include "regexmanager.h"
+#include "rssfeed.h"
+#include "rssitem.h"
+
+using namespace newsboat;
+
+static std::shared_ptr<RssItem> create_item(Cache* c,
+	std::shared_ptr<RssFeed> feed,
+	const std::string& guid)
+{
+	auto item = std::make_shared<RssItem>(c);
+	item->set_feedptr(feed);
+	item->set_guid(guid);
+	item->set_title("Item " + guid);
+	item->set_link("https://example.com/" + guid);
+	item->set_description("<p>Hello, <a href='https://example.com/'>world</a>!</p>");
+	return item;
+}
+
+TEST_CASE("ItemRenderCache::get_stfl_list() returns the same result as "
+	"item_renderer::to_stfl_list()",
+	"[ItemRenderCache]")
+{
+	ConfigContainer cfg;
+	RegexManager rxman;
+	Cache rsscache(":memory:", &cfg);
+	auto feed = std::make_shared<RssFeed>(&rsscache);
+	const auto item = create_item(&rsscache, feed, "1");
+
+	std::vector<LinkPair> expected_links;
+	const auto expected = item_renderer::to_stfl_list(cfg, item, 80, 80,
+			&rxman, "article", expected_links);
+
+	ItemRenderCache render_cache(4);
+
+	SECTION("when the result isn't cached yet") {
+		std::vector<LinkPair> links;
+		const auto result = render_cache.get_stfl_list(cfg, item, 80, 80,
+				rxman, "article", links);
+		REQUIRE(result == expected);
+		REQUIRE(links == expected_links);
+	}
+
+	SECTION("when the result is cached") {
+		std::vector<LinkPair> links;
+		render_cache.get_stfl_list(cfg, item, 80, 80, rxman, "article", links);
+		REQUIRE(render_cache.contains(cfg, item, 80, 80, rxman, "article", {}));
+
+		links.clear();
+		const auto result = render_cache.get_stfl_list(cfg, item, 80, 80,
+				rxman, "article", links);
+		REQUIRE(result == expected);
+		REQUIRE(links == expected_links);
+	}
+
+	SECTION("links passed in are rendered first, and the article's follow") {
+		std::vector<LinkPair> initial_links;
+		initial_links.push_back(LinkPair("https://example.com/podcast.mp3",
+				LinkType::AUDIO));
+
+		expected_links = initial_links;
+		const auto expected_with_enclosure = item_renderer::to_stfl_list(cfg,
+				item, 80, 80, &rxman, "article", expected_links);
+		REQUIRE(expected_links.size() > 1);
+
+		std::vector<LinkPair> links = initial_links;
+		auto result = render_cache.get_stfl_list(cfg, item, 80, 80, rxman,
+				"article", links);
+		REQUIRE(result == expected_with_enclosure);
+		REQUIRE(links == expected_links);
+
+		// Cached separately from the rendering without the enclosure
+		REQUIRE(render_cache.contains(cfg, item, 80, 80, rxman, "article",
+				initial_links));
+		REQUIRE_FALSE(render_cache.contains(cfg, item, 80, 80, rxman,
+				"article", {}));
+
+		links = initial_links;
+		result = render_cache.get_stfl_list(cfg, item, 80, 80, rxman,
+				"article", links);
+		REQUIRE(result == expected_with_enclosure);
+		REQUIRE(links == expected_links);
+	}
+}
+
+TEST_CASE("ItemRenderCache doesn't return results that might be outdated",
+	"[ItemRenderCache]")
+{
+	ConfigContainer cfg;
+	RegexManager rxman;
+	Cache rsscache(":memory:", &cfg);
+	auto feed = std::make_shared<RssFeed>(&rsscache);
+	const auto item = create_item(&rsscache, feed, "1");
+
+	ItemRenderCache render_cache(4);
+	std::vector<LinkPair> links;
+	render_cache.get_stfl_list(cfg, item, 80, 80, rxman, "article", links);
+	REQUIRE(render_cache.contains(cfg, item, 80, 80, rxman, "article", {}));
+
+	SECTION("article's contents changed") {
+		item->set_description("<p>Something else entirely</p>");
+		REQUIRE_FALSE(render_cache.contains(cfg, item, 80, 80, rxman,
+				"article", {}));
+
+		links.clear();
+		const auto result = render_cache.get_stfl_list(cfg, item, 80, 80,
+				rxman, "article", links);
+		REQUIRE(result.first.find("Something else entirely") !=
+			std::string::npos);
+	}
+
+	SECTION("article's header changed") {
+		item->set_flags("s");
+		REQUIRE_FALSE(render_cache.contains(cfg, item, 80, 80, rxman,
+				"article", {}));
+	}
+
+	SECTION("widths changed") {
+		REQUIRE_FALSE(render_cache.contains(cfg, item, 40, 80, rxman,
+				"article", {}));
+		REQUIRE_FALSE(render_cache.contains(cfg, item, 80, 40, rxman,
+				"article", {}));
+	}
+
+	SECTION("html-renderer changed") {
+		cfg.set_configvalue("html-renderer", "w3m -dump -T text/html");
+		REQUIRE_FALSE(render_cache.contains(cfg, item, 80, 80, rxman,
+				"article", {}));
+	}
+
+	SECTION("highlighting rules changed") {
+		rxman.handle_action("highlight", {"article", "Hello", "red"});
+		REQUIRE_FALSE(render_cache.contains(cfg, item, 80, 80, rxman,
+				"article", {}));
+
+		links.clear();
+		const auto result = render_cache.get_stfl_list(cfg, item, 80, 80,
+				rxman, "article", links);
+		REQUIRE(result.first.find("<0>Hello</>") != std::string::npos);
+
+		rxman.remove_last_regex("article");
+		REQUIRE_FALSE(render_cache.contains(cfg, item, 80, 80, rxman,
+				"article", {}));
+	}
+
+	SECTION("cache was cleared") {
+		render_cache.clear();
+		REQUIRE_FALSE(render_cache.contains(cfg, item, 80, 80, rxman,
+				"article", {}));
+	}
+}
+
+TEST_CASE("ItemRenderCache evicts least recently used articles when full",
+	"[ItemRenderCache]")
+{
+	ConfigContainer cfg;
+	RegexManager rxman;
+	Cache rsscache(":memory:", &cfg);
+	auto feed = std::make_shared<RssFeed>(&rsscache);
+	const auto item1 = create_item(&rsscache, feed, "1");
+	const auto item2 = create_item(&rsscache, feed, "2");
+	const auto item3 = create_item(&rsscache, feed, "3");
+
+	ItemRenderCache render_cache(2);
+	const auto render = [&](std::shared_ptr<RssItem> item) {
+		std::vector<LinkPair> links;
+		render_cache.get_stfl_list(cfg, item, 80, 80, rxman, "article", links);
+	};
+	render(item1);
+	render(item2);
+	// Makes item1 the most recently used one
+	render(item1);
+	render(item3);
+
+	REQUIRE(render_cache.contains(cfg, item1, 80, 80, rxman, "article", {}));
+	REQUIRE_FALSE(render_cache.contains(cfg, item2, 80, 80, rxman, "article",
+			{}));
+	REQUIRE(render_cache.contains(cfg, item3, 80, 80, rxman, "article", {}));
+}
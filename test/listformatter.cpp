@@ -74,6 +74,20 @@ TEST_CASE("add_line() splits overly long sequences to fit width",
 	}
 }
 
+TEST_CASE("add_line() doesn't count STFL tags towards the width",
+	"[ListFormatter]")
+{
+	ListFormatter fmt;
+
+	fmt.add_line("<0>abcdefghijkl", "", 10);
+	std::string expected =
+		"{list"
+		"{listitem text:\"<0>abcdefghij\"}"
+		"{listitem text:\"kl\"}"
+		"}";
+	REQUIRE(fmt.format_list() == expected);
+}
+
 TEST_CASE("set_line() replaces the item in a list", "[ListFormatter]")
 {
 	ListFormatter fmt;
@@ -120,3 +134,45 @@ TEST_CASE("format_list() uses regex manager if one is passed",
 
 	REQUIRE(fmt.format_list() == expected);
 }
+
+TEST_CASE("add_placeholder() adds an empty line that set_line() fills in",
+	"[ListFormatter]")
+{
+	ListFormatter fmt;
+
+	fmt.add_line("first", "1");
+	fmt.add_placeholder("2");
+	fmt.add_placeholder("3");
+
+	REQUIRE(fmt.get_lines_count() == 3);
+	REQUIRE_FALSE(fmt.is_placeholder(0));
+	REQUIRE(fmt.is_placeholder(1));
+	REQUIRE(fmt.is_placeholder(2));
+	REQUIRE_FALSE(fmt.is_placeholder(3));
+
+	std::string expected =
+		"{list"
+		"{listitem[1] text:\"first\"}"
+		"{listitem[2] text:\"\"}"
+		"{listitem[3] text:\"\"}"
+		"}";
+	REQUIRE(fmt.format_list() == expected);
+
+	fmt.set_line(2, "third", "3");
+	REQUIRE(fmt.is_placeholder(1));
+	REQUIRE_FALSE(fmt.is_placeholder(2));
+
+	expected =
+		"{list"
+		"{listitem[1] text:\"first\"}"
+		"{listitem[2] text:\"\"}"
+		"{listitem[3] text:\"third\"}"
+		"}";
+	REQUIRE(fmt.format_list() == expected);
+
+	SECTION("clear() removes placeholders too") {
+		fmt.clear();
+		REQUIRE(fmt.get_lines_count() == 0);
+		REQUIRE_FALSE(fmt.is_placeholder(1));
+	}
+}
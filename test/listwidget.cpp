@@ -0,0 +1,59 @@
+#include "listwidget.h"
+
+#include <cstdint>
+#include <utility>
+
+#include "3rd-party/catch.hpp"
+
+using namespace newsboat;
+
+using Range = std::pair<std::uint32_t, std::uint32_t>;
+
+TEST_CASE("visible_range() of an empty list is empty", "[ListWidget]")
+{
+	REQUIRE(ListWidget::visible_range(0, 0, 10, 5) == Range(0, 0));
+	REQUIRE(ListWidget::visible_range(0, 0, 10, 0) == Range(0, 0));
+}
+
+TEST_CASE("visible_range() covers the list's height plus the margin on both "
+	"sides of the selected line",
+	"[ListWidget]")
+{
+	SECTION("Scrolled to the top") {
+		REQUIRE(ListWidget::visible_range(100, 0, 10, 5) == Range(0, 16));
+	}
+
+	SECTION("Scrolled to the middle") {
+		REQUIRE(ListWidget::visible_range(100, 50, 10, 5) == Range(35, 66));
+	}
+
+	SECTION("Scrolled to the bottom") {
+		REQUIRE(ListWidget::visible_range(100, 99, 10, 5) == Range(84, 100));
+	}
+
+	SECTION("Without a margin") {
+		REQUIRE(ListWidget::visible_range(100, 50, 10, 0) == Range(40, 61));
+	}
+}
+
+TEST_CASE("visible_range() of a list shorter than the viewport is the whole "
+	"list",
+	"[ListWidget]")
+{
+	REQUIRE(ListWidget::visible_range(5, 0, 10, 5) == Range(0, 5));
+	REQUIRE(ListWidget::visible_range(5, 2, 10, 5) == Range(0, 5));
+	REQUIRE(ListWidget::visible_range(5, 4, 10, 0) == Range(0, 5));
+}
+
+TEST_CASE("visible_range() treats a position past the end as the last line",
+	"[ListWidget]")
+{
+	REQUIRE(ListWidget::visible_range(10, 50, 5, 0) == Range(4, 10));
+}
+
+TEST_CASE("visible_range() is the whole list if the height isn't known yet",
+	"[ListWidget]")
+{
+	REQUIRE(ListWidget::visible_range(100, 50, 0, 5) == Range(0, 100));
+	REQUIRE(ListWidget::visible_range(0, 0, 0, 5) == Range(0, 0));
+}
@@ -503,6 +503,37 @@ TEST_CASE("RegexManager::remove_last_regex removes last added `highlight` rule",
 	REQUIRE(input == INPUT);
 }
 
+TEST_CASE("RegexManager::quote_and_highlight returns the same result for "
+	"repeated lines until the rules change",
+	"[RegexManager]")
+{
+	RegexManager rxman;
+
+	rxman.handle_action("highlight", {"articlelist", "foo", "blue", "red"});
+
+	const auto INPUT = std::string("xfoobarx");
+
+	auto input = INPUT;
+	rxman.quote_and_highlight(input, "articlelist");
+	REQUIRE(input == "x<0>foo</>barx");
+
+	input = INPUT;
+	rxman.quote_and_highlight(input, "articlelist");
+	REQUIRE(input == "x<0>foo</>barx");
+
+	rxman.handle_action("highlight", {"articlelist", "bar", "blue", "red"});
+
+	input = INPUT;
+	rxman.quote_and_highlight(input, "articlelist");
+	REQUIRE(input == "x<0>foo<1>bar</>x");
+
+	rxman.remove_last_regex("articlelist");
+
+	input = INPUT;
+	rxman.quote_and_highlight(input, "articlelist");
+	REQUIRE(input == "x<0>foo</>barx");
+}
+
 TEST_CASE("RegexManager::remove_last_regex does not crash if there are "
 	"no regexes to remove",
 	"[RegexManager]")
@@ -50,6 +50,23 @@ public:
 	{
 		throw 0;
 	}
+	bool prefetch_feeds(const std::string& /* since */)
+	{
+		rsspp::Item item;
+		item.guid = "101";
+		store_prefetched({{"1", {item}}}, "101");
+		return true;
+	}
+	bool fetch(const std::string& feed_id,
+		std::vector<rsspp::Item>& items,
+		std::string& sync_token)
+	{
+		return take_prefetched(feed_id, items, sync_token);
+	}
+	void fetch_on_its_own(std::string& sync_token)
+	{
+		skip_prefetched(sync_token);
+	}
 };
 
 TEST_CASE("get_credentials() returns the users name and password",
@@ -118,3 +135,52 @@ TEST_CASE("eval_password() returns the first line of command's output",
 	// following test will wait for user input and block tests
 	// REQUIRE(RemoteApi->eval_password("read password") == "");
 }
+
+TEST_CASE("Articles fetched by prefetch_feeds() are handed out per feed",
+	"[RemoteApi]")
+{
+	ConfigContainer cfg;
+	test_api api(&cfg);
+	std::vector<rsspp::Item> items;
+	std::string sync_token = "50";
+
+	SECTION("Nothing is handed out before a prefetch") {
+		REQUIRE_FALSE(api.fetch("1", items, sync_token));
+		api.fetch_on_its_own(sync_token);
+		REQUIRE(sync_token == "50");
+	}
+
+	SECTION("After a prefetch") {
+		REQUIRE(api.prefetch_feeds("50"));
+
+		SECTION("feeds get their articles, and sync tokens advance") {
+			REQUIRE(api.fetch("1", items, sync_token));
+			REQUIRE(items.size() == 1);
+			REQUIRE(items[0].guid == "101");
+			REQUIRE(sync_token == "101");
+		}
+
+		SECTION("feeds without new articles get none") {
+			items.resize(3);
+			REQUIRE(api.fetch("2", items, sync_token));
+			REQUIRE(items.empty());
+			REQUIRE(sync_token == "101");
+		}
+
+		SECTION("sync tokens never go back") {
+			sync_token = "200";
+			REQUIRE(api.fetch("1", items, sync_token));
+			REQUIRE(sync_token == "200");
+		}
+
+		SECTION("feeds fetched on their own still advance their token") {
+			api.fetch_on_its_own(sync_token);
+			REQUIRE(sync_token == "101");
+		}
+
+		SECTION("drop_prefetched() forgets everything") {
+			api.drop_prefetched();
+			REQUIRE_FALSE(api.fetch("1", items, sync_token));
+		}
+	}
+}
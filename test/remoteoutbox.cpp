@@ -0,0 +1,314 @@
+#include "remoteoutbox.h"
+
+#include <functional>
+#include <stdexcept>
+
+#include "3rd-party/catch.hpp"
+#include "cache.h"
+#include "configcontainer.h"
+#include "remoteapi.h"
+#include "rssfeed.h"
+#include "rssitem.h"
+#include "test-helpers/tempfile.h"
+
+using namespace newsboat;
+
+/*
+ * Mock class that remembers the requests it received, and fails them on
+ * demand.
+ */
+class RecordingApi : public RemoteApi {
+public:
+	explicit RecordingApi(ConfigContainer* c)
+		: RemoteApi(c)
+	{
+	}
+	bool authenticate() override
+	{
+		return true;
+	}
+	std::vector<TaggedFeedUrl> get_subscribed_urls() override
+	{
+		return {};
+	}
+	void add_custom_headers(curl_slist** /* custom_headers */) override {}
+	bool mark_all_read(const std::string& feedurl) override
+	{
+		feeds_marked_read.push_back(feedurl);
+		return true;
+	}
+	bool mark_article_read(const std::string& guid, bool read) override
+	{
+		return mark_articles_read({guid}, read);
+	}
+	bool mark_articles_read(const std::vector<std::string>& guids,
+		bool read) override
+	{
+		if (throw_exceptions) {
+			throw std::runtime_error("network is down");
+		}
+		(read ? read_batches : unread_batches).push_back(guids);
+		return succeed;
+	}
+	bool update_article_flags(const std::string& oldflags,
+		const std::string& newflags,
+		const std::string& guid) override
+	{
+		flag_updates.push_back(guid + ":" + oldflags + "->" + newflags);
+		if (during_request) {
+			const auto callback = during_request;
+			during_request = nullptr;
+			callback();
+		}
+		return succeed;
+	}
+
+	bool succeed = true;
+	bool throw_exceptions = false;
+	std::vector<std::vector<std::string>> read_batches;
+	std::vector<std::vector<std::string>> unread_batches;
+	std::vector<std::string> flag_updates;
+	std::vector<std::string> feeds_marked_read;
+	/// Called once, while the next flags change is being sent
+	std::function<void()> during_request;
+};
+
+TEST_CASE("RemoteOutbox::flush() sends queued read state changes in batches",
+	"[RemoteOutbox]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	RecordingApi api(&cfg);
+	RemoteOutbox outbox(&rsscache, &api, "ttrss");
+
+	for (unsigned int i = 0; i < RemoteOutbox::MAX_BATCH_SIZE + 10; i++) {
+		outbox.mark_article_read(std::to_string(i), true);
+	}
+	outbox.mark_article_read("unread1", false);
+	outbox.mark_article_read("unread2", false);
+
+	REQUIRE(outbox.flush(1000));
+
+	REQUIRE(api.read_batches.size() == 2);
+	REQUIRE(api.read_batches[0].size() == RemoteOutbox::MAX_BATCH_SIZE);
+	REQUIRE(api.read_batches[0].front() == "0");
+	REQUIRE(api.read_batches[1].size() == 10);
+	REQUIRE(api.unread_batches.size() == 1);
+	REQUIRE(api.unread_batches[0] == std::vector<std::string>({"unread1", "unread2"}));
+
+	SECTION("sent changes are removed from the queue") {
+		api.read_batches.clear();
+		api.unread_batches.clear();
+
+		REQUIRE(outbox.flush(1000));
+		REQUIRE(api.read_batches.empty());
+		REQUIRE(api.unread_batches.empty());
+		REQUIRE_FALSE(rsscache.outbox_next_due("ttrss").has_value());
+	}
+}
+
+TEST_CASE("RemoteOutbox only sends the latest read state of an article",
+	"[RemoteOutbox]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	RecordingApi api(&cfg);
+	RemoteOutbox outbox(&rsscache, &api, "ttrss");
+
+	outbox.mark_article_read("1", true);
+	outbox.mark_article_read("1", false);
+	outbox.mark_article_read("1", true);
+	REQUIRE(outbox.flush(1000));
+
+	REQUIRE(api.read_batches == std::vector<std::vector<std::string>>({{"1"}}));
+	REQUIRE(api.unread_batches.empty());
+}
+
+TEST_CASE("RemoteOutbox::mark_all_read() drops the read state changes queued "
+	"for the feed's articles",
+	"[RemoteOutbox]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	RecordingApi api(&cfg);
+	RemoteOutbox outbox(&rsscache, &api, "ttrss");
+
+	for (const std::string feedurl : {"feed-a", "feed-b"}) {
+		auto feed = std::make_shared<RssFeed>(&rsscache);
+		feed->set_rssurl(feedurl);
+		auto item = std::make_shared<RssItem>(&rsscache);
+		item->set_guid(feedurl + "-item");
+		feed->add_item(item);
+		rsscache.externalize_rssfeed(feed, false);
+	}
+
+	outbox.mark_article_read("feed-a-item", false);
+	outbox.mark_article_read("feed-b-item", false);
+	outbox.update_article_flags("", "s", "feed-a-item");
+	REQUIRE(outbox.mark_all_read("feed-a"));
+	REQUIRE(api.feeds_marked_read == std::vector<std::string>({"feed-a"}));
+
+	REQUIRE(outbox.flush(1000));
+	REQUIRE(api.unread_batches ==
+		std::vector<std::vector<std::string>>({{"feed-b-item"}}));
+	REQUIRE(api.flag_updates ==
+		std::vector<std::string>({"feed-a-item:->s"}));
+}
+
+TEST_CASE("RemoteOutbox merges consecutive flag changes of an article",
+	"[RemoteOutbox]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	RecordingApi api(&cfg);
+	RemoteOutbox outbox(&rsscache, &api, "oldreader");
+
+	SECTION("changes are combined") {
+		outbox.update_article_flags("", "s", "1");
+		outbox.update_article_flags("s", "sp", "1");
+		REQUIRE(outbox.flush(1000));
+
+		REQUIRE(api.flag_updates == std::vector<std::string>({"1:->sp"}));
+	}
+
+	SECTION("changes that cancel out aren't sent at all") {
+		outbox.update_article_flags("", "s", "1");
+		outbox.update_article_flags("s", "", "1");
+		REQUIRE(outbox.flush(1000));
+
+		REQUIRE(api.flag_updates.empty());
+	}
+
+	SECTION("a change made while the previous one is being sent isn't "
+		"lost") {
+		outbox.update_article_flags("", "s", "1");
+		api.during_request = [&]() {
+			outbox.update_article_flags("s", "", "1");
+		};
+		REQUIRE(outbox.flush(1000));
+		REQUIRE(api.flag_updates == std::vector<std::string>({"1:->s"}));
+
+		REQUIRE(outbox.flush(1000));
+		REQUIRE(api.flag_updates ==
+			std::vector<std::string>({"1:->s", "1:s->"}));
+	}
+
+	SECTION("a change made while the previous one waits for a retry waits "
+		"as well") {
+		api.succeed = false;
+		outbox.update_article_flags("", "s", "1");
+		REQUIRE_FALSE(outbox.flush(1000));
+
+		api.succeed = true;
+		api.flag_updates.clear();
+		outbox.update_article_flags("s", "sp", "1");
+		REQUIRE(outbox.flush(1000));
+		REQUIRE(api.flag_updates.empty());
+
+		REQUIRE(outbox.flush(1000000));
+		REQUIRE(api.flag_updates == std::vector<std::string>({"1:->sp"}));
+	}
+}
+
+TEST_CASE("RemoteOutbox retries failed changes with a growing delay",
+	"[RemoteOutbox]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	RecordingApi api(&cfg);
+	RemoteOutbox outbox(&rsscache, &api, "ttrss");
+
+	outbox.mark_article_read("1", true);
+
+	SECTION("when the server rejects the change") {
+		api.succeed = false;
+	}
+
+	SECTION("when the request throws") {
+		api.throw_exceptions = true;
+	}
+
+	REQUIRE_FALSE(outbox.flush(1000));
+
+	const auto first_delay = RemoteOutbox::backoff(0).count();
+	REQUIRE(rsscache.outbox_next_due("ttrss") == 1000 + first_delay);
+
+	// Not due yet
+	api.read_batches.clear();
+	REQUIRE(outbox.flush(1000 + first_delay - 1));
+	REQUIRE(api.read_batches.empty());
+
+	REQUIRE_FALSE(outbox.flush(1000 + first_delay));
+	REQUIRE(rsscache.outbox_next_due("ttrss") ==
+		1000 + first_delay + RemoteOutbox::backoff(1).count());
+
+	api.succeed = true;
+	api.throw_exceptions = false;
+	api.read_batches.clear();
+	REQUIRE(outbox.flush(1000000));
+	REQUIRE(api.read_batches == std::vector<std::vector<std::string>>({{"1"}}));
+	REQUIRE_FALSE(rsscache.outbox_next_due("ttrss").has_value());
+}
+
+TEST_CASE("RemoteOutbox::backoff() doubles up to an hour", "[RemoteOutbox]")
+{
+	REQUIRE(RemoteOutbox::backoff(0) == std::chrono::seconds(30));
+	REQUIRE(RemoteOutbox::backoff(1) == std::chrono::seconds(60));
+	REQUIRE(RemoteOutbox::backoff(2) == std::chrono::seconds(120));
+	REQUIRE(RemoteOutbox::backoff(10) == std::chrono::seconds(3600));
+	REQUIRE(RemoteOutbox::backoff(1000) == std::chrono::seconds(3600));
+}
+
+TEST_CASE("RemoteOutbox keeps changes across restarts", "[RemoteOutbox]")
+{
+	TestHelpers::TempFile dbfile;
+	ConfigContainer cfg;
+	RecordingApi api(&cfg);
+
+	{
+		Cache rsscache(dbfile.get_path(), &cfg);
+		RemoteOutbox outbox(&rsscache, &api, "ttrss");
+		outbox.mark_article_read("1", true);
+		outbox.update_article_flags("", "s", "2");
+	}
+
+	Cache rsscache(dbfile.get_path(), &cfg);
+	RemoteOutbox outbox(&rsscache, &api, "ttrss");
+	REQUIRE(outbox.flush(1000));
+	REQUIRE(api.read_batches == std::vector<std::vector<std::string>>({{"1"}}));
+	REQUIRE(api.flag_updates == std::vector<std::string>({"2:->s"}));
+}
+
+TEST_CASE("RemoteOutbox ignores changes queued for other backends",
+	"[RemoteOutbox]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	RecordingApi api(&cfg);
+
+	RemoteOutbox ttrss_outbox(&rsscache, &api, "ttrss");
+	ttrss_outbox.mark_article_read("1", true);
+
+	RemoteOutbox newsblur_outbox(&rsscache, &api, "newsblur");
+	REQUIRE(newsblur_outbox.flush(1000));
+	REQUIRE(api.read_batches.empty());
+
+	REQUIRE(ttrss_outbox.flush(1000));
+	REQUIRE(api.read_batches.size() == 1);
+}
+
+TEST_CASE("RemoteOutbox's background thread sends changes when stopped",
+	"[RemoteOutbox]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	RecordingApi api(&cfg);
+	RemoteOutbox outbox(&rsscache, &api, "ttrss");
+
+	outbox.start();
+	outbox.mark_article_read("1", true);
+	outbox.stop();
+
+	REQUIRE(api.read_batches == std::vector<std::vector<std::string>>({{"1"}}));
+	REQUIRE_FALSE(rsscache.outbox_next_due("ttrss").has_value());
+}
@@ -0,0 +1,174 @@
+#include "remotesubscriptions.h"
+
+#include <memory>
+
+#include "3rd-party/catch.hpp"
+#include "cache.h"
+#include "configcontainer.h"
+#include "remoteapi.h"
+
+using namespace newsboat;
+
+/*
+ * Mock class that serves a fixed list of subscriptions and counts the
+ * requests it received.
+ */
+class SubscriptionsApi : public RemoteApi {
+public:
+	explicit SubscriptionsApi(ConfigContainer* c)
+		: RemoteApi(c)
+	{
+	}
+	bool authenticate() override
+	{
+		authentications++;
+		return can_authenticate;
+	}
+	std::vector<TaggedFeedUrl> get_subscribed_urls() override
+	{
+		requests++;
+		return urls;
+	}
+	void add_custom_headers(curl_slist** /* custom_headers */) override {}
+	bool mark_all_read(const std::string& /* feedurl */) override
+	{
+		return true;
+	}
+	bool mark_article_read(const std::string& /* guid */,
+		bool /* read */) override
+	{
+		return true;
+	}
+	bool update_article_flags(const std::string& /* oldflags */,
+		const std::string& /* newflags */,
+		const std::string& /* guid */) override
+	{
+		return true;
+	}
+	bool supports_cached_subscriptions() override
+	{
+		return true;
+	}
+
+	bool can_authenticate = true;
+	unsigned int authentications = 0;
+	unsigned int requests = 0;
+	std::vector<TaggedFeedUrl> urls;
+};
+
+TEST_CASE("RemoteSubscriptions::revalidate() saves the subscriptions and "
+	"hands them to the API",
+	"[RemoteSubscriptions]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	SubscriptionsApi api(&cfg);
+	api.urls = {{"https://example.com/feed.xml", {"news"}}};
+
+	RemoteSubscriptions subscriptions(&rsscache, &api, "ttrss");
+	REQUIRE_FALSE(subscriptions.use_cached());
+	REQUIRE(subscriptions.revalidate());
+	REQUIRE(api.requests == 1);
+
+	REQUIRE(rsscache.get_remote_subscriptions("ttrss") == api.urls);
+
+	// The URL reader doesn't have to ask the server again
+	REQUIRE(api.get_subscriptions() == api.urls);
+	REQUIRE(api.requests == 1);
+}
+
+TEST_CASE("RemoteSubscriptions::revalidate() fails if authentication fails",
+	"[RemoteSubscriptions]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	SubscriptionsApi api(&cfg);
+	api.can_authenticate = false;
+
+	RemoteSubscriptions subscriptions(&rsscache, &api, "ttrss");
+	REQUIRE_FALSE(subscriptions.revalidate());
+	REQUIRE(api.requests == 0);
+}
+
+TEST_CASE("RemoteSubscriptions starts with the cached subscriptions and "
+	"checks them in the background",
+	"[RemoteSubscriptions]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	SubscriptionsApi api(&cfg);
+
+	const std::vector<TaggedFeedUrl> cached = {
+		{"https://example.com/a.xml", {}},
+		{"https://example.com/b.xml", {"news"}},
+	};
+	rsscache.set_remote_subscriptions("ttrss", cached);
+
+	std::unique_ptr<RemoteSubscriptions> subscriptions(
+		new RemoteSubscriptions(&rsscache, &api, "ttrss"));
+	REQUIRE(subscriptions->use_cached());
+	REQUIRE(api.get_subscriptions() == cached);
+	REQUIRE(api.authentications == 0);
+	REQUIRE(api.requests == 0);
+
+	bool then_called = false;
+
+	SECTION("Nothing changed on the server") {
+		api.urls = cached;
+
+		subscriptions->start_revalidation([&]() {
+			then_called = true;
+		});
+		subscriptions->wait_for_revalidation();
+
+		REQUIRE(api.requests == 1);
+		REQUIRE_FALSE(subscriptions->subscriptions_changed());
+		REQUIRE_FALSE(subscriptions->authentication_failed());
+	}
+
+	SECTION("A feed was added on the server") {
+		api.urls = cached;
+		api.urls.push_back({"https://example.com/c.xml", {}});
+
+		subscriptions->start_revalidation([&]() {
+			then_called = true;
+		});
+		subscriptions->wait_for_revalidation();
+
+		REQUIRE(subscriptions->subscriptions_changed());
+		REQUIRE_FALSE(subscriptions->subscriptions_changed());
+		REQUIRE(rsscache.get_remote_subscriptions("ttrss") == api.urls);
+
+		const auto requests = api.requests;
+		REQUIRE(api.get_subscriptions() == api.urls);
+		REQUIRE(api.requests == requests);
+	}
+
+	SECTION("The server returned no subscriptions") {
+		subscriptions->start_revalidation([&]() {
+			then_called = true;
+		});
+		subscriptions->wait_for_revalidation();
+
+		REQUIRE_FALSE(subscriptions->subscriptions_changed());
+		REQUIRE(rsscache.get_remote_subscriptions("ttrss") == cached);
+	}
+
+	SECTION("Authentication failed") {
+		api.can_authenticate = false;
+
+		subscriptions->start_revalidation([&]() {
+			then_called = true;
+		});
+		subscriptions->wait_for_revalidation();
+
+		REQUIRE(api.requests == 0);
+		REQUIRE_FALSE(subscriptions->subscriptions_changed());
+		REQUIRE(subscriptions->authentication_failed());
+		REQUIRE_FALSE(subscriptions->authentication_failed());
+	}
+
+	// The destructor waits for the thread, so `then` must have run by now
+	subscriptions.reset();
+	REQUIRE(then_called);
+}
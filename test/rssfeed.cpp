@@ -1,5 +1,8 @@
 #include "rssfeed.h"
 
+#include <atomic>
+#include <thread>
+
 #include "3rd-party/catch.hpp"
 #include "cache.h"
 #include "configcontainer.h"
@@ -238,6 +241,162 @@ TEST_CASE("RssFeed::unread_item_count() returns number of unread articles",
 	REQUIRE(f.unread_item_count() == 0);
 }
 
+TEST_CASE("RssFeed::unread_item_count() accounts for added and removed "
+	"articles",
+	"[RssFeed]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	RssFeed f(&rsscache);
+	for (int i = 0; i < 5; ++i) {
+		const auto item = std::make_shared<RssItem>(&rsscache);
+		item->set_guid(std::to_string(i));
+		item->set_unread_nowrite(i % 2 == 0);
+		f.add_item(item);
+	}
+
+	REQUIRE(f.unread_item_count() == 3);
+
+	f.erase_item(f.items().begin());
+	REQUIRE(f.unread_item_count() == 2);
+
+	f.erase_items(f.items().begin(), f.items().begin() + 2);
+	REQUIRE(f.unread_item_count() == 1);
+
+	f.get_item_by_guid("4")->set_deleted(true);
+	f.purge_deleted_items();
+	REQUIRE(f.total_item_count() == 1);
+	REQUIRE(f.unread_item_count() == 0);
+
+	f.clear_items();
+	REQUIRE(f.unread_item_count() == 0);
+}
+
+TEST_CASE("RssFeed::unread_item_count() can be called while another thread "
+	"adds and removes articles",
+	"[RssFeed]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	RssFeed f(&rsscache);
+
+	std::atomic<bool> done(false);
+	std::thread reader([&]() {
+		while (!done) {
+			// Only has to not crash or race; the count is checked below
+			f.unread_item_count();
+		}
+	});
+
+	for (int i = 0; i < 1000; ++i) {
+		std::lock_guard<std::mutex> lock(f.item_mutex);
+		const auto item = std::make_shared<RssItem>(&rsscache);
+		item->set_guid(std::to_string(i));
+		f.add_item(item);
+		if (i % 3 == 0) {
+			f.erase_item(f.items().begin());
+		}
+	}
+	done = true;
+	reader.join();
+
+	REQUIRE(f.unread_item_count() == 666);
+}
+
+TEST_CASE("Query feed's unread_item_count() follows articles shared with "
+	"other feeds",
+	"[RssFeed]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	auto feed = std::make_shared<RssFeed>(&rsscache);
+	for (int i = 0; i < 3; ++i) {
+		const auto item = std::make_shared<RssItem>(&rsscache);
+		item->set_guid(std::to_string(i));
+		feed->add_item(item);
+	}
+
+	auto query_feed = std::make_shared<RssFeed>(&rsscache);
+	query_feed->set_rssurl("query:Everything:age >= 0");
+	query_feed->update_items({feed});
+	REQUIRE(query_feed->unread_item_count() == 3);
+
+	feed->items()[0]->set_unread_nowrite(false);
+	REQUIRE(feed->unread_item_count() == 2);
+	REQUIRE(query_feed->unread_item_count() == 2);
+
+	query_feed->get_item_by_guid("1")->set_unread_nowrite(false);
+	REQUIRE(feed->unread_item_count() == 1);
+	REQUIRE(query_feed->unread_item_count() == 1);
+}
+
+TEST_CASE("RssFeed::newest_item_pubdate() returns publication date of the "
+	"newest article",
+	"[RssFeed]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	RssFeed f(&rsscache);
+
+	REQUIRE(f.newest_item_pubdate() == 0);
+
+	const std::vector<time_t> dates = {42, 93, 7};
+	for (const auto date : dates) {
+		const auto item = std::make_shared<RssItem>(&rsscache);
+		item->set_guid(std::to_string(date));
+		item->set_pubDate(date);
+		f.add_item(item);
+	}
+	REQUIRE(f.newest_item_pubdate() == 93);
+
+	f.erase_item(f.items().begin() + 1);
+	REQUIRE(f.newest_item_pubdate() == 42);
+
+	f.clear_items();
+	REQUIRE(f.newest_item_pubdate() == 0);
+}
+
+TEST_CASE("RssFeed::newest_item_pubdate() follows changes to the publication "
+	"date of its articles",
+	"[RssFeed]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	RssFeed f(&rsscache);
+
+	const auto item = std::make_shared<RssItem>(&rsscache);
+	item->set_guid("guid");
+	item->set_pubDate(42);
+	f.add_item(item);
+	REQUIRE(f.newest_item_pubdate() == 42);
+
+	item->set_pubDate(93);
+	REQUIRE(f.newest_item_pubdate() == 93);
+}
+
+TEST_CASE("Articles stop notifying a feed once it is destroyed", "[RssFeed]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	const auto item = std::make_shared<RssItem>(&rsscache);
+	item->set_guid("guid");
+
+	{
+		RssFeed f(&rsscache);
+		f.add_item(item);
+		REQUIRE(f.unread_item_count() == 1);
+	}
+
+	// The feed is gone, so these mustn't touch it
+	item->set_unread_nowrite(false);
+	item->set_pubDate(93);
+
+	RssFeed other(&rsscache);
+	other.add_item(item);
+	REQUIRE(other.unread_item_count() == 0);
+	REQUIRE(other.newest_item_pubdate() == 93);
+}
+
 TEST_CASE("RssFeed::matches_tag() returns true if article has a specified tag",
 	"[RssFeed]")
 {
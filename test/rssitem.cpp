@@ -32,6 +32,30 @@ TEST_CASE("RssItem::sort_flags() cleans up flags", "[RssItem]")
 	}
 }
 
+TEST_CASE("RssItem's sort keys are updated when title or author change",
+	"[RssItem]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	RssItem item(&rsscache);
+
+	SECTION("title") {
+		item.set_title("First title");
+		REQUIRE(item.title_sort_key() == "First title");
+
+		item.set_title("Second title");
+		REQUIRE(item.title_sort_key() == "Second title");
+	}
+
+	SECTION("author") {
+		item.set_author("John Doe");
+		REQUIRE(item.author_sort_key() == "John Doe");
+
+		item.set_author("Jane Doe");
+		REQUIRE(item.author_sort_key() == "Jane Doe");
+	}
+}
+
 TEST_CASE("RssItem contains a number of matchable attributes", "[RssItem]")
 {
 	ConfigContainer cfg;
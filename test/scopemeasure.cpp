@@ -0,0 +1,126 @@
+#include "scopemeasure.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "3rd-party/catch.hpp"
+#include "test-helpers/tempfile.h"
+
+using namespace newsboat;
+
+TEST_CASE("ScopeMeasure::write_trace() writes nested scopes and their "
+	"counters in Chrome's Trace Event Format",
+	"[ScopeMeasure]")
+{
+	TestHelpers::TempFile tracefile;
+	{
+		// Started before the trace, so it's cut at the trace's start
+		ScopeMeasure early("early scope");
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		ScopeMeasure::start_tracing(tracefile.get_path());
+	}
+	REQUIRE(ScopeMeasure::is_tracing());
+
+	{
+		ScopeMeasure outer("outer \"scope\"");
+		outer.add_counter("bytes", 40);
+		outer.add_counter("bytes", 2);
+		{
+			ScopeMeasure inner("inner scope");
+			ScopeMeasure::add_to_current("items", 3);
+			inner.stopover("halfway");
+		}
+		// The inner scope is gone, so this goes to the outer one
+		ScopeMeasure::add_to_current("rows", 7);
+	}
+	// No scope is live, so this does nothing
+	ScopeMeasure::add_to_current("rows", 1);
+
+	ScopeMeasure::write_trace();
+
+	std::ifstream f(tracefile.get_path());
+	REQUIRE(f.is_open());
+	std::stringstream contents;
+	contents << f.rdbuf();
+	const std::string trace = contents.str();
+
+	REQUIRE(trace.find("{\"traceEvents\":[") == 0);
+	REQUIRE(trace.find("\"displayTimeUnit\":\"ns\"") != std::string::npos);
+
+	const auto inner = trace.find(
+			"{\"name\":\"inner scope\",\"cat\":\"newsboat\",\"ph\":\"X\"");
+	const auto outer = trace.find(
+			"{\"name\":\"outer \\\"scope\\\"\",\"cat\":\"newsboat\",\"ph\":\"X\"");
+	REQUIRE(inner != std::string::npos);
+	REQUIRE(outer != std::string::npos);
+	// Scopes are recorded when they end, so the inner one comes first
+	REQUIRE(inner < outer);
+
+	REQUIRE(trace.find("\"args\":{\"items\":3}", inner) < outer);
+	REQUIRE(trace.find("\"args\":{\"bytes\":42,\"rows\":7}", outer)
+		!= std::string::npos);
+
+	REQUIRE(trace.find("{\"name\":\"inner scope: halfway\",\"cat\":\"newsboat\","
+			"\"ph\":\"i\"") != std::string::npos);
+
+	const auto early = trace.find("{\"name\":\"early scope\"");
+	REQUIRE(early != std::string::npos);
+	const auto early_ts = trace.find("\"ts\":", early);
+	REQUIRE(trace.compare(early_ts, 11, "\"ts\":0.000,") == 0);
+	REQUIRE(trace.find("\"ts\":-") == std::string::npos);
+
+	// The temporary file is gone by the time the program exits
+	ScopeMeasure::stop_tracing();
+	REQUIRE_FALSE(ScopeMeasure::is_tracing());
+}
+
+TEST_CASE("ScopeMeasure::take_trace_events() returns the events of all "
+	"threads, including those that have exited",
+	"[ScopeMeasure]")
+{
+	ScopeMeasure::start_tracing("");
+	REQUIRE(ScopeMeasure::is_tracing());
+
+	{
+		ScopeMeasure main_scope("main thread scope");
+	}
+	std::thread t([]() {
+		ScopeMeasure worker_scope("worker thread scope");
+		ScopeMeasure::add_to_current("items", 5);
+	});
+	t.join();
+
+	auto events = ScopeMeasure::take_trace_events();
+	REQUIRE(events.size() == 2);
+
+	const auto find_event = [&events](const std::string& name) {
+		return std::find_if(events.begin(), events.end(),
+		[&name](const ScopeMeasure::TraceEvent& event) {
+			return event.name == name;
+		});
+	};
+	const auto main_event = find_event("main thread scope");
+	const auto worker_event = find_event("worker thread scope");
+	REQUIRE(main_event != events.end());
+	REQUIRE(worker_event != events.end());
+	REQUIRE(main_event->tid != worker_event->tid);
+	REQUIRE(worker_event->args.size() == 1);
+	REQUIRE(worker_event->args[0].first == "items");
+	REQUIRE(worker_event->args[0].second == 5);
+
+	// Taken events are forgotten
+	REQUIRE(ScopeMeasure::take_trace_events().empty());
+
+	{
+		ScopeMeasure discarded("discarded scope");
+	}
+	ScopeMeasure::stop_tracing();
+	REQUIRE_FALSE(ScopeMeasure::is_tracing());
+	{
+		ScopeMeasure untraced("untraced scope");
+	}
+	REQUIRE(ScopeMeasure::take_trace_events().empty());
+}
@@ -167,3 +167,83 @@ TEST_CASE("Tagsoup pull parser emits whitespace as is",
 	e = xpp.next();
 	REQUIRE(e == TagSoupPullParser::Event::END_DOCUMENT);
 }
+
+TEST_CASE("Tagsoup pull parser can parse a string without copying it into "
+	"a stream first",
+	"[TagSoupPullParser]")
+{
+	const std::string input = "<a href='https://example.com/'>link</a>tail";
+
+	TagSoupPullParser xpp;
+	TagSoupPullParser::Event e;
+	xpp.set_input(input);
+
+	e = xpp.next();
+	REQUIRE(e == TagSoupPullParser::Event::START_TAG);
+	REQUIRE(xpp.get_text() == "a");
+	REQUIRE(xpp.get_attribute_value("href") == "https://example.com/");
+
+	e = xpp.next();
+	REQUIRE(e == TagSoupPullParser::Event::TEXT);
+	REQUIRE(xpp.get_text() == "link");
+
+	e = xpp.next();
+	REQUIRE(e == TagSoupPullParser::Event::END_TAG);
+	REQUIRE(xpp.get_text() == "a");
+
+	e = xpp.next();
+	REQUIRE(e == TagSoupPullParser::Event::TEXT);
+	REQUIRE(xpp.get_text() == "tail");
+
+	e = xpp.next();
+	REQUIRE(e == TagSoupPullParser::Event::END_DOCUMENT);
+}
+
+TEST_CASE("Tagsoup pull parser decodes entities in text and attributes",
+	"[TagSoupPullParser]")
+{
+	TagSoupPullParser xpp;
+
+	SECTION("named and numeric entities") {
+		const std::string input =
+			"<p title='&lt;&amp;&gt;'>&lt;&#65;&#x42;&gt;</p>";
+		xpp.set_input(input);
+
+		REQUIRE(xpp.next() == TagSoupPullParser::Event::START_TAG);
+		REQUIRE(xpp.get_attribute_value("title") == "<&>");
+
+		REQUIRE(xpp.next() == TagSoupPullParser::Event::TEXT);
+		REQUIRE(xpp.get_text() == "<AB>");
+	}
+
+	SECTION("unknown entities are dropped") {
+		const std::string input = "a&nosuchentity;b";
+		xpp.set_input(input);
+
+		REQUIRE(xpp.next() == TagSoupPullParser::Event::TEXT);
+		REQUIRE(xpp.get_text() == "ab");
+	}
+
+	SECTION("ampersand without a semicolon is dropped") {
+		const std::string input = "fish & chips";
+		xpp.set_input(input);
+
+		REQUIRE(xpp.next() == TagSoupPullParser::Event::TEXT);
+		REQUIRE(xpp.get_text() == "fish  chips");
+	}
+}
+
+TEST_CASE("Tagsoup pull parser stops at an unterminated tag",
+	"[TagSoupPullParser]")
+{
+	const std::string input = "text<unterminated attr='value'";
+
+	TagSoupPullParser xpp;
+	xpp.set_input(input);
+
+	REQUIRE(xpp.next() == TagSoupPullParser::Event::TEXT);
+	REQUIRE(xpp.get_text() == "text");
+
+	REQUIRE(xpp.next() == TagSoupPullParser::Event::END_DOCUMENT);
+	REQUIRE(xpp.next() == TagSoupPullParser::Event::END_DOCUMENT);
+}
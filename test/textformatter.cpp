@@ -247,3 +247,35 @@ TEST_CASE(
 		REQUIRE(result.second == expected_count);
 	}
 }
+
+TEST_CASE("STFL tags don't count towards the width of wrapped lines",
+	"[TextFormatter]")
+{
+	TextFormatter fmt;
+	const size_t wrap_width = 10;
+
+	SECTION("tags inside the line") {
+		fmt.add_line(LineType::wrappable, "<b>bold</> words here");
+		const std::string expected_text =
+			"{list"
+			"{listitem text:\"<b>bold</> words\"}"
+			"{listitem text:\"here\"}"
+			"}";
+
+		const auto result = fmt.format_text_to_list(nullptr, "", wrap_width);
+		REQUIRE(result.first == expected_text);
+		REQUIRE(result.second == 2);
+	}
+
+	SECTION("text after an unterminated tag has zero width") {
+		fmt.add_line(LineType::wrappable, "a<b and then some more words");
+		const std::string expected_text =
+			"{list"
+			"{listitem text:\"a<b and then some more words\"}"
+			"}";
+
+		const auto result = fmt.format_text_to_list(nullptr, "", wrap_width);
+		REQUIRE(result.first == expected_text);
+		REQUIRE(result.second == 1);
+	}
+}
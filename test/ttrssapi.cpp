@@ -0,0 +1,93 @@
+#include "ttrssapi.h"
+
+#include <string>
+#include <vector>
+
+#include "3rd-party/catch.hpp"
+#include "3rd-party/json.hpp"
+
+using namespace newsboat;
+
+using json = nlohmann::json;
+
+TEST_CASE("TtRssApi::parse_reply() hands over each object of the content "
+	"array as it's parsed",
+	"[TtRssApi]")
+{
+	std::vector<json> handed_over;
+	const std::function<void(json&)> handle = [&](json& element) {
+		handed_over.push_back(element);
+	};
+
+	SECTION("Objects are handed over and removed from the reply") {
+		const auto reply = TtRssApi::parse_reply(
+				R"({"seq": 0, "status": 0, "content": [)"
+				R"({"id": 1, "title": "first"}, {"id": 2, "title": "second"}]})",
+				&handle);
+
+		REQUIRE(handed_over.size() == 2);
+		REQUIRE(handed_over[0]["id"] == 1);
+		REQUIRE(handed_over[1]["title"] == "second");
+		REQUIRE(reply["status"] == 0);
+		REQUIRE(reply["content"] == json::array());
+	}
+
+	SECTION("Arrays and objects nested inside an element stay in it") {
+		const auto reply = TtRssApi::parse_reply(
+				R"({"status": 0, "content": [{"id": 1, "labels": [[5, "a"], [6, "b"]],)"
+				R"( "attachments": [{"content_url": "x"}]}, {"id": 2, "labels": []}]})",
+				&handle);
+
+		REQUIRE(handed_over.size() == 2);
+		REQUIRE(handed_over[0]["labels"] == json::parse(R"([[5, "a"], [6, "b"]])"));
+		REQUIRE(handed_over[0]["attachments"][0]["content_url"] == "x");
+		REQUIRE(handed_over[1]["id"] == 2);
+		REQUIRE(reply["content"] == json::array());
+	}
+
+	SECTION("Elements of other arrays, and of a content that is an object, "
+		"aren't handed over") {
+		const auto reply = TtRssApi::parse_reply(
+				R"({"other": [{"id": 1}], "status": 1,)"
+				R"( "content": {"error": {"code": "NOT_LOGGED_IN"}}})",
+				&handle);
+
+		REQUIRE(handed_over.empty());
+		REQUIRE(reply["other"][0]["id"] == 1);
+		REQUIRE(reply["content"]["error"]["code"] == "NOT_LOGGED_IN");
+	}
+
+	SECTION("An empty content array hands over nothing") {
+		const auto reply = TtRssApi::parse_reply(
+				R"({"status": 0, "content": []})", &handle);
+
+		REQUIRE(handed_over.empty());
+		REQUIRE(reply["content"] == json::array());
+	}
+
+	SECTION("An empty reply is a parse error") {
+		REQUIRE_THROWS_AS(TtRssApi::parse_reply("", &handle),
+			json::parse_error);
+		REQUIRE(handed_over.empty());
+	}
+
+	SECTION("A truncated reply is a parse error, after the complete elements "
+		"were handed over") {
+		REQUIRE_THROWS_AS(TtRssApi::parse_reply(
+				R"({"status": 0, "content": [{"id": 1}, {"id": 2, "tit)",
+				&handle),
+			json::parse_error);
+		REQUIRE(handed_over.size() == 1);
+		REQUIRE(handed_over[0]["id"] == 1);
+	}
+}
+
+TEST_CASE("TtRssApi::parse_reply() without a handler keeps the whole reply",
+	"[TtRssApi]")
+{
+	const auto reply = TtRssApi::parse_reply(
+			R"({"status": 0, "content": [{"id": 1}, {"id": 2}]})", nullptr);
+
+	REQUIRE(reply["content"].size() == 2);
+	REQUIRE(reply["content"][1]["id"] == 2);
+}